@@ -140,9 +140,8 @@ int MainWindow::predict(const Matrix &imageMatrix) {
 
   
   
-  auto z1 = add_with_broadcast(*graph, mul(*graph, x, W1), b1);
-  auto a1 = sigmoid(*graph, z1);  
-  auto z2 = add_with_broadcast(*graph, mul(*graph, a1, W2), b2);
+  auto a1 = dense(*graph, x, W1, b1, Activation::Sigmoid);
+  auto z2 = dense(*graph, a1, W2, b2);
 
   
   return get_predicted_class(z2->value);
@@ -0,0 +1,62 @@
+#ifndef BFLOAT16_H
+#define BFLOAT16_H
+// bfloat16：float 的高 16 位（1 位符号、8 位指数、7 位尾数）。
+// 指数范围与 float 相同，不需要损失缩放；转换只是移位与舍入，
+// 可以在 GEMM 内层循环中即时展开为 float，用 fp32 累加。
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Matrix.h"
+
+struct bf16 {
+  uint16_t bits = 0;
+};
+
+// 就近舍入到偶数；NaN 保持为 quiet NaN。两种结果都算出再选择，
+// 没有分支，批量转换的循环可以向量化
+inline bf16 float_to_bf16(float f) {
+  uint32_t u;
+  std::memcpy(&u, &f, sizeof(u));
+  const uint32_t nan = (u >> 16) | 0x40u;
+  const uint32_t rounded = (u + 0x7fffu + ((u >> 16) & 1u)) >> 16;
+  return {static_cast<uint16_t>((u & 0x7fffffffu) > 0x7f800000u ? nan : rounded)};
+}
+
+inline float bf16_to_float(bf16 h) {
+  const uint32_t u = static_cast<uint32_t>(h.bits) << 16;
+  float f;
+  std::memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+// 把 float 舍入到 bf16 可表示的最近值（仍以 float 存储）
+inline float round_to_bf16(float f) { return bf16_to_float(float_to_bf16(f)); }
+
+// 行主序的 bf16 矩阵，用作 GEMM 操作数与反向保存的激活
+struct BF16Matrix {
+  int rows = 0;
+  int cols = 0;
+  std::vector<bf16> data;
+
+  BF16Matrix() = default;
+  BF16Matrix(int r, int c) { resize(r, c); }
+  explicit BF16Matrix(const Matrix& m) { assign(m); }
+
+  // 改变形状，容量足够时复用已有缓冲区（内容不保证清零）
+  void resize(int r, int c) {
+    rows = r;
+    cols = c;
+    data.resize(static_cast<size_t>(rows) * cols);
+  }
+
+  // 转换 m 覆盖当前内容，容量足够时复用已有缓冲区
+  void assign(const Matrix& m) {
+    resize(m.get_rows(), m.get_cols());
+    const float* src = m.get_data_ptr();
+    for (size_t i = 0; i < data.size(); ++i) data[i] = float_to_bf16(src[i]);
+  }
+};
+
+#endif  // !BFLOAT16_H
@@ -0,0 +1,187 @@
+#include "Checkpoint.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "Profiler.h"
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4B434E4E;  // "NNCK"
+constexpr uint32_t kVersion = 1;
+
+class Writer {
+ public:
+  explicit Writer(std::FILE* f) : f_(f) {}
+  template <typename T>
+  void put(const T& v) {
+    bytes(&v, sizeof(T));
+  }
+  template <typename T>
+  void put_vector(const std::vector<T>& v) {
+    put<uint64_t>(v.size());
+    bytes(v.data(), v.size() * sizeof(T));
+  }
+  void bytes(const void* p, size_t n) {
+    if (n > 0 && std::fwrite(p, 1, n, f_) != n) ok_ = false;
+  }
+  [[nodiscard]] bool ok() const { return ok_; }
+
+ private:
+  std::FILE* f_;
+  bool ok_ = true;
+};
+
+class Reader {
+ public:
+  Reader(std::FILE* f, const std::string& path) : f_(f), path_(path) {}
+  template <typename T>
+  T get() {
+    T v{};
+    bytes(&v, sizeof(T));
+    return v;
+  }
+  template <typename T>
+  std::vector<T> get_vector() {
+    const auto n = get<uint64_t>();
+    // 长度字段损坏时不要先分配巨大的内存
+    if (n > (uint64_t{1} << 34) / sizeof(T)) fail();
+    std::vector<T> v(n);
+    bytes(v.data(), n * sizeof(T));
+    return v;
+  }
+  void bytes(void* p, size_t n) {
+    if (n > 0 && std::fread(p, 1, n, f_) != n) fail();
+  }
+  [[noreturn]] void fail() const {
+    throw std::runtime_error("检查点文件损坏或不完整: " + path_);
+  }
+
+ private:
+  std::FILE* f_;
+  const std::string& path_;
+};
+
+}  // namespace
+
+void write_checkpoint(const std::string& path, const TrainingState& state) {
+  ProfileScope scope("checkpoint.write");
+  const std::string tmp = path + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::runtime_error("无法写入文件: " + tmp);
+  }
+  Writer w(f);
+  w.put(kMagic);
+  w.put(kVersion);
+  w.put(state.epoch);
+  w.put(state.step);
+  w.put(state.epoch_loss);
+  w.put(state.optimizer_steps);
+  w.put<uint64_t>(state.rng.size());
+  w.bytes(state.rng.data(), state.rng.size());
+  w.put_vector(state.order);
+  w.put_vector(state.params);
+  w.put_vector(state.optimizer_state);
+  // 数据落盘后再 rename，断电时也不会留下指向半个文件的 path
+  const bool ok = w.ok() && std::fflush(f) == 0 && fsync(fileno(f)) == 0;
+  if (std::fclose(f) != 0 || !ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("写入检查点失败: " + path);
+  }
+}
+
+TrainingState read_checkpoint(const std::string& path) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    throw std::runtime_error("无法加载文件: " + path);
+  }
+  TrainingState state;
+  try {
+    Reader r(f, path);
+    if (r.get<uint32_t>() != kMagic || r.get<uint32_t>() != kVersion) {
+      throw std::runtime_error("文件格式不正确或版本不匹配: " + path);
+    }
+    state.epoch = r.get<int32_t>();
+    state.step = r.get<int32_t>();
+    state.epoch_loss = r.get<double>();
+    state.optimizer_steps = r.get<int64_t>();
+    const std::vector<char> rng = r.get_vector<char>();
+    state.rng.assign(rng.begin(), rng.end());
+    state.order = r.get_vector<int>();
+    state.params = r.get_vector<float>();
+    state.optimizer_state = r.get_vector<float>();
+    if (std::fgetc(f) != EOF || state.epoch < 0 || state.step < 0) r.fail();
+  } catch (...) {
+    std::fclose(f);
+    throw;
+  }
+  std::fclose(f);
+  return state;
+}
+
+CheckpointWriter::CheckpointWriter(std::string path)
+    : path_(std::move(path)), thread_([this] { run(); }) {}
+
+CheckpointWriter::~CheckpointWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void CheckpointWriter::rethrow_locked() {
+  if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+}
+
+void CheckpointWriter::submit(TrainingState state) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rethrow_locked();
+    pending_ = std::move(state);
+  }
+  cv_.notify_all();
+}
+
+void CheckpointWriter::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return !pending_ && !busy_; });
+  rethrow_locked();
+}
+
+int CheckpointWriter::written() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return written_;
+}
+
+void CheckpointWriter::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || pending_; });
+    if (!pending_) return;  // stop_ 且没有待写的检查点
+    TrainingState state = std::move(*pending_);
+    pending_.reset();
+    busy_ = true;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      write_checkpoint(path_, state);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    busy_ = false;
+    if (error) {
+      error_ = error;
+    } else {
+      written_++;
+    }
+    cv_.notify_all();
+  }
+}
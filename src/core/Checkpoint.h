@@ -0,0 +1,70 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+// 训练检查点：参数、优化器状态、随机数状态以及训练进度（轮、轮内步、
+// 本轮已累计的损失、本轮的样本顺序），足以让中断的训练逐位一致地继续。
+//
+// CheckpointWriter 在后台线程中写文件：训练线程只做一次内存拷贝（快照），
+// 写入先落到 path.tmp，fsync 后 rename 覆盖 path，任何时刻 path 要么是
+// 完整的旧检查点，要么是完整的新检查点。
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TrainingState {
+  int32_t epoch = 0;  // 正在进行的轮
+  int32_t step = 0;   // 本轮中下一个要执行的批次
+  double epoch_loss = 0.0;  // 本轮已完成批次的损失之和
+  int64_t optimizer_steps = 0;
+  std::string rng;          // std::mt19937 的文本状态
+  std::vector<int> order;   // 本轮的样本顺序
+  std::vector<float> params;           // ParameterStore 的平坦值缓冲区
+  std::vector<float> optimizer_state;  // Optimizer::state()
+};
+
+// 同步写入，经临时文件与 rename 原子地替换 path；失败抛出 std::runtime_error
+void write_checkpoint(const std::string& path, const TrainingState& state);
+// 读取并校验格式；失败抛出 std::runtime_error
+TrainingState read_checkpoint(const std::string& path);
+
+class CheckpointWriter {
+ public:
+  explicit CheckpointWriter(std::string path);
+  // 写完仍在排队的检查点后退出
+  ~CheckpointWriter();
+
+  CheckpointWriter(const CheckpointWriter&) = delete;
+  CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+  // 交给后台线程写入后立即返回。上一份还没开始写时直接被替换，
+  // 因此磁盘慢时只会跳过中间的检查点，不会阻塞训练或无限排队。
+  // 之前的写入若失败，在这里重新抛出。
+  void submit(TrainingState state);
+  // 等待已提交的检查点全部写完；写入失败时重新抛出
+  void flush();
+
+  [[nodiscard]] const std::string& path() const { return path_; }
+  // 已成功写入的检查点个数
+  [[nodiscard]] int written() const;
+
+ private:
+  void run();
+  void rethrow_locked();
+
+  std::string path_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::optional<TrainingState> pending_;
+  bool busy_ = false;
+  bool stop_ = false;
+  int written_ = 0;
+  std::exception_ptr error_;
+  std::thread thread_;  // 最后初始化，其余成员就绪后才启动
+};
+
+#endif  // !CHECKPOINT_H
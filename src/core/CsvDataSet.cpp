@@ -4,67 +4,226 @@
 #include <Node.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <exception>
 #include <fstream>  // 用于文件输入流 std::ifstream
 #include <ios>
 #include <iostream>
 #include <memory>
-#include <sstream>    // 用于字符串流 std::stringstream
+#include <numeric>
+#include <optional>
 #include <stdexcept>  // 用于抛出异常 std::runtime_error
 #include <string>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "DatasetCache.h"
+#include "MappedFile.h"
 #include "Matrix.h"
+#include "Profiler.h"
 
-// --- 公共构造函数 ---
-// 它的职责很简单：调用私有的加载函数来完成所有工作。
-CsvDataSet::CsvDataSet(const std::string& filepath, bool normalize)
-    : CsvDataSet(load_from_file(filepath, normalize))  // 使用委托构造函数
-{}
+namespace {
 
-CsvDataSet::CsvDataSet(std::pair<Matrix, Matrix> p)
-    : features_(p.first), labels_(p.second) {}
-std::pair<Matrix, Matrix> CsvDataSet::load_from_file(const std::string& path,
-                                                     bool normalize) {
-  std::ifstream file(path);
-  if (!file.is_open()) {
-    throw std::runtime_error("csv文件无法加载， path = " + path + "\n");
-  }
-  std::vector<std::vector<float>> features_vec;
-  std::vector<std::vector<float>> labels_vec;
+constexpr int kNumFeatures = 784;
+// 每个线程至少分到这么多字节，小文件不值得开线程
+constexpr size_t kMinChunkBytes = size_t{4} << 20;
 
-  std::string line;
-  while (std::getline(file, line)) {
-    if (line.empty()) continue;
+// 一行的内容（不含换行符与行尾的 '\r'）以及下一行的开头
+struct Line {
+  const char* begin;
+  const char* end;
+  const char* next;
+};
 
-    std::vector<float> feature_row;
-    std::vector<float> label_row(1);
-    std::stringstream ss(line);
+Line next_line(const char* p, const char* end) {
+  const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  const char* line_end = nl != nullptr ? nl : end;
+  Line line{p, line_end, nl != nullptr ? nl + 1 : end};
+  if (line.end > line.begin && line.end[-1] == '\r') --line.end;
+  return line;
+}
 
-    std::string value;
-    if (std::getline(ss, value, ',')) {
-      label_row[0] = std::stof(value);
+int count_rows(const char* p, const char* end) {
+  int rows = 0;
+  while (p < end) {
+    const Line line = next_line(p, end);
+    if (line.end > line.begin) ++rows;
+    p = line.next;
+  }
+  return rows;
+}
+
+// 解析一个数值，返回其后的位置；失败时返回 nullptr
+const char* parse_value(const char* p, const char* end, float& out) {
+  // 快速路径：MNIST 的标签与像素都是不超过 9 位的非负整数
+  uint32_t v = 0;
+  const char* q = p;
+  while (q < end && q - p < 9 && static_cast<unsigned>(*q - '0') < 10) {
+    v = v * 10 + static_cast<uint32_t>(*q - '0');
+    ++q;
+  }
+  if (q > p && (q == end || *q == ',')) {
+    out = static_cast<float>(v);
+    return q;
+  }
+  const auto [ptr, ec] = std::from_chars(p, end, out);
+  return ec == std::errc() ? ptr : nullptr;
+}
 
-    } else {
-      continue;
+// 把 [p, end) 中的非空行依次写进从 row 开始的各行
+void parse_rows(const char* p, const char* end, int row, bool normalize,
+                float* features, float* labels) {
+  while (p < end) {
+    const Line line = next_line(p, end);
+    p = line.next;
+    if (line.end == line.begin) continue;
+    float* out = features + static_cast<size_t>(row) * kNumFeatures;
+    const char* q = parse_value(line.begin, line.end, labels[row]);
+    int col = 0;
+    while (q != nullptr && q < line.end && *q == ',' && col < kNumFeatures) {
+      q = parse_value(q + 1, line.end, out[col]);
+      if (normalize) out[col] /= 255.0f;
+      ++col;
     }
-    while (std::getline(ss, value, ',')) {
-      if (normalize) {
-        feature_row.push_back(std::stof(value) / 255.0f);
-      } else {
-        feature_row.push_back(std::stof(value));
-      }
+    if (q == nullptr) {
+      throw std::runtime_error("csv 中，第" + std::to_string(row) +
+                               "行含有无法解析的数值\n");
     }
-    if (feature_row.size() != 784) {
-      throw std::runtime_error("csv 中，第" +
-                               std::to_string(features_vec.size()) +
+    if (q != line.end || col != kNumFeatures) {
+      throw std::runtime_error("csv 中，第" + std::to_string(row) +
                                "行数量不等于784\n");
     }
-    features_vec.push_back(feature_row);
-    labels_vec.push_back(label_row);
+    ++row;
+  }
+}
+
+// 在 n 个线程上执行 fn(i)（0 号在调用线程上），之后重新抛出编号最小的异常
+template <typename F>
+void run_parallel(int n, F&& fn) {
+  std::vector<std::exception_ptr> errors(n);
+  std::vector<std::thread> threads;
+  for (int i = 1; i < n; ++i) {
+    threads.emplace_back([&, i] {
+      try {
+        fn(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  try {
+    fn(0);
+  } catch (...) {
+    errors[0] = std::current_exception();
   }
-  return {Matrix(features_vec), Matrix(labels_vec)};
+  for (auto& t : threads) t.join();
+  for (auto& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+}  // namespace
+
+// --- 公共构造函数 ---
+CsvDataSet::CsvDataSet(const std::string& filepath, bool normalize,
+                       bool use_cache)
+    : features_(0, kNumFeatures), labels_(0, 1) {
+  // key 在解析之前取，解析期间 CSV 被改写时缓存会在下次被判为过期
+  std::optional<DatasetCacheKey> key;
+  if (use_cache) {
+    try {
+      key = dataset_cache_key(filepath);
+    } catch (const std::runtime_error&) {
+      // CSV 不存在，交给下面的解析报告
+    }
+  }
+  const std::string cache_path = dataset_cache_path(filepath);
+  if (key) {
+    const auto start = std::chrono::steady_clock::now();
+    if (auto cached = load_dataset_cache(cache_path, *key, normalize)) {
+      std::tie(features_, labels_) = std::move(*cached);
+      load_stats_.bytes = static_cast<size_t>(features_.get_rows()) *
+                          (features_.get_cols() + 1) * sizeof(float);
+      load_stats_.seconds = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+      load_stats_.from_cache = true;
+      return;
+    }
+  }
+  std::tie(features_, labels_) = load_from_file(filepath, normalize);
+  if (key) {
+    try {
+      write_dataset_cache(cache_path, *key, normalize, features_, labels_);
+    } catch (const std::runtime_error&) {
+      // 缓存只用于加速，写不了（如只读目录）时照常使用解析结果
+    }
+  }
+}
+
+CsvDataSet::CsvDataSet(std::pair<Matrix, Matrix> p)
+    : features_(std::move(p.first)), labels_(std::move(p.second)) {}
+std::pair<Matrix, Matrix> CsvDataSet::load_from_file(const std::string& path,
+                                                     bool normalize, int threads) {
+  const auto start = std::chrono::steady_clock::now();
+  ProfileScope scope("csv.load");
+  std::unique_ptr<MappedFile> file;
+  try {
+    file = std::make_unique<MappedFile>(path);
+  } catch (const std::runtime_error&) {
+    throw std::runtime_error("csv文件无法加载， path = " + path + "\n");
+  }
+  file->will_need();
+  const char* data = file->data();
+  const char* end = data + file->size();
+
+  // 按字节均分，每个边界向后挪到下一行的开头
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  const int num_chunks =
+      threads > 0 ? threads
+                  : static_cast<int>(
+                        std::clamp<size_t>(file->size() / kMinChunkBytes, 1, hw));
+  std::vector<const char*> bounds(num_chunks + 1, end);
+  bounds[0] = data;
+  for (int i = 1; i < num_chunks; ++i) {
+    const char* p = std::max(bounds[i - 1], data + file->size() * i / num_chunks);
+    const char* nl =
+        p < end ? static_cast<const char*>(std::memchr(p, '\n', end - p)) : nullptr;
+    bounds[i] = nl != nullptr ? nl + 1 : end;
+  }
+
+  // 先数出各块的行数得到每块的起始行，再并行解析进最终的矩阵
+  std::vector<int> first_row(num_chunks + 1, 0);
+  run_parallel(num_chunks, [&](int i) {
+    first_row[i + 1] = count_rows(bounds[i], bounds[i + 1]);
+  });
+  std::partial_sum(first_row.begin(), first_row.end(), first_row.begin());
+  const int rows = first_row.back();
+  Matrix features = Matrix::uninitialized(rows, kNumFeatures);
+  Matrix labels = Matrix::uninitialized(rows, 1);
+  float* feature_ptr = features.get_data_ptr();
+  float* label_ptr = labels.get_data_ptr();
+  run_parallel(num_chunks, [&](int i) {
+    parse_rows(bounds[i], bounds[i + 1], first_row[i], normalize, feature_ptr,
+               label_ptr);
+  });
+
+  ProfileScope::add_counts(0.0, static_cast<double>(file->size()),
+                           static_cast<double>(rows) * (kNumFeatures + 1) *
+                               sizeof(float));
+  load_stats_.from_cache = false;
+  load_stats_.bytes = file->size();
+  load_stats_.threads = num_chunks;
+  load_stats_.seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  return {std::move(features), std::move(labels)};
 }
 
 int CsvDataSet::size() const { return features_.get_rows(); }
@@ -8,22 +8,43 @@
 #include "DataSet.h"
 #include "Matrix.h"
 #include "Node.h"
+
+// 一次 CSV 加载的统计，用于报告吞吐
+struct CsvLoadStats {
+  size_t bytes = 0;
+  double seconds = 0.0;
+  int threads = 0;
+  bool from_cache = false;  // 直接映射了二进制缓存，没有解析 CSV
+  [[nodiscard]] double mb_per_second() const {
+    return seconds > 0.0 ? static_cast<double>(bytes) / 1e6 / seconds : 0.0;
+  }
+};
+
 class CsvDataSet : public Dataset {
  private:
   Matrix features_;
   Matrix labels_;
+  CsvLoadStats load_stats_;
 
  public:
   int size() const;
 
   CsvDataSet(std::pair<Matrix, Matrix> p);
+  // 每行 "label,p0,...,p783"。文件被映射进内存，按行对齐切成若干块并行解析，
+  // 直接写进预先分配好的矩阵；normalize 时像素除以 255。
+  // threads 为 0 时按文件大小与 CPU 核数决定
   std::pair<Matrix, Matrix> load_from_file(const std::string& path,
-                                           bool normalize);
+                                           bool normalize, int threads = 0);
   void load_from_csv(const std::string& filepath, bool normalize);
-  CsvDataSet(const std::string& filepath, bool normalize = true);
+  // use_cache 时先找 filepath + ".cache"（见 DatasetCache.h）：与 CSV 的大小和
+  // 修改时间一致就直接映射，否则解析 CSV 并重新生成缓存
+  CsvDataSet(const std::string& filepath, bool normalize = true,
+             bool use_cache = true);
   std::pair<Matrix, Matrix> get_item(int index) const;
   const Matrix& get_features() const;
   const Matrix& get_labels() const;
+  // 最近一次 load_from_file 的字节数、耗时与线程数
+  const CsvLoadStats& load_stats() const { return load_stats_; }
 };
 
 void load_parameters(
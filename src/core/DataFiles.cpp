@@ -0,0 +1,79 @@
+#include "DataFiles.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "CsvDataSet.h"
+#include "IdxDataSet.h"
+
+namespace {
+
+std::vector<int> to_labels(const Matrix& labels) {
+  std::vector<int> out(labels.get_rows());
+  for (int i = 0; i < labels.get_rows(); ++i) {
+    out[i] = static_cast<int>(labels(i, 0));
+  }
+  return out;
+}
+
+}  // namespace
+
+LoadedData load_data(const std::string& path, const char* what, bool verbose) {
+  LoadedData data;
+  const std::string labels_path = IdxDataSet::labels_path_for(path);
+  if (!labels_path.empty()) {
+    const auto start = std::chrono::steady_clock::now();
+    auto idx = std::make_shared<const IdxDataSet>(path, labels_path);
+    data.X = Features(idx);
+    data.y = idx->get_labels();
+    if (verbose) {
+      const double seconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+      std::cout << what << " loaded: " << idx->size() << " samples ("
+                << static_cast<double>(idx->size()) * idx->num_features() / 1e6
+                << " MB of IDX pixels mapped in " << seconds * 1e3
+                << " ms, decoded per batch)." << std::endl;
+    }
+    return data;
+  }
+  const CsvDataSet csv(path);
+  // 与数据集共享存储，映射的缓存也不会被拷贝
+  data.X = Features(csv.get_features());
+  data.y = to_labels(csv.get_labels());
+  if (verbose) {
+    const CsvLoadStats& s = csv.load_stats();
+    std::cout << what << " loaded: " << csv.size() << " samples ("
+              << s.bytes / 1e6 << " MB in " << s.seconds * 1e3 << " ms, "
+              << s.mb_per_second() << " MB/s, ";
+    if (s.from_cache) {
+      std::cout << "mapped from cache";
+    } else {
+      std::cout << s.threads << " thread(s)";
+    }
+    std::cout << ")." << std::endl;
+  }
+  return data;
+}
+
+std::pair<LoadedData, LoadedData> split_holdout(const LoadedData& data,
+                                                double fraction) {
+  const int n = data.X.rows();
+  const int held = static_cast<int>(std::lround(fraction * n));
+  if (!(fraction > 0.0 && fraction < 1.0) || held < 1 || held >= n) {
+    throw std::invalid_argument("split_holdout: cannot hold out " +
+                                std::to_string(fraction) + " of " +
+                                std::to_string(n) + " samples.");
+  }
+  const int kept = n - held;
+  LoadedData fit;
+  LoadedData val;
+  fit.X = data.X.slice(0, kept);
+  val.X = data.X.slice(kept, n);
+  fit.y.assign(data.y.begin(), data.y.begin() + kept);
+  val.y.assign(data.y.begin() + kept, data.y.end());
+  return {std::move(fit), std::move(val)};
+}
@@ -0,0 +1,29 @@
+#ifndef DATAFILES_H
+#define DATAFILES_H
+// 按文件格式加载整份数据集的特征与类别下标，train 与 sweep 共用。
+// path 为 IDX 图像文件（如 train-images-idx3-ubyte，标签文件按 MNIST 的
+// 命名规律推出）时使用 IdxDataSet，像素保持映射，训练与评估按批次解码；
+// 否则按 CSV 读取（带二进制缓存）成特征矩阵。
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Features.h"
+
+struct LoadedData {
+  Features X;
+  // 直接使用类别下标作为标签，不再构建 60000x10 的 one-hot 矩阵
+  std::vector<int> y;
+};
+
+// 加载 path；verbose 时以 "<what> loaded: ..." 打印样本数与加载耗时
+LoadedData load_data(const std::string& path, const char* what, bool verbose);
+
+// 把最后 fraction 比例的样本留作验证集，返回 {训练部分, 验证部分}。
+// 两部分的特征都与 data.X 共享存储，不拷贝；fraction 须在 (0, 1) 内，
+// 且两部分都至少有一个样本，否则抛出 std::invalid_argument
+std::pair<LoadedData, LoadedData> split_holdout(const LoadedData& data,
+                                                double fraction);
+
+#endif  // !DATAFILES_H
@@ -0,0 +1,152 @@
+#include "DataParallelTrainer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Profiler.h"
+
+namespace {
+
+// 归约分段按 16 个 float（64 字节）对齐，相邻 worker 不会写同一缓存行
+constexpr size_t kAlignFloats = 16;
+
+}  // namespace
+
+DataParallelTrainer::DataParallelTrainer(ParameterStore& store,
+                                         Optimizer& optimizer, int num_workers,
+                                         LossFn loss_fn)
+    : store_(store),
+      optimizer_(optimizer),
+      loss_fn_(std::move(loss_fn)),
+      barrier_(std::max(num_workers, 1)) {
+  if (num_workers < 1) {
+    throw std::invalid_argument(
+        "DataParallelTrainer: num_workers must be positive, got " +
+        std::to_string(num_workers) + ".");
+  }
+  if (!loss_fn_) {
+    throw std::invalid_argument("DataParallelTrainer: empty loss function.");
+  }
+  if (optimizer_.store() != &store_) {
+    throw std::invalid_argument(
+        "DataParallelTrainer: optimizer must update the store's parameters.");
+  }
+  for (int rank = 0; rank < num_workers; ++rank) {
+    auto r = std::make_unique<Replica>();
+    if (rank == 0) {
+      r->params = store_.params();
+    } else {
+      r->grads = std::make_shared<Storage>(store_.size());
+      r->params = store_.make_replica(r->graph, r->grads);
+    }
+    replicas_.push_back(std::move(r));
+  }
+  for (int rank = 1; rank < num_workers; ++rank) {
+    threads_.emplace_back([this, rank]() { worker_loop(rank); });
+  }
+}
+
+DataParallelTrainer::~DataParallelTrainer() {
+  stop_ = true;
+  barrier_.arrive_and_wait();
+  for (auto& t : threads_) t.join();
+}
+
+float* DataParallelTrainer::grads_of(int rank) {
+  return rank == 0 ? store_.grads().data() : replicas_[rank]->grads->data();
+}
+
+void DataParallelTrainer::worker_loop(int rank) {
+  while (true) {
+    barrier_.arrive_and_wait();  // 开始
+    if (stop_) return;
+    compute(rank);
+    barrier_.arrive_and_wait();  // 梯度就绪
+    reduce(rank);
+    barrier_.arrive_and_wait();  // 归约完成
+  }
+}
+
+void DataParallelTrainer::compute(int rank) {
+  Replica& r = *replicas_[rank];
+  std::memset(grads_of(rank), 0, store_.size() * sizeof(float));
+  r.loss = 0.0f;
+  if (r.shard.empty()) return;
+  try {
+    ProfileScope scope("data_parallel.compute");
+    // 激活只活在本步的图里，参数节点属于副本的持久图
+    Graph graph;
+    auto loss = loss_fn_(graph, r.params, r.shard);
+    if (!loss || loss->value.get_rows() != 1 || loss->value.get_cols() != 1) {
+      throw std::runtime_error(
+          "DataParallelTrainer: loss function must return a 1x1 node.");
+    }
+    loss->backward();
+    r.loss = loss->value(0, 0);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (!error_) error_ = std::current_exception();
+  }
+}
+
+void DataParallelTrainer::reduce(int rank) {
+  const int n = num_workers();
+  if (n == 1) return;  // 唯一的副本就是共享梯度本身，权重为 1
+  const size_t size = store_.size();
+  size_t per = (size + n - 1) / n;
+  per = (per + kAlignFloats - 1) / kAlignFloats * kAlignFloats;
+  const size_t begin = std::min(size, per * rank);
+  const size_t end = std::min(size, begin + per);
+  if (begin == end) return;
+
+  ProfileScope scope("data_parallel.reduce");
+  ProfileScope::add_counts(2.0 * n * (end - begin), 4.0 * n * (end - begin),
+                           4.0 * (end - begin));
+  // 共享梯度同时是 0 号副本的梯度：先按它的权重缩放，再依次累加其他副本
+  float* __restrict dst = grads_of(0) + begin;
+  const float s0 = replicas_[0]->scale;
+  for (size_t k = 0; k < end - begin; ++k) dst[k] *= s0;
+  for (int w = 1; w < n; ++w) {
+    const float s = replicas_[w]->scale;
+    if (s == 0.0f) continue;
+    const float* __restrict src = grads_of(w) + begin;
+    for (size_t k = 0; k < end - begin; ++k) dst[k] += s * src[k];
+  }
+}
+
+float DataParallelTrainer::step(std::span<const int> batch) {
+  ProfileScope scope("data_parallel.step");
+  const int n = num_workers();
+  // 样本尽量均分，前 extra 个分片多一个样本
+  const size_t base = batch.size() / n;
+  const size_t extra = batch.size() % n;
+  size_t pos = 0;
+  for (int rank = 0; rank < n; ++rank) {
+    const size_t len = base + (static_cast<size_t>(rank) < extra ? 1 : 0);
+    replicas_[rank]->shard = batch.subspan(pos, len);
+    replicas_[rank]->scale =
+        batch.empty() ? 0.0f
+                      : static_cast<float>(len) / static_cast<float>(batch.size());
+    pos += len;
+  }
+  error_ = nullptr;
+
+  barrier_.arrive_and_wait();  // 开始
+  compute(0);
+  barrier_.arrive_and_wait();  // 梯度就绪
+  reduce(0);
+  barrier_.arrive_and_wait();  // 归约完成
+
+  if (error_) std::rethrow_exception(error_);
+  if (gradient_hook_) gradient_hook_(store_.grads());
+  optimizer_.step();
+  // 混合精度时 bf16 权重副本随主权重更新，下一步的所有 worker 共用
+  store_.refresh_bf16();
+
+  float loss = 0.0f;
+  for (const auto& r : replicas_) loss += r->scale * r->loss;
+  return loss;
+}
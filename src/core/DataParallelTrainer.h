@@ -0,0 +1,88 @@
+#ifndef DATAPARALLELTRAINER_H
+#define DATAPARALLELTRAINER_H
+// 同步数据并行训练：一个全局批次按样本均分给 N 个 worker，每个 worker
+// 在自己的图副本上前向/反向，梯度写进私有的平坦缓冲区；随后各 worker
+// 各负责平坦梯度的一段，把所有副本的这一段按样本数加权求和写进共享梯度
+// （共享内存中的 reduce-scatter，无锁、求和顺序固定），最后做一次优化器更新。
+//
+// 副本的 value 是 ParameterStore 值缓冲区上的视图，前向/反向期间只读，
+// 更新发生在所有 worker 都停在栅栏上之后，因此不需要拷贝权重。
+// 调用 step() 的线程本身就是 0 号 worker，它直接使用 store 的节点与梯度。
+
+#include <barrier>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Graph.h"
+#include "Node.h"
+#include "Optimizer.h"
+#include "ParameterStore.h"
+
+class DataParallelTrainer {
+ public:
+  // 在 graph 上为 indices 指定的样本构建前向，返回这些样本的平均损失（1x1）。
+  // params 与 store.params() 一一对应。不同 worker 会并发调用，
+  // 实现只能读取共享数据。
+  using LossFn = std::function<std::shared_ptr<Node>(
+      Graph& graph, const std::vector<std::shared_ptr<Node>>& params,
+      std::span<const int> indices)>;
+
+  // optimizer 必须基于同一个 store 构造，以便一次更新整块平坦缓冲区
+  DataParallelTrainer(ParameterStore& store, Optimizer& optimizer,
+                      int num_workers, LossFn loss_fn);
+  ~DataParallelTrainer();
+
+  DataParallelTrainer(const DataParallelTrainer&) = delete;
+  DataParallelTrainer& operator=(const DataParallelTrainer&) = delete;
+
+  // 一次同步的数据并行 SGD 步，返回整个批次的平均损失。
+  // batch 可以为空（梯度为 0），多进程训练中分不到样本的进程仍需参与归约。
+  float step(std::span<const int> batch);
+
+  // 线程间归约完成、优化器更新之前，由调用线程对共享平坦梯度执行 hook，
+  // 例如跨进程 all-reduce
+  void set_gradient_hook(std::function<void(std::span<float>)> hook) {
+    gradient_hook_ = std::move(hook);
+  }
+
+  [[nodiscard]] int num_workers() const {
+    return static_cast<int>(replicas_.size());
+  }
+
+ private:
+  struct Replica {
+    Graph graph;  // 持有副本的参数节点
+    std::vector<std::shared_ptr<Node>> params;
+    std::shared_ptr<Storage> grads;  // 0 号 worker 为空，直接写共享梯度
+    std::span<const int> shard;
+    float loss = 0.0f;
+    float scale = 0.0f;  // 本分片样本数 / 批次样本数
+  };
+
+  void worker_loop(int rank);
+  // 清零本副本梯度，在新的图上前向与反向
+  void compute(int rank);
+  // 把所有副本梯度的第 rank 段加权求和写进共享梯度
+  void reduce(int rank);
+  float* grads_of(int rank);
+
+  ParameterStore& store_;
+  Optimizer& optimizer_;
+  LossFn loss_fn_;
+  std::function<void(std::span<float>)> gradient_hook_;
+  std::vector<std::unique_ptr<Replica>> replicas_;
+  std::vector<std::thread> threads_;
+  // 每步三个阶段：开始 / 梯度就绪 / 归约完成，参与者为全部 worker
+  std::barrier<> barrier_;
+  bool stop_ = false;
+  std::exception_ptr error_;
+  std::mutex error_mutex_;
+};
+
+#endif  // !DATAPARALLELTRAINER_H
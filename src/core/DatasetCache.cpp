@@ -0,0 +1,143 @@
+#include "DatasetCache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "MappedFile.h"
+#include "Profiler.h"
+
+namespace {
+
+constexpr uint32_t kMagic = 0x53444E4E;  // "NNDS"
+constexpr uint32_t kVersion = 1;
+// 块的对齐与 Storage 相同，映射的起始地址按页对齐，块内的数据因此也是对齐的
+constexpr uint64_t kAlignment = 64;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t rows;
+  uint32_t cols;
+  uint32_t normalize;
+  uint32_t reserved;
+  uint64_t source_size;
+  int64_t source_mtime_ns;
+  uint64_t features_offset;
+  uint64_t labels_offset;
+};
+static_assert(sizeof(Header) <= kAlignment);
+
+uint64_t align_up(uint64_t n) { return (n + kAlignment - 1) / kAlignment * kAlignment; }
+
+// 映射中 [offset, offset + rows*cols) 的零拷贝矩阵，持有 file 直到最后一个视图释放
+Matrix mapped_matrix(const std::shared_ptr<MappedFile>& file, uint64_t offset,
+                     int rows, int cols) {
+  float* data = reinterpret_cast<float*>(file->writable_data() + offset);
+  auto storage = std::make_shared<Storage>(data, static_cast<size_t>(rows) * cols,
+                                           [file] {});
+  return Matrix::from_tensor(
+      Tensor(std::move(storage), {rows, cols}, {static_cast<long>(cols), 1}, 0));
+}
+
+}  // namespace
+
+DatasetCacheKey dataset_cache_key(const std::string& source_path) {
+  struct stat st {};
+  if (stat(source_path.c_str(), &st) != 0) {
+    throw std::runtime_error("无法读取文件信息: " + source_path);
+  }
+  DatasetCacheKey key;
+  key.size = static_cast<uint64_t>(st.st_size);
+  key.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                 st.st_mtim.tv_nsec;
+  return key;
+}
+
+std::string dataset_cache_path(const std::string& source_path) {
+  return source_path + ".cache";
+}
+
+std::optional<std::pair<Matrix, Matrix>> load_dataset_cache(
+    const std::string& cache_path, const DatasetCacheKey& key, bool normalize) {
+  ProfileScope scope("dataset_cache.load");
+  std::shared_ptr<MappedFile> file;
+  try {
+    file = std::make_shared<MappedFile>(cache_path, /*copy_on_write=*/true);
+  } catch (const std::runtime_error&) {
+    return std::nullopt;
+  }
+  if (file->size() < sizeof(Header)) return std::nullopt;
+  Header h;
+  std::memcpy(&h, file->data(), sizeof(Header));
+  const uint64_t feature_bytes = uint64_t{h.rows} * h.cols * sizeof(float);
+  const uint64_t label_bytes = uint64_t{h.rows} * sizeof(float);
+  if (h.magic != kMagic || h.version != kVersion ||
+      h.normalize != static_cast<uint32_t>(normalize) ||
+      h.source_size != key.size || h.source_mtime_ns != key.mtime_ns ||
+      h.features_offset % kAlignment != 0 || h.labels_offset % kAlignment != 0 ||
+      h.features_offset < sizeof(Header) ||
+      h.labels_offset < h.features_offset + feature_bytes ||
+      file->size() != h.labels_offset + label_bytes) {
+    return std::nullopt;
+  }
+  const int rows = static_cast<int>(h.rows);
+  const int cols = static_cast<int>(h.cols);
+  return std::pair<Matrix, Matrix>(mapped_matrix(file, h.features_offset, rows, cols),
+                                   mapped_matrix(file, h.labels_offset, rows, 1));
+}
+
+void write_dataset_cache(const std::string& cache_path, const DatasetCacheKey& key,
+                         bool normalize, const Matrix& features,
+                         const Matrix& labels) {
+  ProfileScope scope("dataset_cache.write");
+  if (labels.get_rows() != features.get_rows() || labels.get_cols() != 1) {
+    throw std::invalid_argument("write_dataset_cache: labels must be rows x 1.");
+  }
+  Header h{};
+  h.magic = kMagic;
+  h.version = kVersion;
+  h.rows = static_cast<uint32_t>(features.get_rows());
+  h.cols = static_cast<uint32_t>(features.get_cols());
+  h.normalize = normalize ? 1 : 0;
+  h.source_size = key.size;
+  h.source_mtime_ns = key.mtime_ns;
+  h.features_offset = align_up(sizeof(Header));
+  const uint64_t feature_bytes = uint64_t{h.rows} * h.cols * sizeof(float);
+  h.labels_offset = align_up(h.features_offset + feature_bytes);
+
+  // 每个写者一个唯一的临时文件：--nproc 下多个进程可能同时写同一个缓存，
+  // 共用一个临时文件名会互相截断，rename 出半个文件。
+  // mkstemp 以 0600 创建，改为普通数据文件的 0644，其他用户也能复用缓存
+  std::string tmp = cache_path + ".XXXXXX";
+  const int fd = mkstemp(tmp.data());
+  if (fd < 0) {
+    throw std::runtime_error("无法写入文件: " + cache_path);
+  }
+  std::FILE* f = fchmod(fd, 0644) == 0 ? fdopen(fd, "wb") : nullptr;
+  if (f == nullptr) {
+    close(fd);
+    std::remove(tmp.c_str());
+    throw std::runtime_error("无法写入文件: " + tmp);
+  }
+  const std::vector<char> padding(kAlignment, 0);
+  auto put = [&](const void* p, size_t n) {
+    return n == 0 || std::fwrite(p, 1, n, f) == n;
+  };
+  bool ok = put(&h, sizeof(Header)) &&
+            put(padding.data(), h.features_offset - sizeof(Header)) &&
+            put(features.get_data_ptr(), feature_bytes) &&
+            put(padding.data(), h.labels_offset - h.features_offset - feature_bytes) &&
+            put(labels.get_data_ptr(), uint64_t{h.rows} * sizeof(float));
+  ok = ok && std::fflush(f) == 0 && fsync(fileno(f)) == 0;
+  if (std::fclose(f) != 0 || !ok || std::rename(tmp.c_str(), cache_path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("写入数据集缓存失败: " + cache_path);
+  }
+}
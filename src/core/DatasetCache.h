@@ -0,0 +1,41 @@
+#ifndef DATASETCACHE_H
+#define DATASETCACHE_H
+// 数据集的二进制缓存：把解析好的特征与标签按 float 原样写进一个文件，
+// 以后直接 mmap，Matrix 通过外部 Storage 指向映射的页，不解析也不拷贝。
+//
+// 文件布局（小端）：64 字节的文件头，之后是 64 字节对齐的特征块
+// （rows x cols，行主序）与标签块（rows x 1）。文件头记录源文件的大小与
+// 修改时间（纳秒）以及是否归一化，任一不符即视为过期，重新从源文件解析。
+// 映射是私有的写时复制映射，修改矩阵不会写回缓存文件。
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "Matrix.h"
+
+// 源文件的身份：大小与修改时间
+struct DatasetCacheKey {
+  uint64_t size = 0;
+  int64_t mtime_ns = 0;
+};
+
+// 源文件的当前 key，文件不存在时抛出 std::runtime_error
+DatasetCacheKey dataset_cache_key(const std::string& source_path);
+
+// source_path 对应的缓存文件路径
+std::string dataset_cache_path(const std::string& source_path);
+
+// 读取与 key、normalize 匹配的缓存；不存在、过期或不完整时返回 std::nullopt
+std::optional<std::pair<Matrix, Matrix>> load_dataset_cache(
+    const std::string& cache_path, const DatasetCacheKey& key, bool normalize);
+
+// 写入缓存：先写唯一命名的临时文件，完成后 rename 覆盖，读者不会看到半个
+// 文件；多个写者并发时以最后一次 rename 为准，每一个都是完整的。
+// 写入失败时抛出 std::runtime_error
+void write_dataset_cache(const std::string& cache_path, const DatasetCacheKey& key,
+                         bool normalize, const Matrix& features,
+                         const Matrix& labels);
+
+#endif  // !DATASETCACHE_H
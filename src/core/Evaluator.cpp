@@ -0,0 +1,191 @@
+#include "Evaluator.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Profiler.h"
+
+namespace {
+
+double percent(int64_t part, int64_t whole) {
+  return whole > 0 ? 100.0 * static_cast<double>(part) / whole : 0.0;
+}
+
+// m 的前 rows 行组成的视图
+Matrix leading_rows(const Matrix& m, int rows) {
+  return Matrix::from_tensor(m.slice(0, 0, rows));
+}
+
+}  // namespace
+
+int64_t EvalResult::total() const {
+  int64_t n = 0;
+  for (int64_t c : confusion) n += c;
+  return n;
+}
+
+int64_t EvalResult::correct() const {
+  int64_t n = 0;
+  for (int c = 0; c < num_classes; ++c) n += count(c, c);
+  return n;
+}
+
+double EvalResult::accuracy() const { return percent(correct(), total()); }
+
+double EvalResult::precision(int c) const {
+  int64_t predicted = 0;
+  for (int a = 0; a < num_classes; ++a) predicted += count(a, c);
+  return percent(count(c, c), predicted);
+}
+
+double EvalResult::recall(int c) const {
+  int64_t actual = 0;
+  for (int p = 0; p < num_classes; ++p) actual += count(c, p);
+  return percent(count(c, c), actual);
+}
+
+double EvalResult::f1(int c) const {
+  const double p = precision(c);
+  const double r = recall(c);
+  return p + r > 0.0 ? 2.0 * p * r / (p + r) : 0.0;
+}
+
+double EvalResult::macro_f1() const {
+  if (num_classes == 0) return 0.0;
+  double sum = 0.0;
+  for (int c = 0; c < num_classes; ++c) sum += f1(c);
+  return sum / num_classes;
+}
+
+void EvalResult::print_report(std::ostream& out) const {
+  const auto flags = out.flags();
+  const auto prec = out.precision();
+  out << std::fixed << std::setprecision(2);
+  out << "class  precision  recall      f1  support\n";
+  for (int c = 0; c < num_classes; ++c) {
+    int64_t support = 0;
+    for (int p = 0; p < num_classes; ++p) support += count(c, p);
+    out << std::setw(5) << c << std::setw(11) << precision(c) << std::setw(8)
+        << recall(c) << std::setw(8) << f1(c) << std::setw(9) << support << "\n";
+  }
+  out << "accuracy " << accuracy() << "%, macro F1 " << macro_f1() << "\n";
+  out << "confusion matrix (rows: actual, columns: predicted)\n";
+  for (int a = 0; a < num_classes; ++a) {
+    for (int p = 0; p < num_classes; ++p) out << std::setw(6) << count(a, p);
+    out << "\n";
+  }
+  out.flags(flags);
+  out.precision(prec);
+}
+
+Evaluator::Evaluator(Activation hidden, Precision precision, int batch_size)
+    : hidden_(hidden), precision_(precision), batch_size_(batch_size) {
+  if (batch_size < 1) {
+    throw std::invalid_argument("Evaluator: batch_size must be positive, got " +
+                                std::to_string(batch_size) + ".");
+  }
+}
+
+EvalResult Evaluator::run(Activation hidden, Precision precision, int batch_size,
+                          const std::vector<const Matrix*>& weights,
+                          const Features& X, std::span<const int> y, Workspace& ws) {
+  ProfileScope scope("evaluate");
+  if (weights.size() < 2 || weights.size() % 2 != 0) {
+    throw std::invalid_argument("Evaluator: expected W1, b1, W2, b2, ... parameters.");
+  }
+  if (X.rows() != static_cast<int>(y.size())) {
+    throw std::invalid_argument("Evaluator: feature and label counts differ.");
+  }
+  if (X.cols() != weights[0]->get_rows()) {
+    throw std::invalid_argument(
+        "Evaluator: data has " + std::to_string(X.cols()) +
+        " features but the model expects " +
+        std::to_string(weights[0]->get_rows()) + ".");
+  }
+  const size_t num_layers = weights.size() / 2;
+  EvalResult result;
+  result.num_classes = weights[2 * num_layers - 2]->get_cols();
+  const int C = result.num_classes;
+  result.confusion.assign(static_cast<size_t>(C) * C, 0);
+
+  // 缓冲区只在第一次或形状变化时分配
+  ws.activations.resize(num_layers, Matrix(0, 0));
+  for (size_t l = 0; l < num_layers; ++l) {
+    const int width = weights[2 * l]->get_cols();
+    if (ws.activations[l].get_rows() != batch_size ||
+        ws.activations[l].get_cols() != width) {
+      ws.activations[l] = Matrix(batch_size, width);
+    }
+  }
+  if (precision == Precision::BF16) {
+    ws.weights16.resize(num_layers);
+    ws.activations16.resize(num_layers);
+    for (size_t l = 0; l < num_layers; ++l) ws.weights16[l].assign(*weights[2 * l]);
+  }
+  ws.predictions.resize(batch_size);
+
+  const int n = X.rows();
+  for (int start = 0; start < n; start += batch_size) {
+    const int m = std::min(batch_size, n - start);
+    // 数据矩阵上的行视图，或解码进 ws.input 的批次
+    Matrix input = X.read_rows(start, start + m, ws.input);
+    if (precision == Precision::BF16) ws.input16.assign(input);
+    for (size_t l = 0; l < num_layers; ++l) {
+      const bool output = l + 1 == num_layers;
+      const Activation act = output ? Activation::None : hidden;
+      Matrix out = leading_rows(ws.activations[l], m);
+      if (precision == Precision::BF16) {
+        // 隐藏层的激活直接以 bf16 写出交给下一层，只有 logits 写成 fp32
+        const BF16Matrix& in16 = l == 0 ? ws.input16 : ws.activations16[l - 1];
+        if (output) {
+          dense_forward_kernel(in16, ws.weights16[l], weights[2 * l + 1], act, out);
+        } else {
+          ws.activations16[l].resize(m, out.get_cols());
+          dense_forward_kernel(in16, ws.weights16[l], weights[2 * l + 1], act,
+                               ws.activations16[l]);
+        }
+      } else {
+        dense_forward_kernel(input, *weights[2 * l], weights[2 * l + 1], act, out);
+      }
+      input = std::move(out);
+    }
+    argmax_rows_kernel(input, ws.predictions);
+    for (int i = 0; i < m; ++i) {
+      const int label = y[start + i];
+      if (label < 0 || label >= C) {
+        throw std::invalid_argument("Evaluator: label " + std::to_string(label) +
+                                    " out of range for " + std::to_string(C) +
+                                    " classes.");
+      }
+      result.confusion[static_cast<size_t>(label) * C + ws.predictions[i]]++;
+    }
+  }
+  return result;
+}
+
+EvalResult Evaluator::evaluate(const std::vector<std::shared_ptr<Node>>& params,
+                               const Features& X, std::span<const int> y) {
+  std::vector<const Matrix*> weights;
+  for (const auto& p : params) weights.push_back(&p->value);
+  return run(hidden_, precision_, batch_size_, weights, X, y, workspace_);
+}
+
+std::future<EvalResult> Evaluator::evaluate_async(
+    const std::vector<std::shared_ptr<Node>>& params, const Features& X,
+    std::span<const int> y) const {
+  // 快照在调用线程上完成，之后参数可以被训练随意修改
+  auto snapshot = std::make_shared<std::vector<Matrix>>();
+  snapshot->reserve(params.size());
+  for (const auto& p : params) snapshot->push_back(p->value);
+  return std::async(std::launch::async,
+                    [hidden = hidden_, precision = precision_,
+                     batch_size = batch_size_, snapshot, X, y] {
+                      std::vector<const Matrix*> weights;
+                      for (const Matrix& m : *snapshot) weights.push_back(&m);
+                      Workspace ws;
+                      return run(hidden, precision, batch_size, weights, X, y, ws);
+                    });
+}
@@ -0,0 +1,86 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+// 批量流式评估：把数据按固定大小的批次依次送过网络，直接调用融合 dense
+// 计算核写进复用的激活缓冲区，不经过计算图，因此不创建节点、不分配梯度、
+// 不保留反向闭包（相当于 no-grad 模式）。数据是矩阵时每批的输入是其上的
+// 行视图，不拷贝；IDX 数据逐批解码进复用的缓冲区；预测用按列扫描的 argmax 计算核，再累加进混淆矩阵。
+//
+// evaluate_async() 先拷贝一份参数快照，再在后台线程评估，训练可以在此期间
+// 继续修改参数。
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include "../ops/ops.h"
+#include "Features.h"
+#include "Matrix.h"
+#include "Node.h"
+
+// 分类评估结果：混淆矩阵及由它导出的指标
+struct EvalResult {
+  int num_classes = 0;
+  // confusion[actual * num_classes + predicted]
+  std::vector<int64_t> confusion;
+
+  [[nodiscard]] int64_t count(int actual, int predicted) const {
+    return confusion[static_cast<size_t>(actual) * num_classes + predicted];
+  }
+  [[nodiscard]] int64_t total() const;
+  [[nodiscard]] int64_t correct() const;
+  // 以下均为百分比；分母为 0 时返回 0
+  [[nodiscard]] double accuracy() const;
+  [[nodiscard]] double precision(int c) const;
+  [[nodiscard]] double recall(int c) const;
+  [[nodiscard]] double f1(int c) const;
+  [[nodiscard]] double macro_f1() const;
+  // 每类 precision / recall / F1 / 样本数，以及混淆矩阵
+  void print_report(std::ostream& out) const;
+};
+
+class Evaluator {
+ public:
+  // 网络结构与 Trainer 相同：params 依次为 W1, b1, W2, b2, ...，
+  // 隐藏层使用 hidden 激活，输出层为 logits
+  explicit Evaluator(Activation hidden, Precision precision = Precision::FP32,
+                     int batch_size = 256);
+
+  // 在调用线程上用 params 的当前值评估。复用内部缓冲区，
+  // 同一个 Evaluator 不能在多个线程上同时调用
+  EvalResult evaluate(const std::vector<std::shared_ptr<Node>>& params,
+                      const Features& X, std::span<const int> y);
+
+  // 拷贝 params 的当前值后在后台线程评估并立即返回。X 按值持有（共享存储）；
+  // X 的数据与 y 必须在 future 就绪前保持有效且不被修改
+  std::future<EvalResult> evaluate_async(
+      const std::vector<std::shared_ptr<Node>>& params, const Features& X,
+      std::span<const int> y) const;
+
+  [[nodiscard]] int batch_size() const { return batch_size_; }
+
+ private:
+  // 一次评估用到的缓冲区，在批次之间复用
+  struct Workspace {
+    std::vector<Matrix> activations;  // 每层输出，batch_size 行
+    Matrix input{0, 0};               // 数据不是矩阵时解码出的输入批次
+    // bf16 时的输入批次、隐藏层激活与权重副本
+    BF16Matrix input16;
+    std::vector<BF16Matrix> activations16;
+    std::vector<BF16Matrix> weights16;
+    std::vector<int> predictions;
+  };
+
+  static EvalResult run(Activation hidden, Precision precision, int batch_size,
+                        const std::vector<const Matrix*>& weights,
+                        const Features& X, std::span<const int> y, Workspace& ws);
+
+  Activation hidden_;
+  Precision precision_;
+  int batch_size_;
+  Workspace workspace_;
+};
+
+#endif  // !EVALUATOR_H
@@ -0,0 +1,99 @@
+#include "Features.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "IdxDataSet.h"
+
+Features::Features() = default;
+
+Features::Features(const Matrix& X)
+    : X_(Matrix::from_tensor(X)), rows_(X.get_rows()), cols_(X.get_cols()) {}
+
+Features::Features(std::shared_ptr<const IdxDataSet> dataset)
+    : idx_(std::move(dataset)) {
+  if (!idx_) {
+    throw std::invalid_argument("Features: dataset must not be null.");
+  }
+  rows_ = idx_->size();
+  cols_ = idx_->num_features();
+}
+
+Features::Features(const Features& other)
+    : X_(Matrix::from_tensor(other.X_)),
+      idx_(other.idx_),
+      offset_(other.offset_),
+      rows_(other.rows_),
+      cols_(other.cols_) {}
+
+Features& Features::operator=(const Features& other) {
+  if (this != &other) *this = Features(other);
+  return *this;
+}
+
+void Features::check_range(int begin, int end) const {
+  if (begin < 0 || end > rows_ || begin > end) {
+    throw std::out_of_range("Features: invalid row range [" +
+                            std::to_string(begin) + ", " + std::to_string(end) +
+                            ") for " + std::to_string(rows_) + " rows.");
+  }
+}
+
+void Features::gather(std::span<const int> indices, float* out) const {
+  const size_t n = static_cast<size_t>(cols_);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const int r = indices[i];
+    check_range(r, r + 1);
+    if (idx_) {
+      idx_->decode_row(offset_ + r, out + i * n);
+    } else {
+      std::memcpy(out + i * n, X_.get_data_ptr() + static_cast<size_t>(r) * n,
+                  sizeof(float) * n);
+    }
+  }
+}
+
+void Features::gather(std::span<const int> indices, bf16* out) const {
+  const size_t n = static_cast<size_t>(cols_);
+  // IDX 的一行先解码到这里再舍入
+  thread_local std::vector<float> row;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const int r = indices[i];
+    check_range(r, r + 1);
+    const float* src;
+    if (idx_) {
+      row.resize(n);
+      idx_->decode_row(offset_ + r, row.data());
+      src = row.data();
+    } else {
+      src = X_.get_data_ptr() + static_cast<size_t>(r) * n;
+    }
+    bf16* dst = out + i * n;
+    for (size_t j = 0; j < n; ++j) dst[j] = float_to_bf16(src[j]);
+  }
+}
+
+Matrix Features::read_rows(int begin, int end, Matrix& scratch) const {
+  check_range(begin, end);
+  if (!idx_) return Matrix::from_tensor(X_.slice(0, begin, end));
+  if (scratch.get_cols() != cols_ || scratch.get_rows() < end - begin) {
+    scratch = Matrix::uninitialized(end - begin, cols_);
+  }
+  idx_->decode(offset_ + begin, offset_ + end, scratch);
+  return Matrix::from_tensor(scratch.slice(0, 0, end - begin));
+}
+
+Features Features::slice(int begin, int end) const {
+  check_range(begin, end);
+  Features out = *this;
+  if (idx_) {
+    out.offset_ = offset_ + begin;
+  } else {
+    out.X_ = Matrix::from_tensor(X_.slice(0, begin, end));
+  }
+  out.rows_ = end - begin;
+  return out;
+}
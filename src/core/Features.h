@@ -0,0 +1,55 @@
+#ifndef FEATURES_H
+#define FEATURES_H
+// 训练与评估读取的特征数据：N 行样本、每行 cols 个 float 特征。
+// 底层可以是内存中的矩阵（如 CSV 或其映射的缓存），也可以是 IdxDataSet：
+// 后者的像素保持 uint8 映射，只在组装批次时按需转换，不展开成 N x 784 的
+// float 矩阵。Features 是轻量的值类型，拷贝只共享底层存储。
+
+#include <memory>
+#include <span>
+
+#include "BFloat16.h"
+#include "Matrix.h"
+
+class IdxDataSet;
+
+class Features {
+ public:
+  Features();
+  // 矩阵上的零拷贝视图；隐式转换让接受 Matrix 的调用点保持不变
+  Features(const Matrix& X);  // NOLINT(google-explicit-constructor)
+  explicit Features(std::shared_ptr<const IdxDataSet> dataset);
+  // Matrix 的拷贝会复制数据，这里改为共享
+  Features(const Features& other);
+  Features& operator=(const Features& other);
+  Features(Features&&) noexcept = default;
+  Features& operator=(Features&&) noexcept = default;
+
+  [[nodiscard]] int rows() const { return rows_; }
+  [[nodiscard]] int cols() const { return cols_; }
+  // 底层为矩阵时返回它（行视图），否则为 nullptr
+  [[nodiscard]] const Matrix* matrix() const { return idx_ ? nullptr : &X_; }
+
+  // 把第 indices[i] 行写到 out 的第 i 行（out 至少 indices.size() * cols 个元素）；
+  // bf16 版本先得到 float 再舍入，与先收集成 float 再转换逐位一致
+  void gather(std::span<const int> indices, float* out) const;
+  void gather(std::span<const int> indices, bf16* out) const;
+
+  // 行 [begin, end) 的 float 矩阵：底层为矩阵时是不拷贝的行视图，
+  // 否则解码进 scratch 的前 end - begin 行（列数不符或行数不足时重新分配）
+  Matrix read_rows(int begin, int end, Matrix& scratch) const;
+
+  // 行 [begin, end) 上的 Features，共享底层存储
+  [[nodiscard]] Features slice(int begin, int end) const;
+
+ private:
+  void check_range(int begin, int end) const;
+
+  Matrix X_{0, 0};
+  std::shared_ptr<const IdxDataSet> idx_;
+  int offset_ = 0;  // IDX 时本视图第 0 行在数据集中的下标
+  int rows_ = 0;
+  int cols_ = 0;
+};
+
+#endif  // !FEATURES_H
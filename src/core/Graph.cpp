@@ -1,16 +1,53 @@
 #include "Graph.h"
+
+#include <stdexcept>
+
+#include "Profiler.h"
 // Graph.cpp
 std::shared_ptr<Node> Graph::make_node(Matrix value, const std::string& name) {
   // 调用Node构造函数，让parents使用默认的空vector
   auto node = std::shared_ptr<Node>(new Node(std::move(value), {}, name));
+  Profiler::instance().record_node(name);
   nodes_.push_back(node);
   return node;
 }
 
 std::shared_ptr<Node> Graph::make_node(
     Matrix value, const std::vector<std::weak_ptr<Node>>& parents,
-    const std::string& name) {
+    const std::string& name, bool bf16_inputs) {
+  for (const auto& p : parents) {
+    if (auto parent = p.lock()) {
+      if (parent->overwritten_) {
+        throw std::invalid_argument("Graph::make_node: input '" +
+                                    parent->name +
+                                    "' was overwritten by an in-place op.");
+      }
+      if (!bf16_inputs && parent->bf16_only()) {
+        throw std::invalid_argument("Graph::make_node: '" + name +
+                                    "' cannot read the bf16-only output of '" +
+                                    parent->name + "'.");
+      }
+    }
+  }
+  for (const auto& p : parents) {
+    if (auto parent = p.lock()) parent->consumers_++;
+  }
   auto node = std::shared_ptr<Node>(new Node(std::move(value), parents, name));
+  Profiler::instance().record_node(name);
   nodes_.push_back(node);
   return node;
 }
+
+std::shared_ptr<Node> Graph::make_node(
+    std::shared_ptr<BF16Matrix> value16,
+    const std::vector<std::weak_ptr<Node>>& parents, const std::string& name,
+    bool bf16_inputs) {
+  if (!value16) {
+    throw std::invalid_argument("Graph::make_node: null bf16 value for '" + name +
+                                "'.");
+  }
+  auto node = make_node(Matrix(0, 0), parents, name, bf16_inputs);
+  node->grad = Matrix::zeros(value16->rows, value16->cols);
+  node->value16 = std::move(value16);
+  return node;
+}
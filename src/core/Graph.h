@@ -12,9 +12,16 @@ class Graph {
   Graph() = default;
 
   std::shared_ptr<Node> make_node(Matrix value, const std::string& name);
+  // 父节点是 bf16_only() 时抛出 std::invalid_argument：读 value 的算子会
+  // 拿到空矩阵。只有直接读取 value16 的算子（bf16 dense）把 bf16_inputs 置为 true
   std::shared_ptr<Node> make_node(
       Matrix value, const std::vector<std::weak_ptr<Node>>& parents,
-      const std::string& name);
+      const std::string& name, bool bf16_inputs = false);
+  // 只有 bf16 值的节点（见 Node::value16）
+  std::shared_ptr<Node> make_node(
+      std::shared_ptr<BF16Matrix> value16,
+      const std::vector<std::weak_ptr<Node>>& parents, const std::string& name,
+      bool bf16_inputs = false);
 };
 
 #endif  // !GRAPH_H
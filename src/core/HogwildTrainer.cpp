@@ -0,0 +1,113 @@
+#include "HogwildTrainer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "Profiler.h"
+
+HogwildTrainer::HogwildTrainer(ParameterStore& store, int num_workers,
+                               float learning_rate, LossFn loss_fn)
+    : store_(store), lr_(learning_rate), loss_fn_(std::move(loss_fn)) {
+  if (num_workers < 1) {
+    throw std::invalid_argument(
+        "HogwildTrainer: num_workers must be positive, got " +
+        std::to_string(num_workers) + ".");
+  }
+  if (!(learning_rate > 0.0f)) {
+    throw std::invalid_argument("HogwildTrainer: invalid learning rate.");
+  }
+  if (!loss_fn_) {
+    throw std::invalid_argument("HogwildTrainer: empty loss function.");
+  }
+  for (int rank = 0; rank < num_workers; ++rank) {
+    auto r = std::make_unique<Replica>();
+    if (rank == 0) {
+      r->params = store_.params();
+    } else {
+      r->grads = std::make_shared<Storage>(store_.size());
+      r->params = store_.make_replica(r->graph, r->grads);
+    }
+    replicas_.push_back(std::move(r));
+  }
+}
+
+void HogwildTrainer::apply_update(const float* grads) {
+  float* values = store_.values().data();
+  const size_t n = store_.size();
+  const float lr = lr_;
+  ProfileScope::add_counts(2.0 * n, 8.0 * n, 4.0 * n);
+  for (size_t k = 0; k < n; ++k) {
+    const float g = grads[k];
+    if (g == 0.0f) continue;
+    std::atomic_ref<float> w(values[k]);
+    w.store(w.load(std::memory_order_relaxed) - lr * g,
+            std::memory_order_relaxed);
+  }
+}
+
+float HogwildTrainer::run_epoch(std::span<const int> order, int batch_size) {
+  if (batch_size < 1) {
+    throw std::invalid_argument("HogwildTrainer::run_epoch: invalid batch size.");
+  }
+  ProfileScope scope("hogwild.epoch");
+  const size_t num_batches = (order.size() + batch_size - 1) / batch_size;
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto work = [&](int rank) {
+    Replica& r = *replicas_[rank];
+    r.loss_sum = 0.0;
+    r.batches = 0;
+    float* grads = rank == 0 ? store_.grads().data() : r.grads->data();
+    try {
+      // 每个 worker 独立领取批次，领完即结束，中间不与其他 worker 同步
+      for (size_t b = next.fetch_add(1, std::memory_order_relaxed);
+           b < num_batches; b = next.fetch_add(1, std::memory_order_relaxed)) {
+        ProfileScope step_scope("hogwild.step");
+        const size_t begin = b * batch_size;
+        const size_t len = std::min<size_t>(batch_size, order.size() - begin);
+        std::memset(grads, 0, store_.size() * sizeof(float));
+        Graph graph;
+        auto loss = loss_fn_(graph, r.params, order.subspan(begin, len));
+        if (!loss || loss->value.get_rows() != 1 ||
+            loss->value.get_cols() != 1) {
+          throw std::runtime_error(
+              "HogwildTrainer: loss function must return a 1x1 node.");
+        }
+        loss->backward();
+        apply_update(grads);
+        r.loss_sum += loss->value(0, 0);
+        r.batches++;
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) error = std::current_exception();
+      // 让其他 worker 尽快停下
+      next.store(num_batches, std::memory_order_relaxed);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int rank = 1; rank < num_workers(); ++rank) {
+    threads.emplace_back(work, rank);
+  }
+  work(0);
+  for (auto& t : threads) t.join();
+  if (error) std::rethrow_exception(error);
+
+  double loss_sum = 0.0;
+  int batches = 0;
+  for (const auto& r : replicas_) {
+    loss_sum += r->loss_sum;
+    batches += r->batches;
+  }
+  return batches > 0 ? static_cast<float>(loss_sum / batches) : 0.0f;
+}
@@ -0,0 +1,55 @@
+#ifndef HOGWILDTRAINER_H
+#define HOGWILDTRAINER_H
+// Hogwild! 式无锁异步 SGD：K 个线程各自从共享的批次序列中领取下一个
+// mini-batch（一个原子计数器），在自己的图副本上算出梯度后直接更新共享参数，
+// 步与步之间没有栅栏，也不做梯度归约。
+//
+// 参数更新对每个元素是 relaxed 的原子读、原子写（std::atomic_ref），
+// 并发的更新可能互相覆盖——这正是 Hogwild 接受的"良性竞争"，梯度稀疏时
+// （如 MNIST 中大量为 0 的像素对应的 W1 行）冲突很少，只更新非零梯度。
+// 前向/反向的计算核以普通读取参数，可能读到更新到一半的模型，同样属于
+// 算法允许的不一致。只支持无动量的 SGD：共享的动量状态会让竞争不再良性。
+
+#include <span>
+#include <vector>
+
+#include "DataParallelTrainer.h"
+#include "ParameterStore.h"
+
+class HogwildTrainer {
+ public:
+  using LossFn = DataParallelTrainer::LossFn;
+
+  HogwildTrainer(ParameterStore& store, int num_workers, float learning_rate,
+                 LossFn loss_fn);
+
+  HogwildTrainer(const HogwildTrainer&) = delete;
+  HogwildTrainer& operator=(const HogwildTrainer&) = delete;
+
+  // 把 order 按 batch_size 切成批次，由所有 worker 异步地取完并各自更新；
+  // 返回各批次损失的平均值。调用线程是 0 号 worker。
+  float run_epoch(std::span<const int> order, int batch_size);
+
+  [[nodiscard]] int num_workers() const {
+    return static_cast<int>(replicas_.size());
+  }
+
+ private:
+  struct Replica {
+    Graph graph;  // 持有副本的参数节点
+    std::vector<std::shared_ptr<Node>> params;
+    std::shared_ptr<Storage> grads;  // 0 号 worker 为空，使用 store 的梯度
+    double loss_sum = 0.0;
+    int batches = 0;
+  };
+
+  // 用 worker 自己的梯度原地更新共享参数
+  void apply_update(const float* grads);
+
+  ParameterStore& store_;
+  float lr_;
+  LossFn loss_fn_;
+  std::vector<std::unique_ptr<Replica>> replicas_;
+};
+
+#endif  // !HOGWILDTRAINER_H
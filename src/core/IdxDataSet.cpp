@@ -0,0 +1,132 @@
+#include "IdxDataSet.h"
+
+#include <stdexcept>
+
+#include "Profiler.h"
+
+namespace {
+
+constexpr uint8_t kUnsignedByte = 0x08;
+
+uint32_t read_be32(const uint8_t* p) {
+  return (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) |
+         uint32_t{p[3]};
+}
+
+// 检查文件头并返回各维大小与数据的起始位置
+std::vector<uint32_t> read_header(const MappedFile& file, uint8_t expected_dims,
+                                  const std::string& path, const uint8_t*& data) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(file.data());
+  const size_t header = 4 + 4 * size_t{expected_dims};
+  if (file.size() < header || bytes[0] != 0 || bytes[1] != 0 ||
+      bytes[2] != kUnsignedByte || bytes[3] != expected_dims) {
+    throw std::runtime_error("不是 " + std::to_string(expected_dims) +
+                             " 维 uint8 的 IDX 文件: " + path);
+  }
+  std::vector<uint32_t> dims(expected_dims);
+  uint64_t count = 1;
+  for (uint8_t d = 0; d < expected_dims; ++d) {
+    dims[d] = read_be32(bytes + 4 + 4 * d);
+    count *= dims[d];
+  }
+  if (file.size() != header + count) {
+    throw std::runtime_error("IDX 文件大小与文件头不符: " + path);
+  }
+  data = bytes + header;
+  return dims;
+}
+
+// 一段像素转换成 float
+void convert(const uint8_t* src, float* dst, size_t n, bool normalize) {
+  if (normalize) {
+    for (size_t i = 0; i < n; ++i) dst[i] = static_cast<float>(src[i]) / 255.0f;
+  } else {
+    for (size_t i = 0; i < n; ++i) dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+}  // namespace
+
+IdxDataSet::IdxDataSet(const std::string& images_path,
+                       const std::string& labels_path, bool normalize)
+    : images_(std::make_shared<MappedFile>(images_path)),
+      labels_(std::make_shared<MappedFile>(labels_path)),
+      normalize_(normalize) {
+  ProfileScope scope("idx.load");
+  const auto image_dims = read_header(*images_, 3, images_path, pixels_);
+  const auto label_dims = read_header(*labels_, 1, labels_path, label_data_);
+  if (image_dims[0] != label_dims[0]) {
+    throw std::runtime_error("IDX 图像与标签数量不一致: " +
+                             std::to_string(image_dims[0]) + " vs " +
+                             std::to_string(label_dims[0]));
+  }
+  size_ = static_cast<int>(image_dims[0]);
+  rows_ = static_cast<int>(image_dims[1]);
+  cols_ = static_cast<int>(image_dims[2]);
+}
+
+std::string IdxDataSet::labels_path_for(const std::string& images_path) {
+  const std::string from = "images-idx3";
+  const auto pos = images_path.rfind(from);
+  if (pos == std::string::npos) return "";
+  std::string out = images_path;
+  out.replace(pos, from.size(), "labels-idx1");
+  return out;
+}
+
+std::span<const uint8_t> IdxDataSet::pixels(int index) const {
+  if (index < 0 || index >= size_) {
+    throw std::out_of_range("IdxDataSet: index " + std::to_string(index) +
+                            " out of range.");
+  }
+  const size_t n = static_cast<size_t>(num_features());
+  return {pixels_ + static_cast<size_t>(index) * n, n};
+}
+
+int IdxDataSet::label(int index) const {
+  if (index < 0 || index >= size_) {
+    throw std::out_of_range("IdxDataSet: index " + std::to_string(index) +
+                            " out of range.");
+  }
+  return label_data_[index];
+}
+
+std::pair<Matrix, Matrix> IdxDataSet::get_item(int index) const {
+  const std::span<const uint8_t> src = pixels(index);
+  Matrix x(1, num_features());
+  convert(src.data(), x.get_data_ptr(), src.size(), normalize_);
+  Matrix y(1, 1, static_cast<float>(label(index)));
+  return {std::move(x), std::move(y)};
+}
+
+void IdxDataSet::decode_row(int index, float* out) const {
+  const std::span<const uint8_t> src = pixels(index);
+  convert(src.data(), out, src.size(), normalize_);
+}
+
+void IdxDataSet::decode(int begin, int end, Matrix& out) const {
+  if (begin < 0 || end > size_ || begin > end) {
+    throw std::out_of_range("IdxDataSet::decode: invalid range [" +
+                            std::to_string(begin) + ", " + std::to_string(end) +
+                            ").");
+  }
+  if (out.get_cols() != num_features() || out.get_rows() < end - begin) {
+    throw std::invalid_argument("IdxDataSet::decode: output matrix too small.");
+  }
+  const size_t n = static_cast<size_t>(end - begin) * num_features();
+  ProfileScope scope("idx.decode");
+  ProfileScope::add_counts(0.0, static_cast<double>(n),
+                           static_cast<double>(n) * sizeof(float));
+  convert(pixels_ + static_cast<size_t>(begin) * num_features(),
+          out.get_data_ptr(), n, normalize_);
+}
+
+Matrix IdxDataSet::get_features() const {
+  Matrix out = Matrix::uninitialized(size_, num_features());
+  decode(0, size_, out);
+  return out;
+}
+
+std::vector<int> IdxDataSet::get_labels() const {
+  return std::vector<int>(label_data_, label_data_ + size_);
+}
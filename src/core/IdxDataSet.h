@@ -0,0 +1,62 @@
+#ifndef IDXDATASET_H
+#define IDXDATASET_H
+// MNIST 原始发布使用的 IDX 格式（train-images-idx3-ubyte 等）。
+//
+// 文件头为 2 个 0 字节、元素类型（0x08 为 uint8）、维数，之后是各维大小
+// （大端 uint32），然后是行主序的数据。图像文件为 3 维 N x rows x cols，
+// 标签文件为 1 维 N。两个文件都被只读映射，像素保持 uint8 不展开，
+// 取样本时才转换成 float（normalize 时除以 255，与 CsvDataSet 一致）。
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DataSet.h"
+#include "MappedFile.h"
+#include "Matrix.h"
+
+class IdxDataSet : public Dataset {
+ public:
+  // 文件无法打开、格式不对或图像与标签数量不一致时抛出 std::runtime_error
+  IdxDataSet(const std::string& images_path, const std::string& labels_path,
+             bool normalize = true);
+
+  // 按 MNIST 的命名习惯由图像文件找到标签文件：
+  // "train-images-idx3-ubyte" -> "train-labels-idx1-ubyte"，找不到规律时返回空串
+  static std::string labels_path_for(const std::string& images_path);
+
+  int size() const override { return size_; }
+  // 第 index 个样本：1 x (rows*cols) 的特征与 1 x 1 的标签
+  std::pair<Matrix, Matrix> get_item(int index) const override;
+
+  [[nodiscard]] int image_rows() const { return rows_; }
+  [[nodiscard]] int image_cols() const { return cols_; }
+  [[nodiscard]] int num_features() const { return rows_ * cols_; }
+
+  // 映射中第 index 张图像的原始像素，不拷贝
+  [[nodiscard]] std::span<const uint8_t> pixels(int index) const;
+  [[nodiscard]] int label(int index) const;
+
+  // 把第 index 个样本转换进 out 指向的 num_features() 个 float
+  void decode_row(int index, float* out) const;
+  // 把样本 [begin, end) 转换进 out 的前 end - begin 行
+  void decode(int begin, int end, Matrix& out) const;
+  // 全部样本的特征矩阵（N x rows*cols）与标签
+  [[nodiscard]] Matrix get_features() const;
+  [[nodiscard]] std::vector<int> get_labels() const;
+
+ private:
+  std::shared_ptr<MappedFile> images_;
+  std::shared_ptr<MappedFile> labels_;
+  const uint8_t* pixels_ = nullptr;
+  const uint8_t* label_data_ = nullptr;
+  int size_ = 0;
+  int rows_ = 0;
+  int cols_ = 0;
+  bool normalize_;
+};
+
+#endif  // !IDXDATASET_H
@@ -0,0 +1,43 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+MappedFile::MappedFile(const std::string& path, bool copy_on_write)
+    : copy_on_write_(copy_on_write) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("无法加载文件: " + path);
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw std::runtime_error("无法读取文件信息: " + path);
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ > 0) {
+    const int prot = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* p = mmap(nullptr, size_, prot, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("无法映射文件: " + path);
+    }
+    data_ = static_cast<const char*>(p);
+  }
+  // 映射建立后不再需要文件描述符
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+}
+
+void MappedFile::will_need() const {
+  if (data_ != nullptr) {
+    madvise(const_cast<char*>(data_), size_, MADV_WILLNEED);
+  }
+}
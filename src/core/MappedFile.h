@@ -0,0 +1,34 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+// 把整个文件映射进内存，析构时解除映射。空文件不映射，data() 为空。
+// 默认只读；copy_on_write 时映射可写但为私有，写入只改本进程的页，不会写回文件。
+
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+ public:
+  // 打开或映射失败时抛出 std::runtime_error
+  explicit MappedFile(const std::string& path, bool copy_on_write = false);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  [[nodiscard]] const char* data() const { return data_; }
+  // 仅 copy_on_write 的映射可以写
+  [[nodiscard]] char* writable_data() const {
+    return copy_on_write_ ? const_cast<char*>(data_) : nullptr;
+  }
+  [[nodiscard]] size_t size() const { return size_; }
+
+  // 提示内核马上要顺序读取整个映射，提前预读
+  void will_need() const;
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool copy_on_write_ = false;
+};
+
+#endif  // !MAPPEDFILE_H
@@ -1,28 +1,70 @@
 #include "Matrix.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
-void Matrix::clear_grad() { std::fill(data_.begin(), data_.end(), 0.0f); };
-void Matrix::clear() { std::fill(data_.begin(), data_.end(), 0.0f); };
-Matrix::Matrix(int r, int c) : rows_(r), cols_(c), data_(r * c, 0.0f) {}
+#include <string>
+#include <utility>
+
+void Matrix::clear_grad() { std::fill(data(), data() + rows_ * cols_, 0.0f); };
+void Matrix::clear() { std::fill(data(), data() + rows_ * cols_, 0.0f); };
+Matrix::Matrix(int r, int c) : rows_(r), cols_(c) {
+  const int shape[2] = {r, c};
+  const float zero = 0.0f;
+  allocate(shape, 2, &zero);
+}
+Matrix::Matrix(const Matrix& other)
+    : Tensor(), rows_(other.rows_), cols_(other.cols_) {
+  const int shape[2] = {rows_, cols_};
+  allocate(shape, 2, nullptr);
+  std::memcpy(data(), other.data(), sizeof(float) * rows_ * cols_);
+}
+Matrix& Matrix::operator=(const Matrix& other) {
+  if (this != &other) {
+    // 形状相同且存储未被其他视图共享时直接复用缓冲区，避免重新分配
+    if (rows_ != other.rows_ || cols_ != other.cols_ || !storage_ ||
+        storage_.use_count() != 1) {
+      rows_ = other.rows_;
+      cols_ = other.cols_;
+      const int shape[2] = {rows_, cols_};
+      allocate(shape, 2, nullptr);
+    }
+    std::memcpy(data(), other.data(), sizeof(float) * rows_ * cols_);
+  }
+  return *this;
+}
+Matrix::Matrix(AdoptTensor, Tensor t)
+    : Tensor(std::move(t)), rows_(shape_[0]), cols_(shape_[1]) {}
+
+Matrix Matrix::from_tensor(const Tensor& t) {
+  if (t.dim() != 2) {
+    throw std::invalid_argument("Matrix::from_tensor: expected a 2-D tensor, got " +
+                                std::to_string(t.dim()) + "-D.");
+  }
+  return Matrix(AdoptTensor{}, t.contiguous());
+}
 Matrix::Matrix(const std::vector<std::vector<float>>& data)
-    : rows_(data.size()),
-      cols_(data.empty() ? 0 : data[0].size()),
-      data_(rows_ * cols_, 0.0f) {
+    : rows_(data.size()), cols_(data.empty() ? 0 : data[0].size()) {
+  const int shape[2] = {rows_, cols_};
+  allocate(shape, 2, nullptr);
+  float* dst = this->data();
   int num = 0;
   for (int i = 0; i < rows_; ++i) {
     if (data[i].size() != cols_) {
       throw std::invalid_argument("Input data is not a regular matrix.");
     }
     for (int j = 0; j < cols_; ++j) {
-      data_[num] = data[i][j];
+      dst[num] = data[i][j];
       num++;
     }
   }
 }
-Matrix::Matrix(int r, int c, float num)
-    : rows_(r), cols_(c), data_(r * c, num) {}
+Matrix::Matrix(int r, int c, float num) : rows_(r), cols_(c) {
+  const int shape[2] = {r, c};
+  allocate(shape, 2, &num);
+}
 
 Matrix Matrix::transpose() {
   Matrix n_matrix(cols_, rows_);
@@ -43,6 +85,14 @@ Matrix Matrix::ones(int r, int c) {
   Matrix m(r, c, 1.0);
   return m;
 }
+Matrix Matrix::uninitialized(int r, int c) {
+  Matrix m(0, 0);
+  m.rows_ = r;
+  m.cols_ = c;
+  const int shape[2] = {r, c};
+  m.allocate(shape, 2, nullptr);
+  return m;
+}
 
 Matrix Matrix::identity(int size) {
   Matrix m(size, size);
@@ -56,14 +106,14 @@ float& Matrix::operator()(int r, int c) {
   if (r >= rows_ || c >= cols_) {
     throw std::out_of_range("重载() 访问超出边界\n");
   }
-  return data_[r * cols_ + c];
+  return data()[r * cols_ + c];
 }
 
 const float& Matrix::operator()(int r, int c) const {
   if (r >= rows_ || c >= cols_) {
     throw std::out_of_range("重载() 访问超出边界\n");
   }
-  return data_[r * cols_ + c];
+  return data()[r * cols_ + c];
 }
 
 Matrix Matrix::operator+(const Matrix& other) const {
@@ -84,9 +134,29 @@ Matrix Matrix::operator+(const Matrix& other) const {
   return m;
 }
 
+Matrix& Matrix::operator+=(const Matrix& other) {
+  add_scaled(other, 1.0f);
+  return *this;
+}
+
+void Matrix::add_scaled(const Matrix& other, float alpha) {
+  if (other.get_rows() != rows_ || other.get_cols() != cols_) {
+    throw std::invalid_argument(
+        "Matrix add_scaled: Dimensions mismatch. "
+        "Left matrix is " +
+        std::to_string(rows_) + "x" + std::to_string(cols_) +
+        ", Right matrix is " + std::to_string(other.get_rows()) + "x" +
+        std::to_string(other.get_cols()) + ".");
+  }
+  float* dst = data();
+  const float* src = other.data();
+  const size_t n = static_cast<size_t>(rows_) * cols_;
+  for (size_t i = 0; i < n; ++i) dst[i] += alpha * src[i];
+}
+
 Matrix Matrix::sum() const {
   Matrix m(1, 1);
-  for (auto i : data_) {
+  for (float i : get_data()) {
     m(0, 0) += i;
   }
   return m;
@@ -206,7 +276,12 @@ Matrix Matrix::get_row(int row_index) const {
   return row_matrix;
 }
 
-std::vector<float>& Matrix::get_data() { return data_; }
+std::span<float> Matrix::get_data() {
+  return {data(), static_cast<size_t>(rows_) * cols_};
+}
+std::span<const float> Matrix::get_data() const {
+  return {data(), static_cast<size_t>(rows_) * cols_};
+}
 
-float* Matrix::get_data_ptr() { return data_.data(); }
-const float* Matrix::get_data_ptr() const { return data_.data(); }
+float* Matrix::get_data_ptr() { return data(); }
+const float* Matrix::get_data_ptr() const { return data(); }
@@ -1,16 +1,31 @@
 #ifndef MATRIX_H
 #define MATRIX_H
+#include <span>
 #include <vector>
-class Matrix {
+
+#include "Tensor.h"
+// 二维、行主序连续的 Tensor。与 Tensor 的浅拷贝不同，Matrix 保持值语义：
+// 拷贝构造与拷贝赋值都会复制数据；需要视图时使用继承来的 reshape/slice 等。
+class Matrix : public Tensor {
  private:
   int rows_;
   int cols_;
-  std::vector<float> data_;
+
+  // 接管一个二维连续张量（共享其存储）。带标签参数，
+  // 避免与 Matrix({{...}}) 这样的花括号初始化产生歧义
+  struct AdoptTensor {};
+  Matrix(AdoptTensor, Tensor t);
 
  public:
   explicit Matrix(int r, int c);
   explicit Matrix(int r, int c, float num);
   explicit Matrix(const std::vector<std::vector<float>>& data);
+  Matrix(const Matrix& other);
+  Matrix(Matrix&& other) noexcept = default;
+  Matrix& operator=(const Matrix& other);
+  Matrix& operator=(Matrix&& other) noexcept = default;
+  // 由二维张量构造：连续时零拷贝共享存储，否则拷贝为连续
+  static Matrix from_tensor(const Tensor& t);
   [[nodiscard]] int get_rows() const { return rows_; }
   [[nodiscard]] int get_cols() const { return cols_; }
 
@@ -20,13 +35,20 @@ class Matrix {
   Matrix sum() const;
   Matrix element_mul(const Matrix& other) const;
   Matrix transpose();
+  using Tensor::transpose;  // 保留 transpose(d0, d1) 视图版本
   static Matrix zeros(int r, int c);
   static Matrix ones(int r, int c);
+  // 不初始化内容，调用者随后会整体写入（如数据集加载）
+  static Matrix uninitialized(int r, int c);
   static Matrix identity(int size);  // 创建单位矩阵
   Matrix operator+(const Matrix& other) const;
   Matrix operator*(const float num) const;
   Matrix operator*(const Matrix& other) const;
   Matrix operator-(const Matrix& other) const;
+  // 原地累加，避免 grad = grad + x 产生临时矩阵
+  Matrix& operator+=(const Matrix& other);
+  // this += alpha * other
+  void add_scaled(const Matrix& other, float alpha);
   void print() const;
   [[nodiscard]] float& operator()(int r, int c);
   const float& operator()(int r, int c) const;
@@ -35,7 +57,8 @@ class Matrix {
   Matrix sum_rows() const;
   float* get_data_ptr();
   const float* get_data_ptr() const;
-  std::vector<float>& get_data();
+  std::span<float> get_data();
+  std::span<const float> get_data() const;
 };
 
 #endif  // !MATRIX_H
@@ -1,14 +1,19 @@
 #include "Node.h"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "Matrix.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
 
 Node::Node(Matrix v, const std::vector<std::weak_ptr<Node>>& p,
            const std::string& n)
@@ -18,7 +23,18 @@ Node::Node(Matrix v, const std::vector<std::weak_ptr<Node>>& p,
       _backward([]() {}),
       name(n) {}
 
-void Node::backward() {
+void Node::accumulate_grad(const Matrix& g, float alpha) {
+  std::lock_guard<std::mutex> lock(grad_mutex_);
+  grad.add_scaled(g, alpha);
+}
+
+bool Node::can_overwrite_value() const {
+  return !parent.empty() && consumers_ == 0 && !backward_reads_value &&
+         !overwritten_ && !bf16_only() && value.storage().use_count() == 1;
+}
+
+namespace {
+std::vector<Node*> build_topo_order(Node* root) {
   std::vector<Node*> topo_order;
   std::set<Node*> visited;
 
@@ -34,10 +50,90 @@ void Node::backward() {
     topo_order.push_back(node);
   };
 
-  build_topo(this);
+  build_topo(root);
+  return topo_order;
+}
+}  // namespace
+
+void Node::backward() {
+  std::vector<Node*> topo_order = build_topo_order(this);
 
   this->grad = Matrix(1, 1, 1.0f);
 
   std::reverse(topo_order.begin(), topo_order.end());
-  for (Node* node : topo_order) node->_backward();
+  for (Node* node : topo_order) {
+    ProfileScope scope(node->name, ".backward");
+    node->_backward();
+  }
+}
+
+void Node::backward(ThreadPool& pool) {
+  std::vector<Node*> topo_order = build_topo_order(this);
+  // 与 backward() 相同的执行顺序
+  std::reverse(topo_order.begin(), topo_order.end());
+
+  // 节点 n 完成后，after[n] 中的节点各少一个前驱；pending[n] 为 n 尚未完成的前驱数。
+  // 两类依赖：
+  // 1. n 的所有使用者都把梯度累加完之后 n 才就绪；
+  // 2. 同一个节点的使用者按 backward() 中的先后依次执行。浮点加法不满足结合律，
+  //    累加顺序随分支完成的先后变化时结果不能逐位复现；固定顺序后与 backward()
+  //    逐位相同。代价是共享输入的兄弟分支的反向不再重叠，互不相关的分支仍并发执行。
+  std::unordered_map<Node*, std::atomic<int>> pending;
+  std::unordered_map<Node*, std::vector<Node*>> after;
+  std::unordered_map<Node*, std::vector<Node*>> consumers_in_order;
+  for (Node* node : topo_order) pending[node].store(0);
+  auto add_edge = [&](Node* from, Node* to) {
+    auto& next = after[from];
+    // 同一个父节点出现两次（如 element_mul(a, a)）只算一条依赖
+    if (std::find(next.begin(), next.end(), to) != next.end()) return;
+    next.push_back(to);
+    pending[to].fetch_add(1, std::memory_order_relaxed);
+  };
+  for (Node* node : topo_order) {
+    after[node];
+    for (const auto& p : node->parent) {
+      if (auto sp = p.lock()) {
+        auto& cs = consumers_in_order[sp.get()];
+        if (!cs.empty() && cs.back() == node) continue;
+        cs.push_back(node);
+        add_edge(node, sp.get());
+      }
+    }
+  }
+  for (const auto& [p, cs] : consumers_in_order) {
+    for (size_t i = 1; i < cs.size(); ++i) add_edge(cs[i - 1], cs[i]);
+  }
+
+  this->grad = Matrix(1, 1, 1.0f);
+
+  const int total = static_cast<int>(topo_order.size());
+  std::atomic<int> finished{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  std::function<void(Node*)> run = [&](Node* node) {
+    if (!failed.load(std::memory_order_relaxed)) {
+      try {
+        ProfileScope scope(node->name, ".backward");
+        node->_backward();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+        failed.store(true);
+      }
+    }
+    for (Node* next : after.at(node)) {
+      if (pending.at(next).fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        pool.submit([&run, next]() { run(next); });
+      }
+    }
+    finished.fetch_add(1, std::memory_order_release);
+  };
+
+  pool.submit([&run, this]() { run(this); });
+  pool.help_until([&]() {
+    return finished.load(std::memory_order_acquire) == total;
+  });
+  if (error) std::rethrow_exception(error);
 }
@@ -3,12 +3,15 @@
 #include <cmath>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "BFloat16.h"
 #include "Matrix.h"
 
 class Graph;
+class ThreadPool;
 class Node : public std::enable_shared_from_this<Node> {
  private:
   friend class Graph;
@@ -16,12 +19,26 @@ class Node : public std::enable_shared_from_this<Node> {
   explicit Node(Matrix v, const std::vector<std::weak_ptr<Node>>& p,
                 const std::string& name);
 
+  // 并行反向时多个子节点可能同时向同一个 grad 累加
+  std::mutex grad_mutex_;
+  // 以本节点为输入的算子个数，由 Graph::make_node 维护
+  int consumers_ = 0;
+  // value 已被原地算子覆盖，之后不能再作为输入
+  bool overwritten_ = false;
+
  public:
   Matrix value;
   Matrix grad;
-  const std::vector<std::weak_ptr<Node>> parent;
+  // 混合精度下 value 的 bf16 形式。参数节点指向 ParameterStore 维护的持久副本；
+  // bf16 dense 的隐藏层输出只存在这里，value 为 0x0，grad 按 value16 的形状分配。
+  std::shared_ptr<BF16Matrix> value16;
+  // 只有图改写（见 ops/fusion.h）会在反向之前替换
+  std::vector<std::weak_ptr<Node>> parent;
   std::function<void()> _backward;
   std::string name;
+  // 本节点的反向是否读取自己的 value（如 sigmoid 由输出求导）。
+  // 默认保守地为 true，不读取的算子在创建节点后置为 false。
+  bool backward_reads_value = true;
 
   // --- 禁用拷贝和移动，保证节点身份唯一 ---
   Node(const Node&) = delete;
@@ -30,6 +47,28 @@ class Node : public std::enable_shared_from_this<Node> {
   Node& operator=(Node&&) = delete;
 
   // --- 公共方法 ---
+  // 按逆拓扑序逐个执行反向；每个节点的梯度按固定的使用者顺序累加
   void backward();
+  // 按依赖计数构建任务图，就绪的节点在线程池中并发执行反向。
+  // 同一个节点的使用者按 backward() 中的顺序依次累加，梯度与 backward() 逐位相同
+  void backward(ThreadPool& pool);
+
+  // 线程安全地执行 grad += alpha * g，算子的反向统一通过它累加梯度
+  void accumulate_grad(const Matrix& g, float alpha = 1.0f);
+  // 需要直接原地写 grad 的计算核（如融合 dense）在写之前持有该锁
+  std::mutex& grad_mutex() { return grad_mutex_; }
+
+  // value 为空、数据只在 value16 中（bf16 dense 的隐藏层输出）
+  [[nodiscard]] bool bf16_only() const { return value16 && value.numel() == 0; }
+
+  // 原地算子能否覆盖本节点的 value：必须是非叶子节点（不覆盖参数与输入数据）、
+  // 还没有任何消费者、自身反向不读 value，value 的存储没有被别的视图共享，
+  // 且 value 不为空（bf16_only() 的节点没有可覆盖的 fp32 值）。
+  [[nodiscard]] bool can_overwrite_value() const;
+  // 由原地算子调用；之后再把本节点作为输入会抛出异常
+  void mark_overwritten() { overwritten_ = true; }
+  [[nodiscard]] bool value_overwritten() const { return overwritten_; }
+  // 以本节点为输入的算子个数（包括不在某个根节点子图中的使用者）
+  [[nodiscard]] int consumers() const { return consumers_; }
 };
 #endif  // !NODE_H
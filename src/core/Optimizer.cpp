@@ -0,0 +1,256 @@
+#include "Optimizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "ParameterStore.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+
+namespace {
+
+// 每个并行任务处理的元素数：足够大以摊薄调度开销，又能让
+// 784x128 这类中等参数分到多个线程上。
+constexpr size_t kChunkElements = size_t{1} << 14;
+
+size_t numel(const Node& p) {
+  return static_cast<size_t>(p.value.get_rows()) * p.value.get_cols();
+}
+
+void check_hyperparameter(bool ok, const char* who, const char* what) {
+  if (!ok) {
+    throw std::invalid_argument(std::string(who) + ": invalid " + what + ".");
+  }
+}
+
+}  // namespace
+
+ParameterList::ParameterList(ParameterStore& s)
+    : nodes(s.params()), store(&s) {}
+
+Optimizer::Optimizer(ParameterList params, float lr)
+    : params_(std::move(params.nodes)), store_(params.store), lr_(lr) {
+  check_hyperparameter(lr > 0.0f, "Optimizer", "learning rate");
+  for (size_t i = 0; i < params_.size(); ++i) {
+    if (!params_[i]) {
+      throw std::invalid_argument("Optimizer: null parameter node.");
+    }
+    for (size_t j = 0; j < i; ++j) {
+      if (params_[j] == params_[i]) {
+        throw std::invalid_argument("Optimizer: parameter '" +
+                                    params_[i]->name +
+                                    "' registered twice.");
+      }
+    }
+    if (store_ != nullptr) continue;
+    const size_t n = numel(*params_[i]);
+    state_offsets_.push_back(total_elements_);
+    total_elements_ += n;
+    for (size_t begin = 0; begin < n; begin += kChunkElements) {
+      chunks_.push_back({i, begin, std::min(n, begin + kChunkElements)});
+    }
+  }
+  if (store_ != nullptr) {
+    // 整块缓冲区（含为 0 的对齐填充，更新后仍为 0）按下标切块
+    total_elements_ = store_->size();
+    for (size_t begin = 0; begin < total_elements_; begin += kChunkElements) {
+      chunks_.push_back(
+          {0, begin, std::min(total_elements_, begin + kChunkElements)});
+    }
+  }
+}
+
+void Optimizer::set_learning_rate(float lr) {
+  check_hyperparameter(lr > 0.0f, "Optimizer", "learning rate");
+  lr_ = lr;
+}
+
+std::vector<float> Optimizer::make_state() const {
+  return std::vector<float>(total_elements_, 0.0f);
+}
+
+std::vector<float> Optimizer::state() {
+  std::vector<float> out;
+  for (const std::vector<float>* s : state_vectors()) {
+    out.insert(out.end(), s->begin(), s->end());
+  }
+  return out;
+}
+
+void Optimizer::load_state(std::span<const float> state, int64_t step_count) {
+  size_t expected = 0;
+  for (const std::vector<float>* s : state_vectors()) expected += s->size();
+  if (state.size() != expected || step_count < 0) {
+    throw std::invalid_argument(
+        "Optimizer::load_state: expected " + std::to_string(expected) +
+        " state values, got " + std::to_string(state.size()) + ".");
+  }
+  size_t pos = 0;
+  for (std::vector<float>* s : state_vectors()) {
+    std::copy_n(state.begin() + pos, s->size(), s->begin());
+    pos += s->size();
+  }
+  t_ = step_count;
+}
+
+void Optimizer::run_chunk(const Chunk& c) {
+  const size_t n = c.end - c.begin;
+  if (store_ != nullptr) {
+    update(store_->values().data() + c.begin, store_->grads().data() + c.begin,
+           c.begin, n);
+  } else {
+    Node& p = *params_[c.param];
+    update(p.value.get_data_ptr() + c.begin, p.grad.get_data_ptr() + c.begin,
+           state_offsets_[c.param] + c.begin, n);
+  }
+}
+
+void Optimizer::step(ThreadPool* pool) {
+  ProfileScope scope("optimizer.step");
+  if (store_ != nullptr) {
+    if (!store_->is_bound()) {
+      throw std::runtime_error(
+          "Optimizer::step: a parameter was reassigned and no longer views "
+          "its ParameterStore.");
+    }
+  } else {
+    for (const auto& p : params_) {
+      if (p->grad.get_rows() != p->value.get_rows() ||
+          p->grad.get_cols() != p->value.get_cols()) {
+        throw std::runtime_error("Optimizer::step: gradient of '" + p->name +
+                                 "' does not match its value shape.");
+      }
+    }
+  }
+  ++t_;
+  prepare_step();
+  // 访存量：读 value、grad 与状态，写回 value 与状态
+  const double n = static_cast<double>(total_elements_);
+  const int s = state_buffers();
+  ProfileScope::add_counts(0.0, 4.0 * (2 + s) * n, 4.0 * (1 + s) * n);
+
+  if (pool == nullptr || pool->size() <= 1 || chunks_.size() <= 1) {
+    for (const Chunk& c : chunks_) run_chunk(c);
+    return;
+  }
+  // 各块互不重叠，任务之间无需同步；等待线程同时帮忙执行任务
+  std::atomic<size_t> finished{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  for (const Chunk& c : chunks_) {
+    pool->submit([this, c, &finished, &error, &error_mutex]() {
+      try {
+        run_chunk(c);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+      finished.fetch_add(1, std::memory_order_release);
+    });
+  }
+  pool->help_until([&]() {
+    return finished.load(std::memory_order_acquire) == chunks_.size();
+  });
+  if (error) std::rethrow_exception(error);
+}
+
+void Optimizer::zero_grad() {
+  if (store_ != nullptr) {
+    store_->zero_grad();
+    return;
+  }
+  for (const auto& p : params_) p->grad.clear_grad();
+}
+
+SGD::SGD(ParameterList params, float lr, float momentum,
+         bool nesterov, float weight_decay)
+    : Optimizer(std::move(params), lr),
+      momentum_(momentum),
+      nesterov_(nesterov),
+      weight_decay_(weight_decay) {
+  check_hyperparameter(momentum >= 0.0f && momentum < 1.0f, "SGD", "momentum");
+  check_hyperparameter(weight_decay >= 0.0f, "SGD", "weight decay");
+  check_hyperparameter(!nesterov || momentum > 0.0f, "SGD",
+                       "Nesterov setting (requires momentum > 0)");
+  if (momentum_ > 0.0f) velocity_ = make_state();
+}
+
+void SGD::update(float* __restrict w, const float* __restrict g,
+                 size_t state_offset, size_t n) {
+  const float lr = lr_;
+  const float wd = weight_decay_;
+  const float mu = momentum_;
+  if (mu == 0.0f) {
+    for (size_t k = 0; k < n; ++k) w[k] -= lr * (g[k] + wd * w[k]);
+    return;
+  }
+  float* __restrict v = velocity_.data() + state_offset;
+  if (nesterov_) {
+    for (size_t k = 0; k < n; ++k) {
+      const float d = g[k] + wd * w[k];
+      v[k] = mu * v[k] + d;
+      w[k] -= lr * (d + mu * v[k]);
+    }
+  } else {
+    for (size_t k = 0; k < n; ++k) {
+      v[k] = mu * v[k] + g[k] + wd * w[k];
+      w[k] -= lr * v[k];
+    }
+  }
+}
+
+Adam::Adam(ParameterList params, float lr, float beta1,
+           float beta2, float eps, float weight_decay)
+    : Adam(std::move(params), lr, beta1, beta2, eps, weight_decay, false) {}
+
+Adam::Adam(ParameterList params, float lr, float beta1,
+           float beta2, float eps, float weight_decay, bool decoupled)
+    : Optimizer(std::move(params), lr),
+      beta1_(beta1),
+      beta2_(beta2),
+      eps_(eps),
+      weight_decay_(weight_decay),
+      decoupled_(decoupled),
+      m_(make_state()),
+      v_(make_state()) {
+  check_hyperparameter(beta1 >= 0.0f && beta1 < 1.0f, "Adam", "beta1");
+  check_hyperparameter(beta2 >= 0.0f && beta2 < 1.0f, "Adam", "beta2");
+  check_hyperparameter(eps > 0.0f, "Adam", "epsilon");
+  check_hyperparameter(weight_decay >= 0.0f, "Adam", "weight decay");
+}
+
+void Adam::prepare_step() {
+  const double t = static_cast<double>(t_);
+  step_size_ = static_cast<float>(lr_ / (1.0 - std::pow(beta1_, t)));
+  inv_sqrt_bias2_ = static_cast<float>(1.0 / std::sqrt(1.0 - std::pow(beta2_, t)));
+}
+
+void Adam::update(float* __restrict w, const float* __restrict g,
+                  size_t state_offset, size_t n) {
+  float* __restrict m = m_.data() + state_offset;
+  float* __restrict v = v_.data() + state_offset;
+  const float b1 = beta1_, b2 = beta2_;
+  const float eps = eps_;
+  const float step_size = step_size_;
+  const float inv_sqrt_bias2 = inv_sqrt_bias2_;
+  // 解耦时先按 (1 - lr * wd) 缩放参数；耦合时把 wd * w 加进梯度
+  const float decay = decoupled_ ? 1.0f - lr_ * weight_decay_ : 1.0f;
+  const float l2 = decoupled_ ? 0.0f : weight_decay_;
+  for (size_t k = 0; k < n; ++k) {
+    const float d = g[k] + l2 * w[k];
+    m[k] = b1 * m[k] + (1.0f - b1) * d;
+    v[k] = b2 * v[k] + (1.0f - b2) * d * d;
+    w[k] = decay * w[k] -
+           step_size * m[k] / (std::sqrt(v[k]) * inv_sqrt_bias2 + eps);
+  }
+}
+
+AdamW::AdamW(ParameterList params, float lr, float beta1,
+             float beta2, float eps, float weight_decay)
+    : Adam(std::move(params), lr, beta1, beta2, eps, weight_decay, true) {}
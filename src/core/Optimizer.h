@@ -0,0 +1,158 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+// 优化器：持有参数节点及平坦的状态缓冲区（动量、一/二阶矩），
+// step() 对所有参数原地做一次融合更新（每个元素只读写一遍 value/grad/状态），
+// 传入线程池时按固定大小的块并行；zero_grad() 清零全部梯度。
+// 参数来自 ParameterStore 时，更新与清零直接沿整块平坦缓冲区线性进行。
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Node.h"
+
+class ParameterStore;
+class ThreadPool;
+
+// 优化器的参数来源：一组独立的节点，或打包在 ParameterStore 中的节点。
+// 后者由调用者保证在优化器的整个生命周期内有效。
+struct ParameterList {
+  std::vector<std::shared_ptr<Node>> nodes;
+  ParameterStore* store = nullptr;
+
+  ParameterList(std::vector<std::shared_ptr<Node>> params)
+      : nodes(std::move(params)) {}
+  ParameterList(std::initializer_list<std::shared_ptr<Node>> params)
+      : nodes(params) {}
+  ParameterList(ParameterStore& s);
+};
+
+class Optimizer {
+ public:
+  Optimizer(ParameterList params, float lr);
+  virtual ~Optimizer() = default;
+
+  Optimizer(const Optimizer&) = delete;
+  Optimizer& operator=(const Optimizer&) = delete;
+
+  // 用当前梯度更新全部参数；pool 非空且参数足够大时分块并行
+  void step(ThreadPool* pool = nullptr);
+  void zero_grad();
+
+  [[nodiscard]] float learning_rate() const { return lr_; }
+  void set_learning_rate(float lr);
+  [[nodiscard]] int64_t step_count() const { return t_; }
+  [[nodiscard]] const std::vector<std::shared_ptr<Node>>& params() const {
+    return params_;
+  }
+  // 参数来自 ParameterStore 时返回它，否则为 nullptr
+  [[nodiscard]] ParameterStore* store() const { return store_; }
+
+  // 检查点：全部状态缓冲区按顺序拼接成一块；load_state 同时恢复步数
+  // （Adam 的偏差修正依赖它），长度不符时抛出 std::invalid_argument
+  [[nodiscard]] std::vector<float> state();
+  void load_state(std::span<const float> state, int64_t step_count);
+
+ protected:
+  // 每次 step 开始时调用一次，用于预先计算本步的标量系数（如偏差修正）
+  virtual void prepare_step() {}
+  // 更新 n 个连续元素：w / g 指向参数与梯度，状态从下标 state_offset 开始。
+  // 不同区间可能在不同线程上并发调用。
+  virtual void update(float* w, const float* g, size_t state_offset,
+                      size_t n) = 0;
+  // 每个参数对应的状态缓冲区个数，用于性能分析的访存统计
+  [[nodiscard]] virtual int state_buffers() const { return 0; }
+  // 子类的状态缓冲区，供 state() / load_state() 读写
+  virtual std::vector<std::vector<float>*> state_vectors() { return {}; }
+
+  // 分配一块覆盖全部参数、初值为 0 的平坦状态缓冲区
+  [[nodiscard]] std::vector<float> make_state() const;
+
+  std::vector<std::shared_ptr<Node>> params_;
+  ParameterStore* store_;
+  float lr_;
+  int64_t t_ = 0;
+
+ private:
+  // 参数 param 的 [begin, end)；打包时 param 无意义，区间是平坦缓冲区的下标
+  struct Chunk {
+    size_t param;
+    size_t begin;
+    size_t end;
+  };
+  void run_chunk(const Chunk& c);
+
+  std::vector<Chunk> chunks_;
+  // 每个参数在状态缓冲区中的起始下标
+  std::vector<size_t> state_offsets_;
+  size_t total_elements_ = 0;
+};
+
+// SGD，可选动量与 Nesterov 动量；weight_decay 为加到梯度上的 L2 项：
+//   g = grad + wd * w,  v = μ v + g,  w -= lr * (nesterov ? g + μ v : v)
+class SGD : public Optimizer {
+ public:
+  SGD(ParameterList params, float lr,
+      float momentum = 0.0f, bool nesterov = false, float weight_decay = 0.0f);
+
+ protected:
+  void update(float* w, const float* g, size_t state_offset,
+              size_t n) override;
+  [[nodiscard]] int state_buffers() const override {
+    return momentum_ > 0.0f ? 1 : 0;
+  }
+  std::vector<std::vector<float>*> state_vectors() override {
+    return {&velocity_};
+  }
+
+ private:
+  float momentum_;
+  bool nesterov_;
+  float weight_decay_;
+  std::vector<float> velocity_;
+};
+
+// Adam；weight_decay 与 SGD 一样作为 L2 项加到梯度上（耦合形式）
+class Adam : public Optimizer {
+ public:
+  Adam(ParameterList params, float lr = 1e-3f,
+       float beta1 = 0.9f, float beta2 = 0.999f, float eps = 1e-8f,
+       float weight_decay = 0.0f);
+
+ protected:
+  Adam(ParameterList params, float lr, float beta1,
+       float beta2, float eps, float weight_decay, bool decoupled);
+  void prepare_step() override;
+  void update(float* w, const float* g, size_t state_offset,
+              size_t n) override;
+  [[nodiscard]] int state_buffers() const override { return 2; }
+  std::vector<std::vector<float>*> state_vectors() override {
+    return {&m_, &v_};
+  }
+
+ private:
+  float beta1_;
+  float beta2_;
+  float eps_;
+  float weight_decay_;
+  bool decoupled_;
+  // 本步的 lr / (1 - β1^t) 与 1 / sqrt(1 - β2^t)
+  float step_size_ = 0.0f;
+  float inv_sqrt_bias2_ = 1.0f;
+  std::vector<float> m_;
+  std::vector<float> v_;
+};
+
+// AdamW：权重衰减与梯度解耦，直接作用在参数上 w -= lr * wd * w
+class AdamW : public Adam {
+ public:
+  AdamW(ParameterList params, float lr = 1e-3f,
+        float beta1 = 0.9f, float beta2 = 0.999f, float eps = 1e-8f,
+        float weight_decay = 1e-2f);
+};
+
+#endif  // !OPTIMIZER_H
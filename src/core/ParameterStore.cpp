@@ -0,0 +1,115 @@
+#include "ParameterStore.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "Matrix.h"
+#include "Profiler.h"
+
+namespace {
+
+// 64 字节 = 16 个 float，与 Storage 的对齐一致
+constexpr size_t kAlignFloats = 16;
+
+size_t numel(const Matrix& m) {
+  return static_cast<size_t>(m.get_rows()) * m.get_cols();
+}
+
+Matrix view_of(const std::shared_ptr<Storage>& storage, const Matrix& like,
+               size_t offset) {
+  return Matrix::from_tensor(Tensor(storage, {like.get_rows(), like.get_cols()},
+                                    {like.get_cols(), 1},
+                                    static_cast<long>(offset)));
+}
+
+}  // namespace
+
+ParameterStore::ParameterStore(std::vector<std::shared_ptr<Node>> params)
+    : params_(std::move(params)) {
+  for (size_t i = 0; i < params_.size(); ++i) {
+    if (!params_[i]) {
+      throw std::invalid_argument("ParameterStore: null parameter node.");
+    }
+    for (size_t j = 0; j < i; ++j) {
+      if (params_[j] == params_[i]) {
+        throw std::invalid_argument("ParameterStore: parameter '" +
+                                    params_[i]->name + "' registered twice.");
+      }
+    }
+    const Node& p = *params_[i];
+    if (p.grad.get_rows() != p.value.get_rows() ||
+        p.grad.get_cols() != p.value.get_cols()) {
+      throw std::invalid_argument("ParameterStore: gradient of '" + p.name +
+                                  "' does not match its value shape.");
+    }
+    offsets_.push_back(size_);
+    size_ += (numel(p.value) + kAlignFloats - 1) / kAlignFloats * kAlignFloats;
+  }
+
+  values_ = std::make_shared<Storage>(size_);
+  grads_ = std::make_shared<Storage>(size_);
+  for (size_t i = 0; i < params_.size(); ++i) {
+    Node& p = *params_[i];
+    const size_t n = numel(p.value);
+    if (n > 0) {
+      std::memcpy(values_->data() + offsets_[i], p.value.get_data_ptr(),
+                  n * sizeof(float));
+      std::memcpy(grads_->data() + offsets_[i], p.grad.get_data_ptr(),
+                  n * sizeof(float));
+    }
+    // 移动赋值接管视图；拷贝赋值会按值语义复制出新的存储
+    p.value = view_of(values_, p.value, offsets_[i]);
+    p.grad = view_of(grads_, p.grad, offsets_[i]);
+  }
+}
+
+void ParameterStore::zero_grad() {
+  if (size_ > 0) std::memset(grads_->data(), 0, size_ * sizeof(float));
+}
+
+bool ParameterStore::is_bound() const {
+  for (size_t i = 0; i < params_.size(); ++i) {
+    const Node& p = *params_[i];
+    if (p.value.storage() != values_ || p.grad.storage() != grads_ ||
+        p.value.offset() != static_cast<long>(offsets_[i]) ||
+        p.grad.offset() != static_cast<long>(offsets_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParameterStore::enable_bf16() {
+  if (bf16_enabled()) return;
+  for (const auto& p : params_) {
+    bf16_.push_back(std::make_shared<BF16Matrix>(p->value));
+    p->value16 = bf16_.back();
+  }
+}
+
+void ParameterStore::refresh_bf16() {
+  if (!bf16_enabled()) return;
+  ProfileScope scope("parameter_store.refresh_bf16");
+  ProfileScope::add_counts(0.0, 4.0 * size_, 2.0 * size_);
+  for (size_t i = 0; i < params_.size(); ++i) bf16_[i]->assign(params_[i]->value);
+}
+
+std::vector<std::shared_ptr<Node>> ParameterStore::make_replica(
+    Graph& graph, const std::shared_ptr<Storage>& grads) const {
+  if (!grads || grads->size() < size_) {
+    throw std::invalid_argument(
+        "ParameterStore::make_replica: gradient buffer is too small.");
+  }
+  std::vector<std::shared_ptr<Node>> replica;
+  replica.reserve(params_.size());
+  for (size_t i = 0; i < params_.size(); ++i) {
+    const Matrix& like = params_[i]->value;
+    auto node = graph.make_node(view_of(values_, like, offsets_[i]),
+                                params_[i]->name);
+    node->grad = view_of(grads, like, offsets_[i]);
+    if (bf16_enabled()) node->value16 = bf16_[i];
+    replica.push_back(std::move(node));
+  }
+  return replica;
+}
@@ -0,0 +1,70 @@
+#ifndef PARAMETERSTORE_H
+#define PARAMETERSTORE_H
+// 把一组参数节点打包进两块连续的平坦缓冲区（一块存 value、一块存 grad）。
+// 打包后每个节点的 value / grad 都是缓冲区上的 Matrix 视图，算子照常读写；
+// 整个模型的梯度清零、优化器更新、梯度归约与快照都变成一次线性遍历或 memcpy。
+//
+// 每个参数的起始位置按 64 字节对齐，参数之间的填充始终为 0。
+// 打包后不要再对参数的 value / grad 整体赋值（Matrix 的值语义会让它们
+// 脱离缓冲区），应原地写入；is_bound() 用于检查这一点。
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "BFloat16.h"
+#include "Graph.h"
+#include "Node.h"
+#include "Tensor.h"
+
+class ParameterStore {
+ public:
+  // 拷贝各节点当前的 value 与 grad 进缓冲区，并把节点改绑为视图
+  explicit ParameterStore(std::vector<std::shared_ptr<Node>> params);
+
+  ParameterStore(const ParameterStore&) = delete;
+  ParameterStore& operator=(const ParameterStore&) = delete;
+
+  [[nodiscard]] const std::vector<std::shared_ptr<Node>>& params() const {
+    return params_;
+  }
+  // 缓冲区总元素数（含对齐填充）
+  [[nodiscard]] size_t size() const { return size_; }
+  // 第 i 个参数在缓冲区中的起始下标
+  [[nodiscard]] size_t offset(size_t i) const { return offsets_[i]; }
+
+  std::span<float> values() { return {values_->data(), size_}; }
+  std::span<const float> values() const { return {values_->data(), size_}; }
+  std::span<float> grads() { return {grads_->data(), size_}; }
+  std::span<const float> grads() const { return {grads_->data(), size_}; }
+
+  // 一次 memset 清零全部梯度
+  void zero_grad();
+  // 所有节点的 value / grad 是否仍是本缓冲区上的视图
+  [[nodiscard]] bool is_bound() const;
+
+  // 混合精度：为每个参数建立一份持久的 bf16 副本并挂到节点的 value16 上，
+  // 之后 make_replica 创建的节点共享同一份副本，bf16 dense 直接读取它。
+  // 主权重改变后（优化器更新、恢复检查点）调用 refresh_bf16() 原地重新转换；
+  // 未启用时 refresh_bf16() 什么也不做。
+  void enable_bf16();
+  void refresh_bf16();
+  [[nodiscard]] bool bf16_enabled() const { return !bf16_.empty(); }
+
+  // 数据并行副本：在 graph 中为每个参数创建同名叶子节点，value 与本 store
+  // 共享值缓冲区（副本只读），grad 是 grads 上相同偏移处的视图。
+  // grads 至少要有 size() 个元素。
+  std::vector<std::shared_ptr<Node>> make_replica(
+      Graph& graph, const std::shared_ptr<Storage>& grads) const;
+
+ private:
+  std::vector<std::shared_ptr<Node>> params_;
+  std::vector<size_t> offsets_;
+  size_t size_ = 0;
+  std::shared_ptr<Storage> values_;
+  std::shared_ptr<Storage> grads_;
+  std::vector<std::shared_ptr<BF16Matrix>> bf16_;
+};
+
+#endif  // !PARAMETERSTORE_H
@@ -0,0 +1,53 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+// Philox4x32-10 计数器型随机数发生器（Salmon et al., SC'11）。
+// 输出只取决于 (key, counter)，没有内部状态：任意线程、任意顺序
+// 计算同一个计数器都得到同一组随机数，因此可以按元素下标并行生成，
+// 也可以在反向时重新生成与前向完全相同的随机序列。
+
+#include <array>
+#include <cstdint>
+
+namespace philox {
+
+using Block = std::array<uint32_t, 4>;
+
+inline constexpr uint32_t kMul0 = 0xD2511F53u;
+inline constexpr uint32_t kMul1 = 0xCD9E8D57u;
+inline constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+inline constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+
+// 对 128 位计数器做 10 轮 Philox 置换，返回 4 个 32 位随机数
+constexpr Block philox4x32(Block ctr, uint32_t key0, uint32_t key1) {
+  for (int round = 0; round < 10; ++round) {
+    const uint64_t p0 = static_cast<uint64_t>(kMul0) * ctr[0];
+    const uint64_t p1 = static_cast<uint64_t>(kMul1) * ctr[2];
+    ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key0,
+           static_cast<uint32_t>(p1),
+           static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key1,
+           static_cast<uint32_t>(p0)};
+    key0 += kWeyl0;
+    key1 += kWeyl1;
+  }
+  return ctr;
+}
+
+// 以 (seed, stream, index) 为键生成第 index 个 4 元随机块。
+// stream 用来区分同一 seed 下的不同用途，例如训练步数。
+constexpr Block random_block(uint64_t seed, uint64_t stream, uint64_t index) {
+  return philox4x32({static_cast<uint32_t>(index),
+                     static_cast<uint32_t>(index >> 32),
+                     static_cast<uint32_t>(stream),
+                     static_cast<uint32_t>(stream >> 32)},
+                    static_cast<uint32_t>(seed),
+                    static_cast<uint32_t>(seed >> 32));
+}
+
+// 32 位随机数映射到 [0, 1)，取高 24 位保证 float 能精确表示
+constexpr float to_unit_float(uint32_t u) {
+  return static_cast<float>(u >> 8) * (1.0f / 16777216.0f);
+}
+
+}  // namespace philox
+
+#endif  // !PHILOX_H
@@ -0,0 +1,523 @@
+#include "ProcessGroup.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "Profiler.h"
+
+extern char** environ;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::system_error errno_error(const std::string& what) {
+  return std::system_error(errno, std::generic_category(),
+                           "ProcessGroup: " + what);
+}
+
+int ring_mod(int a, int n) { return ((a % n) + n) % n; }
+
+// 把 n 个元素分成 parts 段，返回第 c 段的 [begin, end)
+std::pair<size_t, size_t> segment(size_t n, int parts, int c) {
+  return {n * c / parts, n * (c + 1) / parts};
+}
+
+// 等待 ready() 成立：先让出 CPU 自旋，之后短暂休眠；超过 deadline 抛异常
+template <typename Ready>
+void wait_until(Ready&& ready, Clock::time_point deadline, const char* what) {
+  for (int spins = 0; !ready(); ++spins) {
+    if (spins < 256) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (Clock::now() > deadline) {
+      throw std::runtime_error(std::string("ProcessGroup: timed out waiting for ") +
+                               what + ".");
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+}
+
+// ---------------------------------------------------------------------------
+// 共享内存
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t kShmMagic = 0x4E4E5047;  // "NNPG"
+constexpr size_t kHeaderBytes = 64;
+constexpr size_t kAlignFloats = 16;
+
+// 位于共享内存开头。ftruncate 出来的内存全为 0，即各计数器的初始状态
+struct ShmHeader {
+  std::atomic<uint32_t> magic;       // 0 号进程初始化完成后写入
+  std::atomic<uint32_t> joined;      // 已映射的进程数
+  std::atomic<uint32_t> arrived;     // 当前栅栏已到达的进程数
+  std::atomic<uint32_t> generation;  // 栅栏代数，最后一个到达者递增
+  uint32_t world_size;
+  uint64_t capacity;
+};
+static_assert(sizeof(ShmHeader) <= kHeaderBytes);
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "cross-process atomics must be lock-free");
+
+std::string shm_name(const std::string& job_id) { return "/nn-" + job_id; }
+
+// 在 /dev/shm 中创建并删除一个私有的小对象，判断共享内存是否可用。
+// 同一主机上的所有进程得到相同的结论，因此 Auto 不会选出不同的传输方式。
+bool shm_available(const ProcessGroupOptions& options) {
+  const std::string name = shm_name(options.job_id) + "-probe-" +
+                           std::to_string(options.rank);
+  const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+  if (fd < 0) return false;
+  bool ok = ftruncate(fd, 4096) == 0;
+  if (ok) {
+    void* p = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ok = p != MAP_FAILED;
+    if (ok) munmap(p, 4096);
+  }
+  close(fd);
+  shm_unlink(name.c_str());
+  return ok;
+}
+
+class ShmProcessGroup : public ProcessGroup {
+ public:
+  explicit ShmProcessGroup(const ProcessGroupOptions& options);
+  ~ShmProcessGroup() override {
+    if (map_ != MAP_FAILED) munmap(map_, bytes_);
+  }
+
+  [[nodiscard]] Transport transport() const override {
+    return Transport::SharedMemory;
+  }
+  void all_reduce(std::span<float> data) override;
+  void barrier() override;
+
+ private:
+  float* buffer(int rank) const {
+    return reinterpret_cast<float*>(static_cast<char*>(map_) + kHeaderBytes) +
+           rank * stride_;
+  }
+  ShmHeader& header() const { return *static_cast<ShmHeader*>(map_); }
+
+  void* map_ = MAP_FAILED;
+  size_t bytes_ = 0;
+  size_t capacity_;
+  size_t stride_;  // 相邻进程缓冲区的间隔，按 64 字节对齐
+  std::chrono::milliseconds timeout_;
+};
+
+ShmProcessGroup::ShmProcessGroup(const ProcessGroupOptions& options)
+    : ProcessGroup(options.rank, options.world_size),
+      capacity_(options.capacity),
+      stride_((options.capacity + kAlignFloats - 1) / kAlignFloats * kAlignFloats),
+      timeout_(options.timeout) {
+  const std::string name = shm_name(options.job_id);
+  bytes_ = kHeaderBytes + stride_ * world_size_ * sizeof(float);
+  const auto deadline = Clock::now() + timeout_;
+
+  if (rank_ == 0) {
+    shm_unlink(name.c_str());  // 同名的残留对象来自崩溃的旧任务
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw errno_error("shm_open " + name);
+    if (ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+      close(fd);
+      shm_unlink(name.c_str());
+      throw errno_error("ftruncate " + name);
+    }
+    map_ = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map_ == MAP_FAILED) {
+      shm_unlink(name.c_str());
+      throw errno_error("mmap " + name);
+    }
+    header().world_size = static_cast<uint32_t>(world_size_);
+    header().capacity = capacity_;
+    header().magic.store(kShmMagic, std::memory_order_release);
+  } else {
+    try {
+      // 等 0 号进程创建好并设置完大小
+      wait_until(
+          [&] {
+            const int fd = shm_open(name.c_str(), O_RDWR, 0);
+            if (fd < 0) return false;
+            struct stat st {};
+            if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < bytes_) {
+              close(fd);
+              return false;
+            }
+            map_ = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (map_ == MAP_FAILED) throw errno_error("mmap " + name);
+            return true;
+          },
+          deadline, "shared memory from rank 0");
+      wait_until(
+          [&] {
+            return header().magic.load(std::memory_order_acquire) == kShmMagic;
+          },
+          deadline, "shared memory from rank 0");
+      if (header().world_size != static_cast<uint32_t>(world_size_) ||
+          header().capacity != capacity_) {
+        throw std::runtime_error("ProcessGroup: rank " + std::to_string(rank_) +
+                                 " disagrees with rank 0 on world size or capacity.");
+      }
+    } catch (...) {
+      if (map_ != MAP_FAILED) munmap(map_, bytes_);
+      throw;
+    }
+  }
+
+  header().joined.fetch_add(1, std::memory_order_acq_rel);
+  try {
+    wait_until(
+        [&] {
+          return header().joined.load(std::memory_order_acquire) ==
+                 static_cast<uint32_t>(world_size_);
+        },
+        deadline, "all ranks to join");
+  } catch (...) {
+    if (rank_ == 0) shm_unlink(name.c_str());
+    munmap(map_, bytes_);
+    throw;
+  }
+  // 所有进程都已映射，名字不再需要；进程退出后内存自动回收
+  if (rank_ == 0) shm_unlink(name.c_str());
+}
+
+void ShmProcessGroup::barrier() {
+  ShmHeader& h = header();
+  const uint32_t generation = h.generation.load(std::memory_order_acquire);
+  if (h.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      static_cast<uint32_t>(world_size_)) {
+    h.arrived.store(0, std::memory_order_relaxed);
+    h.generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  wait_until(
+      [&] { return h.generation.load(std::memory_order_acquire) != generation; },
+      Clock::now() + timeout_, "barrier");
+}
+
+void ShmProcessGroup::all_reduce(std::span<float> data) {
+  const int n = world_size_;
+  if (n == 1) return;
+  ProfileScope scope("process_group.all_reduce");
+  float* mine = buffer(rank_);
+  const float* left = buffer(ring_mod(rank_ - 1, n));
+  for (size_t offset = 0; offset < data.size(); offset += capacity_) {
+    const size_t len = std::min(capacity_, data.size() - offset);
+    std::memcpy(mine, data.data() + offset, len * sizeof(float));
+    barrier();
+    // reduce-scatter：第 s 步把左邻居在上一步累加好的段加进自己；
+    // 结束后本进程的第 rank+1 段是所有进程之和
+    for (int s = 0; s < n - 1; ++s) {
+      const auto [begin, end] = segment(len, n, ring_mod(rank_ - 1 - s, n));
+      for (size_t k = begin; k < end; ++k) mine[k] += left[k];
+      barrier();
+    }
+    // all-gather：逐步从左邻居拷贝已完成的段
+    for (int s = 0; s < n - 1; ++s) {
+      const auto [begin, end] = segment(len, n, ring_mod(rank_ - s, n));
+      std::memcpy(mine + begin, left + begin, (end - begin) * sizeof(float));
+      barrier();
+    }
+    std::memcpy(data.data() + offset, mine, len * sizeof(float));
+    ProfileScope::add_counts(static_cast<double>(len) * (n - 1),
+                             8.0 * len * n, 4.0 * len * n);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Unix 域套接字
+// ---------------------------------------------------------------------------
+
+std::string socket_path(const std::string& job_id, int rank) {
+  return "/tmp/nn-" + job_id + "-" + std::to_string(rank) + ".sock";
+}
+
+sockaddr_un make_address(const std::string& path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    throw std::invalid_argument("ProcessGroup: socket path too long: " + path);
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  return addr;
+}
+
+class SocketProcessGroup : public ProcessGroup {
+ public:
+  explicit SocketProcessGroup(const ProcessGroupOptions& options);
+  ~SocketProcessGroup() override {
+    for (int fd : {left_fd_, right_fd_}) {
+      if (fd >= 0) close(fd);
+    }
+  }
+
+  [[nodiscard]] Transport transport() const override { return Transport::Socket; }
+  void all_reduce(std::span<float> data) override;
+  void barrier() override;
+
+ private:
+  // 同时向右邻居发送 send、从左邻居接收 recv，避免双方都阻塞在发送上
+  void exchange(const void* send, size_t send_bytes, void* recv,
+                size_t recv_bytes);
+
+  int left_fd_ = -1;
+  int right_fd_ = -1;
+  std::chrono::milliseconds timeout_;
+  std::vector<float> scratch_;
+};
+
+SocketProcessGroup::SocketProcessGroup(const ProcessGroupOptions& options)
+    : ProcessGroup(options.rank, options.world_size), timeout_(options.timeout) {
+  if (world_size_ == 1) return;
+  const auto deadline = Clock::now() + timeout_;
+  const std::string path = socket_path(options.job_id, rank_);
+  const sockaddr_un own = make_address(path);
+  const sockaddr_un right =
+      make_address(socket_path(options.job_id, (rank_ + 1) % world_size_));
+
+  const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) throw errno_error("socket");
+  unlink(path.c_str());
+  if (bind(listen_fd, reinterpret_cast<const sockaddr*>(&own), sizeof(own)) != 0 ||
+      listen(listen_fd, 1) != 0) {
+    const auto error = errno_error("bind " + path);
+    close(listen_fd);
+    throw error;
+  }
+
+  try {
+    // 右邻居可能还没开始监听，重试到超时
+    wait_until(
+        [&] {
+          right_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+          if (right_fd_ < 0) throw errno_error("socket");
+          if (connect(right_fd_, reinterpret_cast<const sockaddr*>(&right),
+                      sizeof(right)) == 0) {
+            return true;
+          }
+          close(right_fd_);
+          right_fd_ = -1;
+          return false;
+        },
+        deadline, "the right neighbour to listen");
+    pollfd pfd{listen_fd, POLLIN, 0};
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - Clock::now());
+    if (poll(&pfd, 1, static_cast<int>(std::max<int64_t>(remaining.count(), 0))) != 1) {
+      throw std::runtime_error(
+          "ProcessGroup: timed out waiting for the left neighbour to connect.");
+    }
+    left_fd_ = accept(listen_fd, nullptr, nullptr);
+    if (left_fd_ < 0) throw errno_error("accept");
+  } catch (...) {
+    close(listen_fd);
+    unlink(path.c_str());
+    throw;
+  }
+  close(listen_fd);
+  unlink(path.c_str());
+}
+
+void SocketProcessGroup::exchange(const void* send, size_t send_bytes, void* recv,
+                                  size_t recv_bytes) {
+  const char* out = static_cast<const char*>(send);
+  char* in = static_cast<char*>(recv);
+  size_t sent = 0;
+  size_t received = 0;
+  while (sent < send_bytes || received < recv_bytes) {
+    pollfd fds[2];
+    nfds_t count = 0;
+    if (sent < send_bytes) fds[count++] = {right_fd_, POLLOUT, 0};
+    if (received < recv_bytes) fds[count++] = {left_fd_, POLLIN, 0};
+    const int ready = poll(fds, count, static_cast<int>(timeout_.count()));
+    if (ready == 0) {
+      throw std::runtime_error("ProcessGroup: timed out waiting for a neighbour.");
+    }
+    if (ready < 0) {
+      if (errno == EINTR) continue;
+      throw errno_error("poll");
+    }
+    if (sent < send_bytes) {
+      const ssize_t k = ::send(right_fd_, out + sent, send_bytes - sent,
+                               MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (k > 0) {
+        sent += static_cast<size_t>(k);
+      } else if (k < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        throw errno_error("send");
+      }
+    }
+    if (received < recv_bytes) {
+      const ssize_t k = ::recv(left_fd_, in + received, recv_bytes - received,
+                               MSG_DONTWAIT);
+      if (k > 0) {
+        received += static_cast<size_t>(k);
+      } else if (k == 0) {
+        throw std::runtime_error("ProcessGroup: left neighbour closed the connection.");
+      } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        throw errno_error("recv");
+      }
+    }
+  }
+}
+
+void SocketProcessGroup::barrier() {
+  // N-1 轮邻居间的令牌交换后，每个进程都间接收到了所有进程的令牌
+  for (int s = 0; s < world_size_ - 1; ++s) {
+    char token = 0;
+    char received = 0;
+    exchange(&token, 1, &received, 1);
+  }
+}
+
+void SocketProcessGroup::all_reduce(std::span<float> data) {
+  const int n = world_size_;
+  if (n == 1) return;
+  ProfileScope scope("process_group.all_reduce");
+  const size_t len = data.size();
+  scratch_.resize(len / n + 1);
+  float* d = data.data();
+  // 与共享内存版本相同的环：第 s 步发出第 rank-s 段，收到左邻居的第 rank-1-s 段
+  for (int s = 0; s < n - 1; ++s) {
+    const auto [sb, se] = segment(len, n, ring_mod(rank_ - s, n));
+    const auto [rb, re] = segment(len, n, ring_mod(rank_ - 1 - s, n));
+    exchange(d + sb, (se - sb) * sizeof(float), scratch_.data(),
+             (re - rb) * sizeof(float));
+    for (size_t k = rb; k < re; ++k) d[k] += scratch_[k - rb];
+  }
+  for (int s = 0; s < n - 1; ++s) {
+    const auto [sb, se] = segment(len, n, ring_mod(rank_ + 1 - s, n));
+    const auto [rb, re] = segment(len, n, ring_mod(rank_ - s, n));
+    exchange(d + sb, (se - sb) * sizeof(float), d + rb, (re - rb) * sizeof(float));
+  }
+  ProfileScope::add_counts(static_cast<double>(len) * (n - 1) / n,
+                           8.0 * len * (n - 1) / n, 4.0 * len);
+}
+
+// world_size 为 1 时不需要任何通信，transport() 返回 Auto
+class LocalProcessGroup : public ProcessGroup {
+ public:
+  LocalProcessGroup() : ProcessGroup(0, 1) {}
+  [[nodiscard]] Transport transport() const override { return Transport::Auto; }
+  void all_reduce(std::span<float>) override {}
+  void barrier() override {}
+};
+
+}  // namespace
+
+std::unique_ptr<ProcessGroup> ProcessGroup::create(
+    const ProcessGroupOptions& options) {
+  if (options.world_size < 1 || options.rank < 0 ||
+      options.rank >= options.world_size) {
+    throw std::invalid_argument("ProcessGroup: invalid rank " +
+                                std::to_string(options.rank) + " for world size " +
+                                std::to_string(options.world_size) + ".");
+  }
+  if (options.capacity == 0) {
+    throw std::invalid_argument("ProcessGroup: capacity must be positive.");
+  }
+  if (options.job_id.empty() ||
+      options.job_id.find('/') != std::string::npos) {
+    throw std::invalid_argument("ProcessGroup: invalid job id '" +
+                                options.job_id + "'.");
+  }
+  if (options.world_size == 1) return std::make_unique<LocalProcessGroup>();
+
+  Transport transport = options.transport;
+  if (transport == Transport::Auto) {
+    transport = shm_available(options) ? Transport::SharedMemory : Transport::Socket;
+  }
+  if (transport == Transport::SharedMemory) {
+    return std::make_unique<ShmProcessGroup>(options);
+  }
+  return std::make_unique<SocketProcessGroup>(options);
+}
+
+int launch_local_ranks(const std::vector<std::string>& args, int world_size) {
+  if (world_size < 1) {
+    throw std::invalid_argument("launch_local_ranks: world_size must be positive.");
+  }
+  char exe[4096];
+  const ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+  if (len < 0) throw errno_error("readlink /proc/self/exe");
+  exe[len] = '\0';
+  const std::string job_id =
+      std::to_string(getpid()) + "-" +
+      std::to_string(Clock::now().time_since_epoch().count());
+
+  std::vector<pid_t> children;
+  for (int rank = 0; rank < world_size; ++rank) {
+    std::vector<std::string> child_args{exe};
+    child_args.insert(child_args.end(), args.begin(), args.end());
+    child_args.insert(child_args.end(),
+                      {"--rank", std::to_string(rank), "--world-size",
+                       std::to_string(world_size), "--job-id", job_id});
+    std::vector<char*> argv;
+    for (auto& a : child_args) argv.push_back(a.data());
+    argv.push_back(nullptr);
+    pid_t pid = 0;
+    if (const int err = posix_spawn(&pid, exe, nullptr, nullptr, argv.data(), environ)) {
+      for (pid_t c : children) kill(c, SIGTERM);
+      for (pid_t c : children) waitpid(c, nullptr, 0);
+      errno = err;
+      throw errno_error("posix_spawn " + std::string(exe));
+    }
+    children.push_back(pid);
+  }
+
+  // 任何一个进程失败，其余进程会卡在集合通信上，直接终止它们
+  int result = 0;
+  for (size_t alive = children.size(); alive > 0; --alive) {
+    int status = 0;
+    const pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        ++alive;
+        continue;
+      }
+      throw errno_error("waitpid");
+    }
+    std::erase(children, pid);
+    const bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if (!ok && result == 0) {
+      result = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+      for (pid_t c : children) kill(c, SIGTERM);
+    }
+  }
+  return result;
+}
+
+LaunchArgs parse_launch_args(int argc, const char* const* argv) {
+  LaunchArgs out;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--nproc" && i + 1 < argc) {
+      out.nproc = std::stoi(argv[++i]);
+    } else {
+      out.forwarded.push_back(arg);
+    }
+  }
+  return out;
+}
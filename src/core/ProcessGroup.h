@@ -0,0 +1,80 @@
+#ifndef PROCESSGROUP_H
+#define PROCESSGROUP_H
+// 同一主机上多个训练进程之间的集合通信。
+//
+// all_reduce 使用环形算法：数据分成 world_size 段，先做 world_size-1 步
+// reduce-scatter（每步把左邻居的一段累加进自己），再做 world_size-1 步
+// all-gather（每步从左邻居拷贝一段已归约完成的数据）。每个进程收发的数据量
+// 约为 2(N-1)/N 份，与进程数基本无关；每一段的求和顺序固定，所有进程得到
+// 逐位相同的结果，参数副本因此不会漂移。
+//
+// 两种传输方式：
+//   SharedMemory：POSIX 共享内存，每个进程一块缓冲区，相邻进程直接读对方的
+//                 缓冲区，步与步之间用共享内存中的原子计数栅栏同步；
+//   Socket：Unix 域套接字，每个进程只与左右邻居各建一条连接。
+// Auto 优先使用共享内存，shm_open / mmap 失败（如容器中没有 /dev/shm）时退回套接字。
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class Transport { Auto, SharedMemory, Socket };
+
+struct ProcessGroupOptions {
+  int rank = 0;
+  int world_size = 1;
+  // 同一组进程必须使用相同的 job_id，用来命名共享内存与套接字文件
+  std::string job_id = "default";
+  Transport transport = Transport::Auto;
+  // 共享内存中每个进程缓冲区的元素数；更大的 all_reduce 会分块进行
+  size_t capacity = size_t{1} << 20;
+  // 等待其他进程（建立连接、栅栏）的最长时间，超时抛出 std::runtime_error
+  std::chrono::milliseconds timeout{30000};
+};
+
+class ProcessGroup {
+ public:
+  virtual ~ProcessGroup() = default;
+
+  ProcessGroup(const ProcessGroup&) = delete;
+  ProcessGroup& operator=(const ProcessGroup&) = delete;
+
+  // 按 options.transport 建立进程组；所有进程都调用后才会返回。
+  // world_size 为 1 时返回不做通信的进程组
+  static std::unique_ptr<ProcessGroup> create(const ProcessGroupOptions& options);
+
+  [[nodiscard]] int rank() const { return rank_; }
+  [[nodiscard]] int world_size() const { return world_size_; }
+  [[nodiscard]] virtual Transport transport() const = 0;
+
+  // 对所有进程的 data 逐元素求和并写回；所有进程必须以相同长度调用
+  virtual void all_reduce(std::span<float> data) = 0;
+  virtual void barrier() = 0;
+
+ protected:
+  ProcessGroup(int rank, int world_size)
+      : rank_(rank), world_size_(world_size) {}
+
+  int rank_;
+  int world_size_;
+};
+
+// 重新启动当前可执行文件 world_size 次，每个子进程的参数为
+// args 加上 --rank i --world-size N --job-id <id>；等待全部退出，
+// 全部成功时返回 0。
+int launch_local_ranks(const std::vector<std::string>& args, int world_size);
+
+// 启动器的命令行：取出 --nproc N，其余参数（包括各选项的值）按原顺序保留，
+// 用于原样转发给 launch_local_ranks
+struct LaunchArgs {
+  int nproc = 1;
+  std::vector<std::string> forwarded;
+};
+LaunchArgs parse_launch_args(int argc, const char* const* argv);
+
+#endif  // !PROCESSGROUP_H
@@ -0,0 +1,230 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+thread_local ProfileScope* tls_scope = nullptr;
+thread_local uint64_t tls_allocs = 0;
+thread_local uint64_t tls_alloc_bytes = 0;
+
+// 轨迹事件上限，避免长时间训练时内存无限增长
+constexpr size_t kMaxEvents = 2'000'000;
+
+// JSON 字符串转义（算子名可能由用户指定）：引号、反斜杠，以及换行等
+// 0x20 以下的控制字符（写成 \u00XX）
+std::string json_escape(const std::string& s) {
+  static const char kHex[] = "0123456789abcdef";
+  std::string out;
+  out.reserve(s.size());
+  for (char c : s) {
+    const auto u = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (u < 0x20) {
+      out += "\\u00";
+      out.push_back(kHex[u >> 4]);
+      out.push_back(kHex[u & 0xF]);
+    } else {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+Profiler::Profiler() : epoch_ns_(now_ns()) {}
+
+Profiler& Profiler::instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+void Profiler::set_enabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.clear();
+  events_.clear();
+  epoch_ns_.store(now_ns(), std::memory_order_relaxed);
+}
+
+void Profiler::note_alloc(size_t bytes) {
+  if (!instance().enabled()) return;
+  ++tls_allocs;
+  tls_alloc_bytes += bytes;
+}
+
+int Profiler::thread_index() {
+  auto id = std::this_thread::get_id();
+  auto it = thread_ids_.find(id);
+  if (it != thread_ids_.end()) return it->second;
+  int index = static_cast<int>(thread_ids_.size());
+  thread_ids_.emplace(id, index);
+  return index;
+}
+
+void Profiler::record(const std::string& name, int64_t start_ns,
+                      int64_t dur_ns, double flops, double bytes_read,
+                      double bytes_written, uint64_t allocs,
+                      uint64_t alloc_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  OpStats& s = stats_[name];
+  s.calls++;
+  s.total_ns += static_cast<double>(dur_ns);
+  s.flops += flops;
+  s.bytes_read += bytes_read;
+  s.bytes_written += bytes_written;
+  s.allocs += allocs;
+  s.alloc_bytes += alloc_bytes;
+  if (events_.size() < kMaxEvents) {
+    events_.push_back({name, start_ns, dur_ns, thread_index(), flops,
+                       bytes_read + bytes_written});
+  }
+}
+
+void Profiler::record_node(const std::string& name) {
+  if (!enabled()) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_[name].nodes++;
+}
+
+std::map<std::string, Profiler::OpStats> Profiler::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void Profiler::print_summary(std::ostream& os) const {
+  auto snapshot = stats();
+  std::vector<std::pair<std::string, OpStats>> rows(snapshot.begin(),
+                                                    snapshot.end());
+  // 按总耗时降序
+  std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+    return a.second.total_ns > b.second.total_ns;
+  });
+
+  os << std::left << std::setw(44) << "op" << std::right << std::setw(10)
+     << "calls" << std::setw(12) << "total ms" << std::setw(10) << "avg us"
+     << std::setw(10) << "GFLOP/s" << std::setw(10) << "GB/s"
+     << std::setw(10) << "allocs" << std::setw(12) << "alloc MB"
+     << std::setw(8) << "nodes" << "\n";
+  os << std::fixed;
+  for (const auto& [name, s] : rows) {
+    if (s.calls == 0) continue;
+    double seconds = s.total_ns * 1e-9;
+    double gflops = seconds > 0 ? s.flops / seconds * 1e-9 : 0.0;
+    double gbps =
+        seconds > 0 ? (s.bytes_read + s.bytes_written) / seconds * 1e-9 : 0.0;
+    os << std::left << std::setw(44) << name << std::right << std::setw(10)
+       << s.calls << std::setw(12) << std::setprecision(2) << s.total_ns * 1e-6
+       << std::setw(10) << std::setprecision(1) << s.total_ns * 1e-3 / s.calls
+       << std::setw(10) << std::setprecision(2) << gflops << std::setw(10)
+       << gbps << std::setw(10) << s.allocs << std::setw(12)
+       << std::setprecision(1) << s.alloc_bytes / (1024.0 * 1024.0)
+       << std::setw(8) << s.nodes << "\n";
+  }
+  os.copyfmt(std::ios(nullptr));
+}
+
+void Profiler::export_chrome_trace(const std::string& path) const {
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    throw std::runtime_error("无法写入性能分析文件: " + path);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < events_.size(); ++i) {
+    const Event& e = events_[i];
+    out << "{\"name\":\"" << json_escape(e.name)
+        << "\",\"cat\":\"op\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.tid
+        << ",\"ts\":" << e.start_ns * 1e-3 << ",\"dur\":" << e.dur_ns * 1e-3
+        << ",\"args\":{\"flops\":" << e.flops << ",\"bytes\":" << e.bytes
+        << "}}" << (i + 1 < events_.size() ? ",\n" : "\n");
+  }
+  out << "]}\n";
+}
+
+ProfileScope::ProfileScope(const char* name) {
+  if (!Profiler::instance().enabled()) return;
+  name_ = name;
+  begin();
+}
+
+ProfileScope::ProfileScope(const std::string& name, const char* suffix) {
+  if (!Profiler::instance().enabled()) return;
+  name_ = name + suffix;
+  begin();
+}
+
+void ProfileScope::begin() {
+  active_ = true;
+  parent_ = tls_scope;
+  tls_scope = this;
+  allocs_start_ = tls_allocs;
+  alloc_bytes_start_ = tls_alloc_bytes;
+  start_ = std::chrono::steady_clock::now();
+}
+
+ProfileScope::~ProfileScope() {
+  if (!active_) return;
+  auto end = std::chrono::steady_clock::now();
+  tls_scope = parent_;
+  Profiler& p = Profiler::instance();
+  // 只读一次零点，开始时间与持续时间基于同一个值
+  const int64_t epoch_ns = p.epoch_ns_.load(std::memory_order_relaxed);
+  auto since_epoch = [epoch_ns](std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               t.time_since_epoch())
+               .count() -
+           epoch_ns;
+  };
+  int64_t start_ns = since_epoch(start_);
+  p.record(name_, start_ns, since_epoch(end) - start_ns, flops_.load(),
+           bytes_read_.load(), bytes_written_.load(),
+           tls_allocs - allocs_start_ + inherited_allocs_.load(),
+           tls_alloc_bytes - alloc_bytes_start_ + inherited_alloc_bytes_.load());
+}
+
+void ProfileScope::add_counts(double flops, double bytes_read,
+                              double bytes_written) {
+  ProfileScope* scope = tls_scope;
+  if (scope == nullptr) return;
+  scope->flops_.fetch_add(flops, std::memory_order_relaxed);
+  scope->bytes_read_.fetch_add(bytes_read, std::memory_order_relaxed);
+  scope->bytes_written_.fetch_add(bytes_written, std::memory_order_relaxed);
+}
+
+ProfileScope* ProfileScope::current() { return tls_scope; }
+
+ProfileScope::Inherit::Inherit(ProfileScope* scope) : scope_(scope) {
+  if (scope_ == nullptr) return;
+  previous_ = tls_scope;
+  tls_scope = scope_;
+  allocs_start_ = tls_allocs;
+  alloc_bytes_start_ = tls_alloc_bytes;
+}
+
+ProfileScope::Inherit::~Inherit() {
+  if (scope_ == nullptr) return;
+  tls_scope = previous_;
+  // 这段时间的分配转给 scope，并从本线程的计数中撤回，
+  // 以免再被本线程外层的范围统计一次
+  const uint64_t allocs = tls_allocs - allocs_start_;
+  const uint64_t bytes = tls_alloc_bytes - alloc_bytes_start_;
+  scope_->inherited_allocs_.fetch_add(allocs, std::memory_order_relaxed);
+  scope_->inherited_alloc_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  tls_allocs = allocs_start_;
+  tls_alloc_bytes = alloc_bytes_start_;
+}
@@ -0,0 +1,131 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+// 可选的逐算子性能分析：记录每个算子(前向与 .backward)的耗时、FLOP 数、
+// 读写字节数以及 Matrix 分配次数，可打印汇总表或导出 Chrome tracing JSON
+// (chrome://tracing 或 https://ui.perfetto.dev 打开)。
+// 未启用时每个插桩点只有一次原子读的开销。
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Profiler {
+ public:
+  struct OpStats {
+    uint64_t calls = 0;
+    double total_ns = 0.0;
+    double flops = 0.0;
+    double bytes_read = 0.0;
+    double bytes_written = 0.0;
+    uint64_t allocs = 0;
+    uint64_t alloc_bytes = 0;
+    uint64_t nodes = 0;  // 由 Graph::make_node 创建的节点数
+  };
+
+  struct Event {
+    std::string name;
+    int64_t start_ns;
+    int64_t dur_ns;
+    int tid;
+    double flops;
+    double bytes;
+  };
+
+  static Profiler& instance();
+
+  void set_enabled(bool enabled);
+  [[nodiscard]] bool enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+  void reset();
+
+  // 由 ProfileScope 在范围结束时调用
+  void record(const std::string& name, int64_t start_ns, int64_t dur_ns,
+              double flops, double bytes_read, double bytes_written,
+              uint64_t allocs, uint64_t alloc_bytes);
+  // 由 Graph::make_node 调用，统计每种算子创建的节点
+  void record_node(const std::string& name);
+
+  [[nodiscard]] std::map<std::string, OpStats> stats() const;
+  void print_summary(std::ostream& os) const;
+  void export_chrome_trace(const std::string& path) const;
+
+  // Matrix 分配缓冲区时调用，计入当前线程的分配计数
+  static void note_alloc(size_t bytes);
+
+ private:
+  friend class ProfileScope;
+  Profiler();
+  int thread_index();
+
+  std::atomic<bool> enabled_{false};
+  // 轨迹时间的零点（steady_clock 纳秒）。reset() 会改写它，
+  // 而记录线程在不持锁的情况下读取，因此是原子量
+  std::atomic<int64_t> epoch_ns_;
+  mutable std::mutex mutex_;
+  std::map<std::string, OpStats> stats_;
+  std::vector<Event> events_;
+  std::map<std::thread::id, int> thread_ids_;
+};
+
+// RAII 计时范围。算子在函数开头创建一个，之后用 add_counts 报告工作量。
+class ProfileScope {
+ public:
+  explicit ProfileScope(const char* name);
+  ProfileScope(const std::string& name, const char* suffix);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+  // 把工作量计入当前线程最内层的范围；没有活动范围时忽略
+  static void add_counts(double flops, double bytes_read,
+                         double bytes_written);
+
+  // 当前线程最内层的活动范围，没有时为 nullptr
+  static ProfileScope* current();
+
+  // 在另一个线程上代为执行某个范围的一部分工作（如 parallel_invoke 交给
+  // 线程池的任务）：存续期间 scope 成为本线程最内层的范围，add_counts 与
+  // 本线程的 Matrix 分配都计入 scope，而不是本线程恰好处在的其他范围。
+  // scope 必须比本对象活得久（提交者等任务结束后才离开范围）
+  class Inherit {
+   public:
+    explicit Inherit(ProfileScope* scope);
+    ~Inherit();
+
+    Inherit(const Inherit&) = delete;
+    Inherit& operator=(const Inherit&) = delete;
+
+   private:
+    ProfileScope* scope_;
+    ProfileScope* previous_ = nullptr;
+    uint64_t allocs_start_ = 0;
+    uint64_t alloc_bytes_start_ = 0;
+  };
+
+ private:
+  void begin();
+
+  bool active_ = false;
+  std::string name_;
+  std::chrono::steady_clock::time_point start_;
+  // 代为执行的线程可能同时累加，因此是原子量
+  std::atomic<double> flops_{0.0};
+  std::atomic<double> bytes_read_{0.0};
+  std::atomic<double> bytes_written_{0.0};
+  uint64_t allocs_start_ = 0;
+  uint64_t alloc_bytes_start_ = 0;
+  // 其他线程代为执行时的分配
+  std::atomic<uint64_t> inherited_allocs_{0};
+  std::atomic<uint64_t> inherited_alloc_bytes_{0};
+  ProfileScope* parent_ = nullptr;
+};
+
+#endif  // !PROFILER_H
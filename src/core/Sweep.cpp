@@ -0,0 +1,176 @@
+#include "Sweep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "Profiler.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+}  // namespace
+
+SweepRunner::SweepRunner(const Features& X, std::span<const int> y,
+                         const Features& X_val, std::span<const int> y_val,
+                         SweepOptions options)
+    : X_(X), y_(y), X_val_(X_val), y_val_(y_val), options_(options) {
+  if (options_.thread_budget < 1) {
+    throw std::invalid_argument("SweepRunner: thread_budget must be positive.");
+  }
+  if (options_.min_epochs < 1 || options_.max_epochs < options_.min_epochs) {
+    throw std::invalid_argument(
+        "SweepRunner: need 1 <= min_epochs <= max_epochs.");
+  }
+  if (options_.eta < 1) {
+    throw std::invalid_argument("SweepRunner: eta must be positive.");
+  }
+  if (X.rows() != static_cast<int>(y.size()) ||
+      X_val.rows() != static_cast<int>(y_val.size())) {
+    throw std::invalid_argument("SweepRunner: feature and label counts differ.");
+  }
+}
+
+int SweepRunner::add(TrainerConfig config) {
+  config.epochs = options_.max_epochs;
+  // 并发的试验不能共用一个检查点文件
+  config.checkpoint_path.clear();
+  config.eval_interval = 0;
+  config.validate();
+  if (config.threads > options_.thread_budget) {
+    throw std::invalid_argument(
+        "SweepRunner: trial needs " + std::to_string(config.threads) +
+        " threads but the budget is " + std::to_string(options_.thread_budget) +
+        ".");
+  }
+  auto trial = std::make_unique<Trial>();
+  trial->result.id = static_cast<int>(trials_.size());
+  trial->result.config = std::move(config);
+  trials_.push_back(std::move(trial));
+  return trials_.back()->result.id;
+}
+
+std::vector<int> SweepRunner::rungs(const SweepOptions& options) {
+  std::vector<int> out;
+  if (options.eta > 1) {
+    for (long long e = options.min_epochs; e < options.max_epochs; e *= options.eta) {
+      out.push_back(static_cast<int>(e));
+    }
+  }
+  out.push_back(options.max_epochs);
+  return out;
+}
+
+std::vector<TrialResult> SweepRunner::run(const ReportCallback& on_report) {
+  std::vector<Trial*> alive;
+  for (auto& t : trials_) alive.push_back(t.get());
+
+  const std::vector<int> schedule = rungs(options_);
+  for (size_t r = 0; r < schedule.size() && !alive.empty(); ++r) {
+    run_rung(alive, schedule[r], on_report);
+    std::erase_if(alive, [](const Trial* t) { return !t->result.error.empty(); });
+    if (r + 1 == schedule.size()) break;
+    // 按验证准确率保留前 1/eta，并列时编号小的优先
+    std::stable_sort(alive.begin(), alive.end(), [](const Trial* a, const Trial* b) {
+      return a->result.accuracy > b->result.accuracy;
+    });
+    const size_t keep =
+        std::max<size_t>(1, (alive.size() + options_.eta - 1) / options_.eta);
+    for (size_t i = keep; i < alive.size(); ++i) {
+      alive[i]->result.stopped = true;
+      alive[i]->trainer.reset();  // 淘汰的试验立即释放参数与优化器状态
+    }
+    alive.resize(std::min(keep, alive.size()));
+    std::sort(alive.begin(), alive.end(), [](const Trial* a, const Trial* b) {
+      return a->result.id < b->result.id;
+    });
+  }
+
+  std::vector<TrialResult> results;
+  for (auto& t : trials_) {
+    t->trainer.reset();
+    results.push_back(t->result);
+  }
+  std::stable_sort(results.begin(), results.end(),
+                   [](const TrialResult& a, const TrialResult& b) {
+                     if (a.error.empty() != b.error.empty()) return a.error.empty();
+                     if (a.epochs != b.epochs) return a.epochs > b.epochs;
+                     return a.accuracy > b.accuracy;
+                   });
+  return results;
+}
+
+void SweepRunner::run_rung(const std::vector<Trial*>& trials, int end_epoch,
+                           const ReportCallback& on_report) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  int free_threads = options_.thread_budget;
+  std::deque<Trial*> finished;
+  std::vector<std::thread> workers;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  // 报告在调用线程上交付，回调不必加锁
+  auto drain = [&] {
+    while (!finished.empty()) {
+      Trial* t = finished.front();
+      finished.pop_front();
+      lock.unlock();
+      if (on_report) on_report(t->result);
+      lock.lock();
+    }
+  };
+  try {
+    for (Trial* trial : trials) {
+      const int need = trial->result.config.threads;
+      // 严格按顺序启动：前一个试验拿到线程之前后面的不插队
+      while (free_threads < need) {
+        cv.wait(lock, [&] { return free_threads >= need || !finished.empty(); });
+        drain();
+      }
+      free_threads -= need;
+      workers.emplace_back([&, trial, need] {
+        advance(*trial, end_epoch);
+        std::lock_guard<std::mutex> guard(mutex);
+        free_threads += need;
+        finished.push_back(trial);
+        cv.notify_all();
+      });
+    }
+    while (free_threads < options_.thread_budget || !finished.empty()) {
+      cv.wait(lock, [&] {
+        return free_threads == options_.thread_budget || !finished.empty();
+      });
+      drain();
+    }
+  } catch (...) {
+    // 回调抛出异常时也要等所有工作线程结束
+    lock.unlock();
+    for (auto& w : workers) w.join();
+    throw;
+  }
+  lock.unlock();
+  for (auto& w : workers) w.join();
+}
+
+void SweepRunner::advance(Trial& trial, int end_epoch) {
+  ProfileScope scope("sweep.trial");
+  TrialResult& result = trial.result;
+  const auto start = Clock::now();
+  try {
+    if (!trial.trainer) trial.trainer = std::make_unique<Trainer>(result.config);
+    const auto history = trial.trainer->fit_until(end_epoch, X_, y_);
+    if (!history.empty()) result.loss = history.back().loss;
+    result.epochs = end_epoch;
+    result.accuracy = trial.trainer->evaluate(X_val_, y_val_).accuracy();
+  } catch (const std::exception& e) {
+    result.error = e.what();
+    trial.trainer.reset();
+  }
+  result.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+}
@@ -0,0 +1,88 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+// 超参数搜索：在同一份只读数据上并发训练多组 TrainerConfig。
+//
+// 数据只加载一次，所有试验以 const 引用共享（训练时各 worker 只按下标读取），
+// 不再像一组独立的 train 进程那样各自解析 CSV、各持一份特征矩阵。
+//
+// 调度采用同步的 successive halving：所有存活的试验先训练到第一档的轮数，
+// 在验证集上评估后只保留前 1/eta 进入下一档，下一档的轮数乘以 eta，
+// 直到 max_epochs。同一档内按加入顺序先到先得地启动试验，同时运行的
+// 各试验 threads 之和不超过 thread_budget；排在前面的试验线程数不够时
+// 后面的也不会插队，因此大配置不会被小配置饿死。每一档所有试验都完成后
+// 才开始下一档，没有试验能跑在别人前面占用预算。
+
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Features.h"
+#include "Trainer.h"
+
+struct SweepOptions {
+  // 同时运行的各试验 threads 之和的上限
+  int thread_budget = 1;
+  // 第一次淘汰前每个试验训练的轮数
+  int min_epochs = 1;
+  // 最后存活的试验训练到的轮数，覆盖各配置中的 epochs
+  int max_epochs = 10;
+  // 每一档保留前 1/eta（至少一个），轮数乘以 eta；1 表示不淘汰，全部训练到 max_epochs
+  int eta = 3;
+};
+
+struct TrialResult {
+  int id = 0;
+  TrainerConfig config;
+  int epochs = 0;          // 已训练的轮数
+  double loss = 0.0;       // 最后一轮的平均训练损失
+  double accuracy = -1.0;  // 最近一次在验证集上的准确率（%）
+  double seconds = 0.0;    // 训练与评估的累计耗时
+  bool stopped = false;    // 在某一档被淘汰
+  std::string error;       // 训练失败的原因，成功时为空
+};
+
+class SweepRunner {
+ public:
+  using ReportCallback = std::function<void(const TrialResult&)>;
+
+  // 特征按值持有（共享存储）；数据必须在 run() 返回前保持有效且不被修改
+  SweepRunner(const Features& X, std::span<const int> y, const Features& X_val,
+              std::span<const int> y_val, SweepOptions options);
+
+  SweepRunner(const SweepRunner&) = delete;
+  SweepRunner& operator=(const SweepRunner&) = delete;
+
+  // 加入一个试验并返回其编号。epochs 由 SweepOptions 决定，
+  // 试验不写检查点、不在训练中评估
+  int add(TrainerConfig config);
+
+  // 运行所有试验。每个试验完成一档后在调用线程上调用 on_report；
+  // 返回按结果排序的列表：存活到最后的在前，其次按准确率从高到低
+  std::vector<TrialResult> run(const ReportCallback& on_report = nullptr);
+
+  // 各档结束时的累计轮数，如 min 1、max 10、eta 3 时为 {1, 3, 9, 10}
+  [[nodiscard]] static std::vector<int> rungs(const SweepOptions& options);
+
+ private:
+  struct Trial {
+    TrialResult result;
+    std::unique_ptr<Trainer> trainer;
+  };
+
+  // 在预算内并发地把 trials 都训练到 end_epoch 并评估
+  void run_rung(const std::vector<Trial*>& trials, int end_epoch,
+                const ReportCallback& on_report);
+  // 在工作线程上训练一个试验，失败时记录原因
+  void advance(Trial& trial, int end_epoch);
+
+  Features X_;
+  std::span<const int> y_;
+  Features X_val_;
+  std::span<const int> y_val_;
+  SweepOptions options_;
+  std::vector<std::unique_ptr<Trial>> trials_;
+};
+
+#endif  // !SWEEP_H
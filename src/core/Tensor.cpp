@@ -0,0 +1,346 @@
+#include "Tensor.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Profiler.h"
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+
+std::string shape_str(const std::vector<int>& shape) {
+  std::string s = "(";
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (i) s += ", ";
+    s += std::to_string(shape[i]);
+  }
+  return s + ")";
+}
+
+// 同时按两组步长遍历同一个形状，内层维度用紧凑循环。
+// f(a_offset, b_offset) 对每个元素调用一次。
+template <typename F>
+void strided_walk(int ndim, const int* shape, const long* a_strides,
+                  const long* b_strides, F f) {
+  if (ndim == 0) {
+    f(0L, 0L);
+    return;
+  }
+  for (int d = 0; d < ndim; ++d) {
+    if (shape[d] == 0) return;
+  }
+  const int inner = ndim - 1;
+  const int inner_n = shape[inner];
+  const long a_in = a_strides[inner];
+  const long b_in = b_strides[inner];
+  std::array<int, Tensor::kMaxDims> idx{};
+  long a_off = 0;
+  long b_off = 0;
+  for (;;) {
+    for (int i = 0; i < inner_n; ++i) f(a_off + i * a_in, b_off + i * b_in);
+    // 进位到外层维度
+    int d = inner - 1;
+    for (; d >= 0; --d) {
+      a_off += a_strides[d];
+      b_off += b_strides[d];
+      if (++idx[d] < shape[d]) break;
+      a_off -= a_strides[d] * shape[d];
+      b_off -= b_strides[d] * shape[d];
+      idx[d] = 0;
+    }
+    if (d < 0) return;
+  }
+}
+
+}  // namespace
+
+// ===================== Storage =====================
+
+Storage::Storage(size_t n, float fill) : Storage(n, Uninitialized{}) {
+  if (n > 0) {
+    if (fill == 0.0f) {
+      std::memset(data_, 0, n * sizeof(float));
+    } else {
+      std::fill(data_, data_ + n, fill);
+    }
+  }
+}
+
+Storage::Storage(size_t n, Uninitialized) : size_(n) {
+  if (n > 0) {
+    // aligned_alloc 要求大小是对齐值的整数倍
+    size_t bytes =
+        (n * sizeof(float) + kAlignment - 1) / kAlignment * kAlignment;
+    data_ = static_cast<float*>(std::aligned_alloc(kAlignment, bytes));
+    if (data_ == nullptr) throw std::bad_alloc();
+  }
+  Profiler::note_alloc(n * sizeof(float));
+}
+
+Storage::Storage(float* external, size_t n, std::function<void()> release)
+    : data_(external), size_(n), release_(std::move(release)) {}
+
+Storage::~Storage() {
+  if (release_) {
+    release_();
+  } else {
+    std::free(data_);
+  }
+}
+
+// ===================== Tensor =====================
+
+Tensor::Tensor() : ndim_(1) {
+  shape_[0] = 0;
+  strides_[0] = 1;
+}
+
+Tensor::Tensor(const std::vector<int>& shape, float fill) {
+  allocate(shape.data(), static_cast<int>(shape.size()), &fill);
+}
+
+void Tensor::allocate(const int* shape, int ndim, const float* fill) {
+  if (ndim < 1 || ndim > kMaxDims) {
+    throw std::invalid_argument("Tensor: rank must be in [1, " +
+                                std::to_string(kMaxDims) + "], got " +
+                                std::to_string(ndim) + ".");
+  }
+  ndim_ = ndim;
+  long n = 1;
+  for (int d = 0; d < ndim_; ++d) {
+    if (shape[d] < 0) {
+      throw std::invalid_argument("Tensor: negative dimension " +
+                                  std::to_string(shape[d]) + ".");
+    }
+    shape_[d] = shape[d];
+    n *= shape[d];
+  }
+  set_contiguous_strides();
+  offset_ = 0;
+  if (fill != nullptr) {
+    storage_ = std::make_shared<Storage>(static_cast<size_t>(n), *fill);
+  } else {
+    storage_ = std::make_shared<Storage>(static_cast<size_t>(n),
+                                         Storage::Uninitialized{});
+  }
+}
+
+Tensor::Tensor(std::shared_ptr<Storage> storage, const std::vector<int>& shape,
+               const std::vector<long>& strides, long offset)
+    : storage_(std::move(storage)), offset_(offset) {
+  if (shape.empty() || shape.size() > kMaxDims ||
+      strides.size() != shape.size()) {
+    throw std::invalid_argument("Tensor: invalid view shape " +
+                                shape_str(shape) + ".");
+  }
+  ndim_ = static_cast<int>(shape.size());
+  for (int d = 0; d < ndim_; ++d) {
+    shape_[d] = shape[d];
+    strides_[d] = strides[d];
+  }
+}
+
+void Tensor::set_contiguous_strides() {
+  long s = 1;
+  for (int d = ndim_ - 1; d >= 0; --d) {
+    strides_[d] = s;
+    s *= shape_[d];
+  }
+}
+
+int Tensor::size(int d) const {
+  if (d < 0) d += ndim_;
+  if (d < 0 || d >= ndim_) throw std::out_of_range("Tensor::size 维度越界");
+  return shape_[d];
+}
+
+long Tensor::stride(int d) const {
+  if (d < 0) d += ndim_;
+  if (d < 0 || d >= ndim_) throw std::out_of_range("Tensor::stride 维度越界");
+  return strides_[d];
+}
+
+long Tensor::numel() const {
+  long n = 1;
+  for (int d = 0; d < ndim_; ++d) n *= shape_[d];
+  return n;
+}
+
+std::vector<int> Tensor::shape() const {
+  return std::vector<int>(shape_.begin(), shape_.begin() + ndim_);
+}
+
+std::vector<long> Tensor::strides() const {
+  return std::vector<long>(strides_.begin(), strides_.begin() + ndim_);
+}
+
+bool Tensor::is_contiguous() const {
+  long expected = 1;
+  for (int d = ndim_ - 1; d >= 0; --d) {
+    // 长度为 1 的维度步长无关紧要
+    if (shape_[d] != 1 && strides_[d] != expected) return false;
+    expected *= shape_[d];
+  }
+  return true;
+}
+
+float& Tensor::at(std::initializer_list<int> index) {
+  return const_cast<float&>(std::as_const(*this).at(index));
+}
+
+const float& Tensor::at(std::initializer_list<int> index) const {
+  if (static_cast<int>(index.size()) != ndim_) {
+    throw std::invalid_argument("Tensor::at: expected " +
+                                std::to_string(ndim_) + " indices.");
+  }
+  long off = 0;
+  int d = 0;
+  for (int i : index) {
+    if (i < 0 || i >= shape_[d]) throw std::out_of_range("Tensor::at 访问越界");
+    off += i * strides_[d];
+    ++d;
+  }
+  return data()[off];
+}
+
+Tensor Tensor::reshape(const std::vector<int>& shape) const {
+  std::vector<int> target = shape;
+  long known = 1;
+  int infer = -1;
+  for (size_t d = 0; d < target.size(); ++d) {
+    if (target[d] == -1) {
+      if (infer != -1) {
+        throw std::invalid_argument("Tensor::reshape: only one -1 allowed.");
+      }
+      infer = static_cast<int>(d);
+    } else {
+      known *= target[d];
+    }
+  }
+  if (infer != -1 && known != 0) target[infer] = static_cast<int>(numel() / known);
+  long n = 1;
+  for (int s : target) n *= s;
+  if (n != numel()) {
+    throw std::invalid_argument("Tensor::reshape: cannot view " +
+                                shape_str(this->shape()) + " as " +
+                                shape_str(target) + ".");
+  }
+
+  Tensor src = contiguous();
+  std::vector<long> strides(target.size());
+  long s = 1;
+  for (int d = static_cast<int>(target.size()) - 1; d >= 0; --d) {
+    strides[d] = s;
+    s *= target[d];
+  }
+  return Tensor(src.storage_, target, strides, src.offset_);
+}
+
+Tensor Tensor::permute(const std::vector<int>& dims) const {
+  if (static_cast<int>(dims.size()) != ndim_) {
+    throw std::invalid_argument("Tensor::permute: expected " +
+                                std::to_string(ndim_) + " dims.");
+  }
+  std::vector<int> shape(ndim_);
+  std::vector<long> strides(ndim_);
+  std::array<bool, kMaxDims> used{};
+  for (int i = 0; i < ndim_; ++i) {
+    int d = dims[i];
+    if (d < 0 || d >= ndim_ || used[d]) {
+      throw std::invalid_argument("Tensor::permute: invalid permutation.");
+    }
+    used[d] = true;
+    shape[i] = shape_[d];
+    strides[i] = strides_[d];
+  }
+  return Tensor(storage_, shape, strides, offset_);
+}
+
+Tensor Tensor::transpose(int d0, int d1) const {
+  std::vector<int> dims(ndim_);
+  for (int i = 0; i < ndim_; ++i) dims[i] = i;
+  if (d0 < 0) d0 += ndim_;
+  if (d1 < 0) d1 += ndim_;
+  if (d0 < 0 || d0 >= ndim_ || d1 < 0 || d1 >= ndim_) {
+    throw std::out_of_range("Tensor::transpose 维度越界");
+  }
+  std::swap(dims[d0], dims[d1]);
+  return permute(dims);
+}
+
+Tensor Tensor::slice(int dim, int start, int end, int step) const {
+  if (dim < 0) dim += ndim_;
+  if (dim < 0 || dim >= ndim_) throw std::out_of_range("Tensor::slice 维度越界");
+  if (step <= 0) throw std::invalid_argument("Tensor::slice: step must be > 0.");
+  start = std::clamp(start, 0, shape_[dim]);
+  end = std::clamp(end, start, shape_[dim]);
+  std::vector<int> shape = this->shape();
+  std::vector<long> strides = this->strides();
+  shape[dim] = (end - start + step - 1) / step;
+  strides[dim] = strides_[dim] * step;
+  return Tensor(storage_, shape, strides, offset_ + start * strides_[dim]);
+}
+
+Tensor Tensor::expand(const std::vector<int>& shape) const {
+  const int n = static_cast<int>(shape.size());
+  if (n < ndim_ || n > kMaxDims) {
+    throw std::invalid_argument("Tensor::expand: cannot expand " +
+                                shape_str(this->shape()) + " to " +
+                                shape_str(shape) + ".");
+  }
+  std::vector<long> strides(n, 0);
+  // 右对齐比较，与 NumPy 广播规则一致
+  for (int i = 0; i < n; ++i) {
+    int src = i - (n - ndim_);
+    if (src < 0) continue;  // 新增的前导维度，步长为 0
+    if (shape_[src] == shape[i]) {
+      strides[i] = strides_[src];
+    } else if (shape_[src] != 1) {
+      throw std::invalid_argument("Tensor::expand: cannot expand " +
+                                  shape_str(this->shape()) + " to " +
+                                  shape_str(shape) + ".");
+    }
+  }
+  return Tensor(storage_, shape, strides, offset_);
+}
+
+Tensor Tensor::contiguous() const {
+  if (is_contiguous()) return *this;
+  return clone();
+}
+
+Tensor Tensor::clone() const {
+  Tensor out(shape());
+  out.copy_from(*this);
+  return out;
+}
+
+void Tensor::copy_from(const Tensor& src) {
+  const Tensor s = src.shape() == shape() ? src : src.expand(shape());
+  float* dst = data();
+  const float* sp = s.data();
+  if (is_contiguous() && s.is_contiguous()) {
+    std::memcpy(dst, sp, numel() * sizeof(float));
+    return;
+  }
+  strided_walk(ndim_, shape_.data(), strides_.data(), s.strides_.data(),
+               [dst, sp](long a, long b) { dst[a] = sp[b]; });
+}
+
+void Tensor::fill(float value) {
+  float* dst = data();
+  strided_walk(ndim_, shape_.data(), strides_.data(), strides_.data(),
+               [dst, value](long a, long) { dst[a] = value; });
+}
+
+void Tensor::for_each(const std::function<void(float&)>& f) {
+  float* dst = data();
+  strided_walk(ndim_, shape_.data(), strides_.data(), strides_.data(),
+               [dst, &f](long a, long) { f(dst[a]); });
+}
@@ -0,0 +1,109 @@
+#ifndef TENSOR_H
+#define TENSOR_H
+// N 维带步长(strided)张量：shape + strides + offset 描述一块共享存储上的视图。
+// reshape / permute / slice / expand 都只改变视图参数，不拷贝数据；
+// expand 用步长 0 实现广播。Matrix 是它的二维、行主序连续的特化。
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+// 64 字节对齐的连续 float 缓冲区，可被多个 Tensor 视图共享。
+// 也可以包装外部内存（例如 mmap 得到的只读数据），由 release 负责释放。
+class Storage {
+ public:
+  // 分配但不初始化（调用者马上会整体写入时使用）
+  struct Uninitialized {};
+
+ private:
+  float* data_ = nullptr;
+  size_t size_ = 0;
+  std::function<void()> release_;
+
+ public:
+  explicit Storage(size_t n, float fill = 0.0f);
+  Storage(size_t n, Uninitialized);
+  Storage(float* external, size_t n, std::function<void()> release);
+  ~Storage();
+
+  Storage(const Storage&) = delete;
+  Storage& operator=(const Storage&) = delete;
+
+  float* data() { return data_; }
+  const float* data() const { return data_; }
+  [[nodiscard]] size_t size() const { return size_; }
+};
+
+class Tensor {
+ public:
+  static constexpr int kMaxDims = 6;
+
+ protected:
+  std::shared_ptr<Storage> storage_;
+  int ndim_ = 0;
+  std::array<int, kMaxDims> shape_{};
+  std::array<long, kMaxDims> strides_{};
+  long offset_ = 0;
+
+  void set_contiguous_strides();
+  // 按给定形状分配新的连续存储；fill 为空时不初始化
+  void allocate(const int* shape, int ndim, const float* fill);
+
+ public:
+  // 空张量，shape 为 {0}
+  Tensor();
+  explicit Tensor(const std::vector<int>& shape, float fill = 0.0f);
+  // 在已有存储上构造视图，调用者保证所有下标都落在存储范围内
+  Tensor(std::shared_ptr<Storage> storage, const std::vector<int>& shape,
+         const std::vector<long>& strides, long offset);
+
+  [[nodiscard]] int dim() const { return ndim_; }
+  [[nodiscard]] int size(int d) const;
+  [[nodiscard]] long stride(int d) const;
+  [[nodiscard]] long numel() const;
+  [[nodiscard]] std::vector<int> shape() const;
+  [[nodiscard]] std::vector<long> strides() const;
+  [[nodiscard]] long offset() const { return offset_; }
+  [[nodiscard]] bool is_contiguous() const;
+  [[nodiscard]] const std::shared_ptr<Storage>& storage() const {
+    return storage_;
+  }
+  [[nodiscard]] bool shares_storage_with(const Tensor& other) const {
+    return storage_ != nullptr && storage_ == other.storage_;
+  }
+
+  // 指向视图第一个元素（offset 处）
+  float* data() { return storage_ ? storage_->data() + offset_ : nullptr; }
+  const float* data() const {
+    return storage_ ? storage_->data() + offset_ : nullptr;
+  }
+
+  float& at(std::initializer_list<int> index);
+  const float& at(std::initializer_list<int> index) const;
+
+  // --- 零拷贝视图 ---
+  // 连续时只改变 shape/strides，否则先拷贝成连续再 reshape。允许一个 -1。
+  Tensor reshape(const std::vector<int>& shape) const;
+  Tensor permute(const std::vector<int>& dims) const;
+  Tensor transpose(int d0, int d1) const;
+  // [start, end) 按 step 取子区间
+  Tensor slice(int dim, int start, int end, int step = 1) const;
+  // 广播：大小为 1 的维度以步长 0 扩展，也可以在前面补新维度
+  Tensor expand(const std::vector<int>& shape) const;
+
+  // --- 拷贝 ---
+  // 已连续时返回共享存储的自身，否则拷贝到新的连续存储
+  Tensor contiguous() const;
+  Tensor clone() const;
+  // 逐元素把 src 拷贝进当前视图，src 可以按广播规则扩展
+  void copy_from(const Tensor& src);
+  void fill(float value);
+
+  // 按行主序逐个访问元素（对任意步长都正确）
+  void for_each(const std::function<void(float&)>& f);
+};
+
+#endif  // !TENSOR_H
@@ -0,0 +1,108 @@
+#include "ThreadPool.h"
+
+#include <exception>
+#include <utility>
+
+#include "Profiler.h"
+
+namespace {
+thread_local ThreadPool* tls_current_pool = nullptr;
+}
+
+ThreadPool::ThreadPool(int num_threads) {
+  if (num_threads < 1) num_threads = 1;
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this]() { worker_loop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : workers_) t.join();
+}
+
+void ThreadPool::worker_loop() {
+  tls_current_pool = this;
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (stop_ && tasks_.empty()) return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+bool ThreadPool::run_pending_task() {
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.empty()) return false;
+    task = std::move(tasks_.front());
+    tasks_.pop_front();
+  }
+  task();
+  return true;
+}
+
+void ThreadPool::help_until(const std::function<bool()>& done) {
+  ThreadPool* previous = tls_current_pool;
+  tls_current_pool = this;
+  while (!done()) {
+    if (!run_pending_task()) std::this_thread::yield();
+  }
+  tls_current_pool = previous;
+}
+
+ThreadPool* ThreadPool::current() { return tls_current_pool; }
+
+void parallel_invoke(const std::function<void()>& a,
+                     const std::function<void()>& b) {
+  ThreadPool* pool = ThreadPool::current();
+  if (pool == nullptr) {
+    a();
+    b();
+    return;
+  }
+
+  std::atomic<bool> a_done{false};
+  std::exception_ptr a_error;
+  // a 报告的工作量计入调用者所在的范围，而不是执行它的工作线程当时的范围
+  ProfileScope* scope = ProfileScope::current();
+  pool->submit([&]() {
+    ProfileScope::Inherit inherit(scope);
+    try {
+      a();
+    } catch (...) {
+      a_error = std::current_exception();
+    }
+    a_done.store(true, std::memory_order_release);
+  });
+  // b 抛出异常时也必须等 a 结束，否则 a 会访问已经销毁的局部变量
+  std::exception_ptr b_error;
+  try {
+    b();
+  } catch (...) {
+    b_error = std::current_exception();
+  }
+  pool->help_until(
+      [&]() { return a_done.load(std::memory_order_acquire); });
+  if (a_error) std::rethrow_exception(a_error);
+  if (b_error) std::rethrow_exception(b_error);
+}
@@ -0,0 +1,49 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 简单的固定大小线程池。
+// 等待中的线程可以通过 help_until() 帮忙执行排队的任务，
+// 因此任务内部再提交子任务并等待（嵌套并行）也不会死锁。
+class ThreadPool {
+ private:
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+
+  void worker_loop();
+
+ public:
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  [[nodiscard]] int size() const { return static_cast<int>(workers_.size()); }
+
+  void submit(std::function<void()> task);
+
+  // 在当前线程执行一个排队中的任务，队列为空时返回 false。
+  bool run_pending_task();
+
+  // 一边帮忙执行任务一边等待，直到 done() 为真。
+  void help_until(const std::function<bool()>& done);
+
+  // 当前线程所在的线程池（工作线程或正在 help_until 的线程），否则为 nullptr。
+  static ThreadPool* current();
+};
+
+// 若当前线程处于某个线程池中，则并发执行 a 与 b，否则顺序执行。
+void parallel_invoke(const std::function<void()>& a,
+                     const std::function<void()>& b);
+
+#endif  // !THREADPOOL_H
@@ -0,0 +1,526 @@
+#include "Trainer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "CsvDataSet.h"
+#include "Profiler.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::invalid_argument bad_value(const std::string& key, const std::string& value) {
+  return std::invalid_argument("TrainerConfig: invalid value '" + value +
+                               "' for " + key + ".");
+}
+
+int parse_int(const std::string& key, const std::string& value) {
+  try {
+    size_t pos = 0;
+    const int v = std::stoi(value, &pos);
+    if (pos == value.size()) return v;
+  } catch (const std::logic_error&) {
+  }
+  throw bad_value(key, value);
+}
+
+float parse_float(const std::string& key, const std::string& value) {
+  try {
+    size_t pos = 0;
+    const float v = std::stof(value, &pos);
+    if (pos == value.size()) return v;
+  } catch (const std::logic_error&) {
+  }
+  throw bad_value(key, value);
+}
+
+bool parse_bool(const std::string& key, const std::string& value) {
+  if (value == "true" || value == "1" || value == "yes") return true;
+  if (value == "false" || value == "0" || value == "no") return false;
+  throw bad_value(key, value);
+}
+
+// "784-128-10" 或 "784,128,10"
+std::vector<int> parse_layers(const std::string& key, const std::string& value) {
+  std::vector<int> layers;
+  std::string item;
+  std::istringstream in(value);
+  while (std::getline(in, item, value.find(',') != std::string::npos ? ',' : '-')) {
+    layers.push_back(parse_int(key, item));
+  }
+  return layers;
+}
+
+const char* activation_name(Activation a) {
+  switch (a) {
+    case Activation::None: return "none";
+    case Activation::Relu: return "relu";
+    case Activation::Sigmoid: return "sigmoid";
+    case Activation::Tanh: return "tanh";
+  }
+  return "?";
+}
+
+std::string trim(const std::string& s) {
+  const auto begin = s.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) return "";
+  return s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  Matrix m(rows, cols);
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<> distr(-0.5, 0.5);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m(i, j) = static_cast<float>(distr(gen));
+    }
+  }
+  return m;
+}
+
+}  // namespace
+
+void TrainerConfig::set(const std::string& raw_key, const std::string& value) {
+  std::string key = raw_key;
+  std::replace(key.begin(), key.end(), '-', '_');
+  if (key == "train_path") {
+    train_path = value;
+  } else if (key == "test_path") {
+    test_path = value;
+  } else if (key == "save_path") {
+    save_path = value;
+  } else if (key == "layers") {
+    layers = parse_layers(key, value);
+  } else if (key == "activation") {
+    if (value == "none") activation = Activation::None;
+    else if (value == "relu") activation = Activation::Relu;
+    else if (value == "sigmoid") activation = Activation::Sigmoid;
+    else if (value == "tanh") activation = Activation::Tanh;
+    else throw bad_value(key, value);
+  } else if (key == "precision") {
+    if (value == "fp32") precision = Precision::FP32;
+    else if (value == "bf16") precision = Precision::BF16;
+    else throw bad_value(key, value);
+  } else if (key == "epochs") {
+    epochs = parse_int(key, value);
+  } else if (key == "batch_size") {
+    batch_size = parse_int(key, value);
+  } else if (key == "threads") {
+    threads = parse_int(key, value);
+  } else if (key == "mode") {
+    if (value == "sync") hogwild = false;
+    else if (value == "hogwild") hogwild = true;
+    else throw bad_value(key, value);
+  } else if (key == "init_seed") {
+    init_seed = static_cast<unsigned>(parse_int(key, value));
+  } else if (key == "shuffle_seed") {
+    shuffle_seed = static_cast<unsigned>(parse_int(key, value));
+  } else if (key == "optimizer") {
+    optimizer = value;
+  } else if (key == "learning_rate" || key == "lr") {
+    learning_rate = parse_float(key, value);
+  } else if (key == "momentum") {
+    momentum = parse_float(key, value);
+  } else if (key == "nesterov") {
+    nesterov = parse_bool(key, value);
+  } else if (key == "weight_decay") {
+    weight_decay = parse_float(key, value);
+  } else if (key == "eval_interval") {
+    eval_interval = parse_int(key, value);
+  } else if (key == "eval_batch_size") {
+    eval_batch_size = parse_int(key, value);
+  } else if (key == "eval_async") {
+    eval_async = parse_bool(key, value);
+  } else if (key == "checkpoint_path") {
+    checkpoint_path = value;
+  } else if (key == "checkpoint_every") {
+    checkpoint_every = parse_int(key, value);
+  } else {
+    throw std::invalid_argument("TrainerConfig: unknown option '" + raw_key + "'.");
+  }
+}
+
+void TrainerConfig::load_file(const std::string& path) {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    throw std::runtime_error("无法打开配置文件: " + path);
+  }
+  std::string line;
+  int line_no = 0;
+  while (std::getline(in, line)) {
+    ++line_no;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) continue;
+    const auto eq = line.find('=');
+    if (eq == std::string::npos) {
+      throw std::invalid_argument("TrainerConfig: " + path + ":" +
+                                  std::to_string(line_no) +
+                                  ": expected 'key = value'.");
+    }
+    set(trim(line.substr(0, eq)), trim(line.substr(eq + 1)));
+  }
+}
+
+void TrainerConfig::validate() const {
+  auto fail = [](const std::string& what) {
+    throw std::invalid_argument("TrainerConfig: " + what);
+  };
+  if (layers.size() < 2) fail("layers needs at least an input and an output size.");
+  for (int width : layers) {
+    if (width < 1) fail("layer sizes must be positive.");
+  }
+  if (epochs < 1) fail("epochs must be positive.");
+  if (batch_size < 1) fail("batch_size must be positive.");
+  if (threads < 1) fail("threads must be positive.");
+  if (eval_interval < 0) fail("eval_interval must not be negative.");
+  if (eval_batch_size < 1) fail("eval_batch_size must be positive.");
+  if (checkpoint_every < 0) fail("checkpoint_every must not be negative.");
+  if (!(learning_rate > 0.0f)) fail("learning_rate must be positive.");
+  if (momentum < 0.0f || momentum >= 1.0f) fail("momentum must be in [0, 1).");
+  if (weight_decay < 0.0f) fail("weight_decay must not be negative.");
+  if (optimizer != "sgd" && optimizer != "adam" && optimizer != "adamw") {
+    fail("unknown optimizer '" + optimizer + "' (expected sgd, adam or adamw).");
+  }
+  if (hogwild && (optimizer != "sgd" || momentum > 0.0f || weight_decay > 0.0f)) {
+    fail("hogwild only supports plain SGD without momentum or weight decay.");
+  }
+}
+
+std::string TrainerConfig::summary() const {
+  std::ostringstream out;
+  out << "layers=";
+  for (size_t i = 0; i < layers.size(); ++i) {
+    out << (i ? "-" : "") << layers[i];
+  }
+  out << " activation=" << activation_name(activation)
+      << " precision=" << (precision == Precision::BF16 ? "bf16" : "fp32")
+      << " optimizer=" << optimizer << " lr=" << learning_rate;
+  if (momentum > 0.0f) out << " momentum=" << momentum << (nesterov ? " (nesterov)" : "");
+  if (weight_decay > 0.0f) out << " weight_decay=" << weight_decay;
+  out << " batch_size=" << batch_size << " epochs=" << epochs
+      << " threads=" << threads << (hogwild ? " hogwild" : "");
+  return out.str();
+}
+
+Trainer::Trainer(TrainerConfig config, ProcessGroup* group)
+    : config_(std::move(config)), group_(group) {
+  config_.validate();
+  if (config_.hogwild && world_size() > 1) {
+    throw std::invalid_argument(
+        "Trainer: hogwild cannot be combined with multi-process training.");
+  }
+  const std::vector<int>& layers = config_.layers;
+  for (size_t l = 0; l + 1 < layers.size(); ++l) {
+    const bool output = l + 2 == layers.size();
+    const std::string id = std::to_string(l + 1);
+    params_.push_back(graph_.make_node(
+        random_matrix(layers[l], layers[l + 1], config_.init_seed), "W" + id));
+    params_.push_back(graph_.make_node(
+        Matrix(1, layers[l + 1], output ? 0.0f : 0.01f), "b" + id));
+  }
+  // 参数与梯度打包进连续缓冲区，清零与更新各是一次线性遍历
+  store_ = std::make_unique<ParameterStore>(params_);
+  // bf16 权重副本只在同步更新之后刷新；Hogwild 随时在改权重，
+  // 因此仍由 dense 在每次调用时转换
+  if (config_.precision == Precision::BF16 && !config_.hogwild) {
+    store_->enable_bf16();
+  }
+  evaluator_ = std::make_unique<Evaluator>(config_.activation, config_.precision,
+                                           config_.eval_batch_size);
+  // 各进程参数逐位相同，只由 0 号进程写检查点
+  if (!config_.checkpoint_path.empty() && rank() == 0) {
+    writer_ = std::make_unique<CheckpointWriter>(config_.checkpoint_path);
+  }
+  const float lr = config_.learning_rate;
+  if (config_.optimizer == "sgd") {
+    optimizer_ = std::make_unique<SGD>(*store_, lr, config_.momentum,
+                                       config_.nesterov, config_.weight_decay);
+  } else if (config_.optimizer == "adam") {
+    optimizer_ = std::make_unique<Adam>(*store_, lr, 0.9f, 0.999f, 1e-8f,
+                                        config_.weight_decay);
+  } else {
+    optimizer_ = std::make_unique<AdamW>(*store_, lr, 0.9f, 0.999f, 1e-8f,
+                                         config_.weight_decay);
+  }
+
+  // 每个 worker 在自己的图副本上计算分到的样本，损失与 softmax 保持 fp32
+  auto loss_fn = [this](Graph& graph, const std::vector<std::shared_ptr<Node>>& p,
+                        std::span<const int> shard) {
+    const auto t0 = Clock::now();
+    const Features& X = *X_;
+    const int rows = static_cast<int>(shard.size());
+    const int cols = X.cols();
+    std::vector<int> labels(shard.size());
+    for (size_t i = 0; i < shard.size(); ++i) labels[i] = y_[shard[i]];
+    std::shared_ptr<Node> x;
+    if (config_.precision == Precision::BF16) {
+      // 批次直接收集成 bf16，不经过 fp32 的中间矩阵。上一步的图释放后
+      // 缓冲区只剩这里的引用，本线程下一步原地复用
+      thread_local std::shared_ptr<BF16Matrix> input16;
+      if (!input16 || input16.use_count() > 1) {
+        input16 = std::make_shared<BF16Matrix>();
+      }
+      input16->resize(rows, cols);
+      X.gather(shard, input16->data.data());
+      x = graph.make_node(input16, {}, "X_batch");
+    } else {
+      Matrix batch = Matrix::uninitialized(rows, cols);
+      X.gather(shard, batch.get_data_ptr());
+      x = graph.make_node(std::move(batch), "X_batch");
+    }
+    data_ns_.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0)
+            .count(),
+        std::memory_order_relaxed);
+    return sparse_softmax_cross_entropy_loss(graph, forward(graph, p, x), labels);
+  };
+  if (config_.hogwild) {
+    hogwild_ = std::make_unique<HogwildTrainer>(*store_, config_.threads, lr,
+                                                std::move(loss_fn));
+    return;
+  }
+  sync_ = std::make_unique<DataParallelTrainer>(*store_, *optimizer_,
+                                                config_.threads, std::move(loss_fn));
+  if (world_size() > 1) {
+    // 各进程的梯度按分片比例加权后求和，即全局批次的平均梯度
+    sync_->set_gradient_hook([this](std::span<float> grads) {
+      for (float& g : grads) g *= process_scale_;
+      group_->all_reduce(grads);
+    });
+  }
+}
+
+std::shared_ptr<Node> Trainer::forward(
+    Graph& graph, const std::vector<std::shared_ptr<Node>>& p,
+    std::shared_ptr<Node> x) const {
+  const size_t num_layers = p.size() / 2;
+  for (size_t l = 0; l < num_layers; ++l) {
+    const bool output = l + 1 == num_layers;
+    // bf16 时隐藏层的激活只以 bf16 保存，logits 以 fp32 交给损失
+    x = dense(graph, x, p[2 * l], p[2 * l + 1],
+              output ? Activation::None : config_.activation, config_.precision,
+              output ? Precision::FP32 : config_.precision);
+  }
+  return x;
+}
+
+std::vector<EpochStats> Trainer::fit(const Features& X, std::span<const int> y,
+                                     const Features* X_test,
+                                     std::span<const int> y_test,
+                                     const EpochCallback& on_epoch) {
+  return fit_until(config_.epochs, X, y, X_test, y_test, on_epoch);
+}
+
+std::vector<EpochStats> Trainer::fit_until(int end_epoch, const Features& X,
+                                           std::span<const int> y,
+                                           const Features* X_test,
+                                           std::span<const int> y_test,
+                                           const EpochCallback& on_epoch) {
+  if (X.rows() != static_cast<int>(y.size())) {
+    throw std::invalid_argument("Trainer::fit: feature and label counts differ.");
+  }
+  if (X.cols() != config_.layers.front()) {
+    throw std::invalid_argument(
+        "Trainer::fit: data has " + std::to_string(X.cols()) +
+        " features but the model expects " +
+        std::to_string(config_.layers.front()) + ".");
+  }
+  const int num_samples = X.rows();
+  const int batch_size = config_.batch_size;
+  const int steps_per_epoch = (num_samples + batch_size - 1) / batch_size;
+  const int rank = this->rank();
+  const int world = world_size();
+
+  int first_epoch = 0;
+  int first_step = 0;
+  double carried_loss = 0.0;
+  if (resumed_) {
+    if (resumed_->order.size() != static_cast<size_t>(num_samples)) {
+      throw std::invalid_argument(
+          "Trainer::fit: checkpoint was written for " +
+          std::to_string(resumed_->order.size()) + " samples, data has " +
+          std::to_string(num_samples) + ".");
+    }
+    first_epoch = resumed_->epoch;
+    first_step = resumed_->step;
+    // 多进程时检查点里是所有进程之和，只计入一次
+    if (rank == 0) carried_loss = resumed_->epoch_loss;
+    order_ = std::move(resumed_->order);
+    resumed_.reset();
+  } else {
+    order_.resize(num_samples);
+    std::iota(order_.begin(), order_.end(), 0);
+    // 所有进程使用相同的种子，因此每轮得到相同的打乱顺序
+    rng_.seed(config_.shuffle_seed);
+  }
+  X_ = &X;
+  y_ = y;
+  std::vector<EpochStats> history;
+  auto deliver = [&](const EpochStats& s) {
+    history.push_back(s);
+    if (on_epoch) on_epoch(s);
+  };
+  // 后台评估中的那一轮，结果到达后才交付
+  std::future<EvalResult> pending_eval;
+  EpochStats pending_stats;
+  auto finish_pending = [&] {
+    if (!pending_eval.valid()) return;
+    pending_stats.accuracy = pending_eval.get().accuracy();
+    deliver(pending_stats);
+  };
+
+  const int last_epoch = std::min(end_epoch, config_.epochs);
+  for (int epoch = first_epoch; epoch < last_epoch; ++epoch) {
+    // 从轮中间恢复时沿用检查点中的顺序
+    const int step_begin = epoch == first_epoch ? first_step : 0;
+    if (step_begin == 0) std::shuffle(order_.begin(), order_.end(), rng_);
+    data_ns_.store(0, std::memory_order_relaxed);
+    const auto epoch_start = Clock::now();
+    EpochStats stats;
+    stats.epoch = epoch;
+    stats.steps = steps_per_epoch;
+    int executed = steps_per_epoch - step_begin;
+    int samples = num_samples - std::min(num_samples, step_begin * batch_size);
+
+    if (hogwild_) {
+      // 每个线程自行领取批次并直接更新共享参数，整轮结束才汇合
+      stats.loss = hogwild_->run_epoch(order_, batch_size);
+      executed = steps_per_epoch;
+      samples = num_samples;
+    } else {
+      double epoch_loss = step_begin > 0 ? carried_loss : 0.0;
+      for (int step = step_begin; step < steps_per_epoch; ++step) {
+        ProfileScope step_scope("train_step");
+        const int start = step * batch_size;
+        // 全局批次按进程均分，前 extra 个进程多一个样本
+        const int len = std::min(batch_size, num_samples - start);
+        const int base = len / world;
+        const int extra = len % world;
+        const int begin = start + rank * base + std::min(rank, extra);
+        const int shard = base + (rank < extra ? 1 : 0);
+        process_scale_ = static_cast<float>(shard) / static_cast<float>(len);
+        // 各 worker 的梯度归约进共享梯度后做一次更新；
+        // 更新作用在 fp32 主权重上，随后刷新 bf16 副本
+        epoch_loss += process_scale_ *
+                      sync_->step(std::span<const int>(order_).subspan(begin, shard));
+        const int64_t global_step =
+            static_cast<int64_t>(epoch) * steps_per_epoch + step + 1;
+        if (config_.checkpoint_every > 0 &&
+            global_step % config_.checkpoint_every == 0) {
+          checkpoint(epoch, step + 1, epoch_loss);
+        }
+      }
+      if (world > 1) {
+        float total = static_cast<float>(epoch_loss);
+        group_->all_reduce(std::span<float>(&total, 1));
+        epoch_loss = total;
+      }
+      stats.loss = epoch_loss / stats.steps;
+    }
+
+    stats.seconds =
+        std::chrono::duration<double>(Clock::now() - epoch_start).count();
+    stats.samples = samples;
+    stats.samples_per_second = stats.seconds > 0.0 ? samples / stats.seconds : 0.0;
+    stats.ms_per_step = executed > 0 ? stats.seconds * 1e3 / executed : 0.0;
+    // 各 worker 并发组装批次，按 worker 数平均得到墙钟时间上的占比
+    stats.data_ms_per_step =
+        executed > 0 ? static_cast<double>(data_ns_.load()) * 1e-6 /
+                           config_.threads / executed
+                     : 0.0;
+    stats.compute_ms_per_step =
+        std::max(0.0, stats.ms_per_step - stats.data_ms_per_step);
+    if (config_.checkpoint_every == 0 || hogwild_) {
+      checkpoint(epoch + 1, 0, 0.0);
+    }
+    // 上一轮的后台评估与本轮训练重叠，这里取回结果，保证按轮次顺序交付
+    finish_pending();
+    if (X_test != nullptr && config_.eval_interval > 0 &&
+        (epoch + 1) % config_.eval_interval == 0 && rank == 0) {
+      if (config_.eval_async) {
+        pending_eval = evaluator_->evaluate_async(params_, *X_test, y_test);
+        pending_stats = stats;
+        continue;
+      }
+      stats.accuracy = evaluate(*X_test, y_test).accuracy();
+    }
+    deliver(stats);
+  }
+  finish_pending();
+  X_ = nullptr;
+  y_ = {};
+  if (last_epoch < config_.epochs) {
+    // 提前停下：记住位置，下一次 fit() 沿用当前的顺序与随机数状态
+    TrainingState state;
+    state.epoch = std::max(first_epoch, last_epoch);
+    state.order = std::move(order_);
+    resumed_ = std::move(state);
+  }
+  // 最后一个检查点写完才返回，调用者可以立即读取或退出
+  if (writer_) writer_->flush();
+  return history;
+}
+
+void Trainer::checkpoint(int epoch, int step, double epoch_loss) {
+  if (config_.checkpoint_path.empty()) return;
+  if (step > 0 && world_size() > 1) {
+    // 轮内的检查点需要全局的部分损失；所有进程在同一步到达这里
+    float total = static_cast<float>(epoch_loss);
+    group_->all_reduce(std::span<float>(&total, 1));
+    epoch_loss = total;
+  }
+  if (!writer_) return;
+  ProfileScope scope("checkpoint.snapshot");
+  TrainingState state;
+  state.epoch = epoch;
+  state.step = step;
+  state.epoch_loss = epoch_loss;
+  state.optimizer_steps = optimizer_->step_count();
+  std::ostringstream rng;
+  rng << rng_;
+  state.rng = rng.str();
+  state.order = order_;
+  const std::span<const float> values = store_->values();
+  state.params.assign(values.begin(), values.end());
+  state.optimizer_state = optimizer_->state();
+  writer_->submit(std::move(state));
+}
+
+void Trainer::resume(const std::string& path) {
+  TrainingState state = read_checkpoint(path);
+  if (state.params.size() != store_->size()) {
+    throw std::invalid_argument(
+        "Trainer::resume: checkpoint " + path +
+        " does not match the configured model (" +
+        std::to_string(state.params.size()) + " vs " +
+        std::to_string(store_->size()) + " parameters).");
+  }
+  optimizer_->load_state(state.optimizer_state, state.optimizer_steps);
+  std::copy(state.params.begin(), state.params.end(), store_->values().begin());
+  store_->refresh_bf16();
+  std::istringstream rng(state.rng);
+  rng >> rng_;
+  if (!rng) {
+    throw std::runtime_error("检查点中的随机数状态无效: " + path);
+  }
+  state.params.clear();
+  state.optimizer_state.clear();
+  resumed_ = std::move(state);
+}
+
+EvalResult Trainer::evaluate(const Features& X, std::span<const int> y) {
+  return evaluator_->evaluate(params_, X, y);
+}
+
+void Trainer::save(const std::string& path) const {
+  save_parameters(path, params_);
+}
@@ -0,0 +1,183 @@
+#ifndef TRAINER_H
+#define TRAINER_H
+// 可配置的训练引擎：按 TrainerConfig 构建全连接分类网络、优化器与并行方式，
+// 在给定的数据上训练若干轮，并报告每轮的吞吐与耗时构成。
+//
+// 配置既可以来自配置文件（每行 "key = value"，# 开头为注释），也可以来自
+// 命令行（--key value，key 中的 '-' 等同于 '_'），后者覆盖前者。
+// 未知的 key 或无法解析的值抛出 std::invalid_argument。
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../ops/ops.h"
+#include "Checkpoint.h"
+#include "DataParallelTrainer.h"
+#include "Evaluator.h"
+#include "Features.h"
+#include "Graph.h"
+#include "HogwildTrainer.h"
+#include "Matrix.h"
+#include "Node.h"
+#include "Optimizer.h"
+#include "ParameterStore.h"
+#include "ProcessGroup.h"
+
+struct TrainerConfig {
+  // 数据与模型文件。数据可以是 CSV，也可以是 MNIST 的 IDX 图像文件
+  // （如 train-images-idx3-ubyte，标签文件按命名规律推出）
+  std::string train_path = "../data/mnist_train.csv";
+  std::string test_path = "../data/mnist_test.csv";
+  std::string save_path = "../models/MNIST_1_sigmoid.model";
+
+  // 各层宽度（含输入与输出），写作 "784-128-10"；隐藏层使用 activation，
+  // 输出层是 logits，接 softmax 交叉熵。参数依次命名为 W1, b1, W2, b2, ...
+  std::vector<int> layers{784, 128, 10};
+  Activation activation = Activation::Sigmoid;
+  Precision precision = Precision::FP32;
+
+  int epochs = 10;
+  int batch_size = 64;
+  int threads = 1;
+  // mode = sync | hogwild；hogwild 时各线程异步更新共享参数，只支持无动量的 SGD
+  bool hogwild = false;
+  unsigned init_seed = 49;     // 权重初始化
+  unsigned shuffle_seed = 59;  // 每轮打乱样本顺序
+
+  // sgd / adam / adamw
+  std::string optimizer = "sgd";
+  float learning_rate = 0.05f;
+  float momentum = 0.0f;
+  bool nesterov = false;
+  float weight_decay = 0.0f;
+
+  // 每隔多少轮在测试集上评估一次；0 表示训练中不评估
+  int eval_interval = 0;
+  // 评估时每批送入网络的样本数
+  int eval_batch_size = 256;
+  // 为 true 时训练中的评估在后台线程上进行，与下一轮训练重叠；
+  // 该轮的统计与回调推迟到评估完成时（下一轮结束或 fit() 返回前）
+  bool eval_async = false;
+
+  // 检查点文件，为空时不写检查点
+  std::string checkpoint_path;
+  // 每隔多少个批次写一次检查点；0 表示每轮结束时写（Hogwild 只在轮末写）
+  int checkpoint_every = 0;
+
+  // 设置一个选项；布尔值接受 true/false/1/0
+  void set(const std::string& key, const std::string& value);
+  // 逐行读取 "key = value"
+  void load_file(const std::string& path);
+  // 检查取值范围与组合是否合法
+  void validate() const;
+  // 可读的单行摘要，用于日志
+  [[nodiscard]] std::string summary() const;
+};
+
+// 一轮训练的统计。多线程/多进程时 step 是一个全局批次，
+// data 是组装批次（按下标收集特征与标签）的时间，compute 为其余部分
+// （前向、反向、梯度归约与更新）；两者按 worker 平均，和等于 ms_per_step。
+struct EpochStats {
+  int epoch = 0;
+  double loss = 0.0;
+  int steps = 0;
+  // 本轮实际训练的样本数（全局，各进程合计）；从轮中间恢复时只计剩余的批次
+  int samples = 0;
+  double seconds = 0.0;
+  double samples_per_second = 0.0;
+  double ms_per_step = 0.0;
+  double data_ms_per_step = 0.0;
+  double compute_ms_per_step = 0.0;
+  // 本轮结束时的测试集准确率（%），未评估时为负数
+  double accuracy = -1.0;
+};
+
+class Trainer {
+ public:
+  using EpochCallback = std::function<void(const EpochStats&)>;
+
+  // group 非空时与其他进程一起训练：每个全局批次按进程切分，
+  // 梯度跨进程 all-reduce；group 必须比 Trainer 活得久
+  explicit Trainer(TrainerConfig config, ProcessGroup* group = nullptr);
+
+  Trainer(const Trainer&) = delete;
+  Trainer& operator=(const Trainer&) = delete;
+
+  // 在 (X, y) 上训练到第 config.epochs 轮（从头或从 resume() 的位置开始），
+  // 每轮结束后调用 on_epoch；配置了 checkpoint_path 时按间隔写检查点。
+  // X_test 非空且 eval_interval > 0 时按间隔评估（仅 0 号进程）。
+  // 批次在各 worker 上按需从 X 收集，IDX 数据此时才解码成 float / bf16。
+  std::vector<EpochStats> fit(const Features& X, std::span<const int> y,
+                              const Features* X_test = nullptr,
+                              std::span<const int> y_test = {},
+                              const EpochCallback& on_epoch = nullptr);
+
+  // 同 fit()，但只训练到第 end_epoch 轮（不超过 config.epochs）就返回。
+  // 之后再调用 fit() / fit_until() 从这里继续，结果与一次训练完逐位一致
+  std::vector<EpochStats> fit_until(int end_epoch, const Features& X,
+                                    std::span<const int> y,
+                                    const Features* X_test = nullptr,
+                                    std::span<const int> y_test = {},
+                                    const EpochCallback& on_epoch = nullptr);
+
+  // 从检查点恢复参数、优化器与随机数状态；随后的 fit() 从检查点记录的
+  // 轮与批次继续，结果与未中断的训练逐位一致
+  void resume(const std::string& path);
+
+  // 以当前参数分批评估 (X, y)，返回混淆矩阵与各项指标
+  EvalResult evaluate(const Features& X, std::span<const int> y);
+
+  void save(const std::string& path) const;
+
+  [[nodiscard]] const TrainerConfig& config() const { return config_; }
+  [[nodiscard]] const std::vector<std::shared_ptr<Node>>& params() const {
+    return params_;
+  }
+  [[nodiscard]] int rank() const { return group_ ? group_->rank() : 0; }
+  [[nodiscard]] int world_size() const {
+    return group_ ? group_->world_size() : 1;
+  }
+
+ private:
+  // 在 graph 上构建前向：隐藏层 dense + 激活，输出层为 logits
+  std::shared_ptr<Node> forward(Graph& graph,
+                                const std::vector<std::shared_ptr<Node>>& p,
+                                std::shared_ptr<Node> x) const;
+  // 快照当前状态交给后台线程写入（仅 0 号进程）；
+  // epoch_loss 是本轮前 step 个批次在所有进程上的损失之和
+  void checkpoint(int epoch, int step, double epoch_loss);
+
+  TrainerConfig config_;
+  ProcessGroup* group_;
+  Graph graph_;  // 持有参数节点
+  std::vector<std::shared_ptr<Node>> params_;
+  std::unique_ptr<ParameterStore> store_;
+  std::unique_ptr<Optimizer> optimizer_;
+  std::unique_ptr<DataParallelTrainer> sync_;
+  std::unique_ptr<HogwildTrainer> hogwild_;
+  std::unique_ptr<Evaluator> evaluator_;
+
+  std::unique_ptr<CheckpointWriter> writer_;
+  // 打乱顺序的随机数与当前轮的样本顺序，随检查点保存
+  std::mt19937 rng_;
+  std::vector<int> order_;
+  // resume() 读到或 fit_until() 停下时的进度，尚未被 fit() 使用
+  std::optional<TrainingState> resumed_;
+
+  // 当前训练数据，fit() 期间有效，供各 worker 的损失函数读取
+  const Features* X_ = nullptr;
+  std::span<const int> y_;
+  // 本进程分片占全局批次的比例
+  float process_scale_ = 1.0f;
+  // 各 worker 组装批次的累计耗时（纳秒）
+  std::atomic<int64_t> data_ns_{0};
+};
+
+#endif  // !TRAINER_H
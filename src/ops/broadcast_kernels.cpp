@@ -0,0 +1,226 @@
+#include "broadcast_kernels.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../core/Profiler.h"
+
+namespace {
+
+std::string shape_str(const Matrix& m) {
+  return std::to_string(m.get_rows()) + "x" + std::to_string(m.get_cols());
+}
+
+// 广播视图：行数为 1 时行步长为 0，列数为 1 时列步长为 0
+struct View {
+  const float* p;
+  int rows;
+  int cols;
+
+  const float* row(int i) const {
+    return rows == 1 ? p : p + static_cast<long>(i) * cols;
+  }
+  bool col_broadcast() const { return cols == 1; }
+};
+
+View view_of(const Matrix& m) {
+  return {m.get_data_ptr(), m.get_rows(), m.get_cols()};
+}
+
+template <BinaryOp Op>
+inline float apply(float x, float y) {
+  if constexpr (Op == BinaryOp::Add) return x + y;
+  if constexpr (Op == BinaryOp::Sub) return x - y;
+  if constexpr (Op == BinaryOp::Mul) return x * y;
+  return x / y;
+}
+
+// 列方向是否广播作为模板参数，内层循环要么连续读取、要么读取同一个标量，
+// 两种情况编译器都能向量化。
+template <BinaryOp Op, bool ACol, bool BCol>
+void forward_rows(View a, View b, float* op, int R, int C) {
+  for (int i = 0; i < R; ++i) {
+    const float* ar = a.row(i);
+    const float* br = b.row(i);
+    float* o = op + static_cast<long>(i) * C;
+    for (int j = 0; j < C; ++j) {
+      o[j] = apply<Op>(ACol ? ar[0] : ar[j], BCol ? br[0] : br[j]);
+    }
+  }
+}
+
+template <BinaryOp Op>
+void forward_dispatch(View a, View b, float* op, int R, int C) {
+  if (a.col_broadcast()) {
+    if (b.col_broadcast()) {
+      forward_rows<Op, true, true>(a, b, op, R, C);
+    } else {
+      forward_rows<Op, true, false>(a, b, op, R, C);
+    }
+  } else if (b.col_broadcast()) {
+    forward_rows<Op, false, true>(a, b, op, R, C);
+  } else {
+    forward_rows<Op, false, false>(a, b, op, R, C);
+  }
+}
+
+// 8 路独立部分和的行内求和，浮点归约不能重排时也能向量化
+inline float sum8(const float* v, int n) {
+  float part[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  int j = 0;
+  for (; j + 8 <= n; j += 8) {
+    for (int u = 0; u < 8; ++u) part[u] += v[j + u];
+  }
+  float s = 0.0f;
+  for (; j < n; ++j) s += v[j];
+  for (int u = 0; u < 8; ++u) s += part[u];
+  return s;
+}
+
+// 把一行梯度 sign * v 累加到目标行：目标列数为 1 时先沿列求和
+inline void reduce_row(float* target, int target_cols, const float* v, int C,
+                       float sign) {
+  if (target_cols == C) {
+    for (int j = 0; j < C; ++j) target[j] += sign * v[j];
+  } else {
+    target[0] += sign * sum8(v, C);
+  }
+}
+
+// 计算一个操作数的梯度。目标行数为 1 时所有行累加到同一行，即沿行求和。
+void backward_operand(BinaryOp op, bool for_a, View a, View b,
+                      const float* outp, const float* dyp, Matrix& g, int R,
+                      int C) {
+  float* gp = g.get_data_ptr();
+  const int g_rows = g.get_rows();
+  const int g_cols = g.get_cols();
+  const View self = for_a ? a : b;
+  const View other = for_a ? b : a;
+  std::vector<float> v(op == BinaryOp::Add || op == BinaryOp::Sub ? 0 : C);
+
+  for (int i = 0; i < R; ++i) {
+    const float* dy = dyp + static_cast<long>(i) * C;
+    float* target = g_rows == 1 ? gp : gp + static_cast<long>(i) * g_cols;
+    switch (op) {
+      case BinaryOp::Add:
+        reduce_row(target, g_cols, dy, C, 1.0f);
+        break;
+      case BinaryOp::Sub:
+        reduce_row(target, g_cols, dy, C, for_a ? 1.0f : -1.0f);
+        break;
+      case BinaryOp::Mul: {
+        // ∂(a*b)/∂a = b，∂(a*b)/∂b = a
+        const float* o = other.row(i);
+        if (other.col_broadcast()) {
+          const float s = o[0];
+          for (int j = 0; j < C; ++j) v[j] = dy[j] * s;
+        } else {
+          for (int j = 0; j < C; ++j) v[j] = dy[j] * o[j];
+        }
+        reduce_row(target, g_cols, v.data(), C, 1.0f);
+        break;
+      }
+      case BinaryOp::Div: {
+        // ∂(a/b)/∂a = 1/b，∂(a/b)/∂b = -(a/b)/b = -out/b
+        const float* br = for_a ? other.row(i) : self.row(i);
+        const bool b_col = for_a ? other.col_broadcast() : self.col_broadcast();
+        const float* out = outp + static_cast<long>(i) * C;
+        if (for_a) {
+          if (b_col) {
+            const float inv = 1.0f / br[0];
+            for (int j = 0; j < C; ++j) v[j] = dy[j] * inv;
+          } else {
+            for (int j = 0; j < C; ++j) v[j] = dy[j] / br[j];
+          }
+          reduce_row(target, g_cols, v.data(), C, 1.0f);
+        } else {
+          if (b_col) {
+            const float inv = 1.0f / br[0];
+            for (int j = 0; j < C; ++j) v[j] = dy[j] * out[j] * inv;
+          } else {
+            for (int j = 0; j < C; ++j) v[j] = dy[j] * out[j] / br[j];
+          }
+          reduce_row(target, g_cols, v.data(), C, -1.0f);
+        }
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+std::pair<int, int> broadcast_shape(const Matrix& a, const Matrix& b,
+                                    const char* who) {
+  auto dim = [&](int x, int y) {
+    if (x == y || y == 1) return x;
+    if (x == 1) return y;
+    throw std::invalid_argument(std::string(who) +
+                                ": shapes cannot be broadcast. a " +
+                                shape_str(a) + ", b " + shape_str(b) + ".");
+  };
+  return {dim(a.get_rows(), b.get_rows()), dim(a.get_cols(), b.get_cols())};
+}
+
+void broadcast_forward_kernel(BinaryOp op, const Matrix& a, const Matrix& b,
+                              Matrix& out) {
+  auto [R, C] = broadcast_shape(a, b, "broadcast_forward_kernel");
+  if (out.get_rows() != R || out.get_cols() != C) {
+    throw std::invalid_argument(
+        "broadcast_forward_kernel: Dimensions mismatch. out " +
+        shape_str(out) + ".");
+  }
+  ProfileScope::add_counts(
+      static_cast<double>(R) * C,
+      4.0 * (a.get_rows() * a.get_cols() + b.get_rows() * b.get_cols()),
+      4.0 * R * C);
+  const View av = view_of(a);
+  const View bv = view_of(b);
+  float* op_ptr = out.get_data_ptr();
+  switch (op) {
+    case BinaryOp::Add:
+      forward_dispatch<BinaryOp::Add>(av, bv, op_ptr, R, C);
+      break;
+    case BinaryOp::Sub:
+      forward_dispatch<BinaryOp::Sub>(av, bv, op_ptr, R, C);
+      break;
+    case BinaryOp::Mul:
+      forward_dispatch<BinaryOp::Mul>(av, bv, op_ptr, R, C);
+      break;
+    case BinaryOp::Div:
+      forward_dispatch<BinaryOp::Div>(av, bv, op_ptr, R, C);
+      break;
+  }
+}
+
+void broadcast_backward_kernel(BinaryOp op, const Matrix& a, const Matrix& b,
+                               const Matrix& out, const Matrix& dy, Matrix* ga,
+                               Matrix* gb) {
+  auto [R, C] = broadcast_shape(a, b, "broadcast_backward_kernel");
+  auto same_shape = [](const Matrix& x, const Matrix& y) {
+    return x.get_rows() == y.get_rows() && x.get_cols() == y.get_cols();
+  };
+  if (dy.get_rows() != R || dy.get_cols() != C || out.get_rows() != R ||
+      out.get_cols() != C || (ga != nullptr && !same_shape(*ga, a)) ||
+      (gb != nullptr && !same_shape(*gb, b))) {
+    throw std::invalid_argument(
+        "broadcast_backward_kernel: Dimensions mismatch. dy " + shape_str(dy) +
+        ".");
+  }
+  const View av = view_of(a);
+  const View bv = view_of(b);
+  const int operands = (ga != nullptr) + (gb != nullptr);
+  ProfileScope::add_counts(2.0 * operands * R * C,
+                           8.0 * operands * R * C,
+                           4.0 * ((ga ? a.get_rows() * a.get_cols() : 0) +
+                                  (gb ? b.get_rows() * b.get_cols() : 0)));
+  if (ga != nullptr) {
+    backward_operand(op, true, av, bv, out.get_data_ptr(), dy.get_data_ptr(),
+                     *ga, R, C);
+  }
+  if (gb != nullptr) {
+    backward_operand(op, false, av, bv, out.get_data_ptr(), dy.get_data_ptr(),
+                     *gb, R, C);
+  }
+}
@@ -0,0 +1,27 @@
+#ifndef BROADCAST_KERNELS_H
+#define BROADCAST_KERNELS_H
+// 二元逐元素运算的 NumPy 式广播。两个操作数每一维要么相等要么为 1，
+// 输出取较大者。大小为 1 的维度按步长 0 读取，从不生成展开后的操作数；
+// 反向把梯度沿被广播的维度求和后累加到对应形状的梯度上。
+
+#include <utility>
+
+#include "../core/Matrix.h"
+
+enum class BinaryOp { Add, Sub, Mul, Div };
+
+// 广播后的 (rows, cols)；形状不兼容时抛出 std::invalid_argument
+std::pair<int, int> broadcast_shape(const Matrix& a, const Matrix& b,
+                                    const char* who);
+
+// out = a op b，out 必须已是广播后的形状
+void broadcast_forward_kernel(BinaryOp op, const Matrix& a, const Matrix& b,
+                              Matrix& out);
+
+// ga += reduce(dy * ∂out/∂a)，gb += reduce(dy * ∂out/∂b)。
+// out 是前向结果（Div 对 b 求导时使用）；ga / gb 为空指针时跳过。
+void broadcast_backward_kernel(BinaryOp op, const Matrix& a, const Matrix& b,
+                               const Matrix& out, const Matrix& dy, Matrix* ga,
+                               Matrix* gb);
+
+#endif  // !BROADCAST_KERNELS_H
@@ -0,0 +1,425 @@
+#include "conv_kernels.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../core/Profiler.h"
+
+namespace {
+
+// 一次处理的输出通道数：同一行 im2col 数据加载一次，更新多个输出通道
+constexpr int kChannelTile = 4;
+static_assert(kChannelTile == 4, "backward_direct 的合并 axpy 按 4 路展开");
+
+inline void axpy(float* y, const float* x, float a, int n) {
+  for (int i = 0; i < n; ++i) y[i] += a * x[i];
+}
+
+// 8 路独立部分和，便于编译器向量化
+inline float dot(const float* a, const float* b, int n) {
+  float part[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  int j = 0;
+  for (; j + 8 <= n; j += 8) {
+    for (int u = 0; u < 8; ++u) part[u] += a[j + u] * b[j + u];
+  }
+  float s = 0.0f;
+  for (; j < n; ++j) s += a[j] * b[j];
+  for (int u = 0; u < 8; ++u) s += part[u];
+  return s;
+}
+
+std::string shape_str(const Matrix& m) {
+  return std::to_string(m.get_rows()) + "x" + std::to_string(m.get_cols());
+}
+
+bool use_direct(const Conv2dShape& s, ConvAlgo algo) {
+  if (algo == ConvAlgo::Direct) {
+    if (s.stride != 1) {
+      throw std::invalid_argument("conv2d: direct kernel requires stride 1.");
+    }
+    return true;
+  }
+  return algo == ConvAlgo::Auto && s.kernel_size == 3 && s.stride == 1;
+}
+
+void check_shapes(const char* who, const Matrix& x, const Matrix& W,
+                  const Conv2dShape& s) {
+  const int K = s.kernel_size;
+  if (s.in_channels <= 0 || K <= 0 || s.stride <= 0 || s.padding < 0 ||
+      s.out_height() <= 0 || s.out_width() <= 0) {
+    throw std::invalid_argument(std::string(who) + ": invalid conv geometry.");
+  }
+  if (x.get_cols() != s.in_channels * s.height * s.width ||
+      W.get_cols() != s.in_channels * K * K) {
+    throw std::invalid_argument(std::string(who) + ": Dimensions mismatch. x " +
+                                shape_str(x) + ", W " + shape_str(W) + ".");
+  }
+}
+
+// 单张图展开为 (C*K*K) x (OH*OW)，越界位置填 0
+void im2col(const float* img, const Conv2dShape& s, float* cols) {
+  const int K = s.kernel_size;
+  const int OH = s.out_height();
+  const int OW = s.out_width();
+  for (int c = 0; c < s.in_channels; ++c) {
+    const float* plane = img + static_cast<long>(c) * s.height * s.width;
+    for (int ky = 0; ky < K; ++ky) {
+      for (int kx = 0; kx < K; ++kx) {
+        float* row = cols + static_cast<long>((c * K + ky) * K + kx) * OH * OW;
+        for (int oy = 0; oy < OH; ++oy) {
+          const int iy = oy * s.stride + ky - s.padding;
+          float* dst = row + static_cast<long>(oy) * OW;
+          if (iy < 0 || iy >= s.height) {
+            std::fill(dst, dst + OW, 0.0f);
+            continue;
+          }
+          const float* src = plane + static_cast<long>(iy) * s.width;
+          for (int ox = 0; ox < OW; ++ox) {
+            const int ix = ox * s.stride + kx - s.padding;
+            dst[ox] = (ix >= 0 && ix < s.width) ? src[ix] : 0.0f;
+          }
+        }
+      }
+    }
+  }
+}
+
+// im2col 的转置：把列累加回图像（重叠位置相加）
+void col2im_add(const float* cols, const Conv2dShape& s, float* img) {
+  const int K = s.kernel_size;
+  const int OH = s.out_height();
+  const int OW = s.out_width();
+  for (int c = 0; c < s.in_channels; ++c) {
+    float* plane = img + static_cast<long>(c) * s.height * s.width;
+    for (int ky = 0; ky < K; ++ky) {
+      for (int kx = 0; kx < K; ++kx) {
+        const float* row =
+            cols + static_cast<long>((c * K + ky) * K + kx) * OH * OW;
+        for (int oy = 0; oy < OH; ++oy) {
+          const int iy = oy * s.stride + ky - s.padding;
+          if (iy < 0 || iy >= s.height) continue;
+          const float* src = row + static_cast<long>(oy) * OW;
+          float* dst = plane + static_cast<long>(iy) * s.width;
+          for (int ox = 0; ox < OW; ++ox) {
+            const int ix = ox * s.stride + kx - s.padding;
+            if (ix >= 0 && ix < s.width) dst[ix] += src[ox];
+          }
+        }
+      }
+    }
+  }
+}
+
+// 输出平面初始化为偏置
+void init_bias(float* op, const float* bp, int OC, int P) {
+  for (int oc = 0; oc < OC; ++oc) {
+    std::fill(op + static_cast<long>(oc) * P, op + static_cast<long>(oc + 1) * P,
+              bp != nullptr ? bp[oc] : 0.0f);
+  }
+}
+
+// ---------- im2col + GEMM ----------
+
+void forward_im2col(const float* xp, const float* wp, const float* bp,
+                    float* op, int N, int OC, const Conv2dShape& s) {
+  const int CKK = s.in_channels * s.kernel_size * s.kernel_size;
+  const int P = s.out_height() * s.out_width();
+  const long in_size = static_cast<long>(s.in_channels) * s.height * s.width;
+  std::vector<float> cols(static_cast<size_t>(CKK) * P);
+
+  for (int n = 0; n < N; ++n) {
+    im2col(xp + n * in_size, s, cols.data());
+    float* out = op + static_cast<long>(n) * OC * P;
+    init_bias(out, bp, OC, P);
+    // out(OC x P) += W(OC x CKK) * cols(CKK x P)，内层沿 P 连续
+    for (int oc0 = 0; oc0 < OC; oc0 += kChannelTile) {
+      const int on = std::min(kChannelTile, OC - oc0);
+      for (int k = 0; k < CKK; ++k) {
+        const float* c_row = cols.data() + static_cast<long>(k) * P;
+        for (int r = 0; r < on; ++r) {
+          const float w = wp[static_cast<long>(oc0 + r) * CKK + k];
+          if (w == 0.0f) continue;
+          axpy(out + static_cast<long>(oc0 + r) * P, c_row, w, P);
+        }
+      }
+    }
+  }
+}
+
+void backward_im2col(const float* xp, const float* wp, const float* dyp,
+                     float* dxp, float* dwp, float* dbp, int N, int OC,
+                     const Conv2dShape& s) {
+  const int CKK = s.in_channels * s.kernel_size * s.kernel_size;
+  const int P = s.out_height() * s.out_width();
+  const long in_size = static_cast<long>(s.in_channels) * s.height * s.width;
+  // 反向重新展开输入而不是在前向保存，避免占用 N 倍的 im2col 内存
+  std::vector<float> cols(static_cast<size_t>(CKK) * P);
+  std::vector<float> dcols(dxp != nullptr ? static_cast<size_t>(CKK) * P : 0);
+
+  for (int n = 0; n < N; ++n) {
+    const float* dy = dyp + static_cast<long>(n) * OC * P;
+    im2col(xp + n * in_size, s, cols.data());
+
+    for (int oc = 0; oc < OC; ++oc) {
+      const float* dy_row = dy + static_cast<long>(oc) * P;
+      if (dbp != nullptr) {
+        float acc = 0.0f;
+        for (int p = 0; p < P; ++p) acc += dy_row[p];
+        dbp[oc] += acc;
+      }
+      // dW(OC x CKK) += dy(OC x P) * colsᵀ
+      float* dw_row = dwp + static_cast<long>(oc) * CKK;
+      for (int k = 0; k < CKK; ++k) {
+        dw_row[k] += dot(dy_row, cols.data() + static_cast<long>(k) * P, P);
+      }
+    }
+
+    if (dxp != nullptr) {
+      // dcols(CKK x P) = Wᵀ * dy，再按 col2im 累加回 dx
+      std::fill(dcols.begin(), dcols.end(), 0.0f);
+      for (int k = 0; k < CKK; ++k) {
+        float* dc_row = dcols.data() + static_cast<long>(k) * P;
+        for (int oc = 0; oc < OC; ++oc) {
+          const float w = wp[static_cast<long>(oc) * CKK + k];
+          if (w == 0.0f) continue;
+          axpy(dc_row, dy + static_cast<long>(oc) * P, w, P);
+        }
+      }
+      col2im_add(dcols.data(), s, dxp + n * in_size);
+    }
+  }
+}
+
+// ---------- 步长 1 的直接卷积 ----------
+// 输入先零填充成 Hp x Wp，输出按"宽行"布局 OH x Wp 计算（每行末尾多出的
+// Wp - OW 列是无用值）。这样每个卷积核位置 (c, ky, kx) 对应的输入就是
+// 填充图上一段连续内存，整张输出平面只需一次长度约 OH*Wp 的 axpy / dot，
+// 而不是 OH 次长度 OW 的短循环，也不需要 im2col 的 K*K 倍内存。
+
+struct WideLayout {
+  int Hp, Wp;
+  long plane;  // 填充后单个通道的大小
+  long len;    // 每个卷积核位置参与运算的连续长度
+};
+
+WideLayout wide_layout(const Conv2dShape& s) {
+  WideLayout l;
+  l.Hp = s.height + 2 * s.padding;
+  l.Wp = s.width + 2 * s.padding;
+  l.plane = static_cast<long>(l.Hp) * l.Wp;
+  l.len = static_cast<long>(s.out_height() - 1) * l.Wp + s.out_width();
+  return l;
+}
+
+// 单张图零填充到 C x Hp x Wp
+void pad_image(const float* img, const Conv2dShape& s, const WideLayout& l,
+               float* dst) {
+  std::fill(dst, dst + s.in_channels * l.plane, 0.0f);
+  for (int c = 0; c < s.in_channels; ++c) {
+    for (int y = 0; y < s.height; ++y) {
+      const float* src =
+          img + (static_cast<long>(c) * s.height + y) * s.width;
+      std::copy(src, src + s.width,
+                dst + c * l.plane + static_cast<long>(y + s.padding) * l.Wp +
+                    s.padding);
+    }
+  }
+}
+
+void forward_direct(const float* xp, const float* wp, const float* bp,
+                    float* op, int N, int OC, const Conv2dShape& s) {
+  const int C = s.in_channels;
+  const int K = s.kernel_size;
+  const int OH = s.out_height();
+  const int OW = s.out_width();
+  const int P = OH * OW;
+  const long in_size = static_cast<long>(C) * s.height * s.width;
+  const WideLayout l = wide_layout(s);
+  std::vector<float> padded(static_cast<size_t>(C * l.plane));
+  std::vector<float> wide(static_cast<size_t>(kChannelTile) * OH * l.Wp);
+
+  for (int n = 0; n < N; ++n) {
+    pad_image(xp + n * in_size, s, l, padded.data());
+    float* out = op + static_cast<long>(n) * OC * P;
+    for (int oc0 = 0; oc0 < OC; oc0 += kChannelTile) {
+      const int on = std::min(kChannelTile, OC - oc0);
+      std::fill(wide.begin(), wide.end(), 0.0f);
+      for (int c = 0; c < C; ++c) {
+        for (int ky = 0; ky < K; ++ky) {
+          for (int kx = 0; kx < K; ++kx) {
+            const float* src = padded.data() + c * l.plane +
+                               static_cast<long>(ky) * l.Wp + kx;
+            const int widx = (c * K + ky) * K + kx;
+            for (int r = 0; r < on; ++r) {
+              const float w = wp[static_cast<long>(oc0 + r) * C * K * K + widx];
+              if (w == 0.0f) continue;
+              axpy(wide.data() + static_cast<long>(r) * OH * l.Wp, src, w,
+                   static_cast<int>(l.len));
+            }
+          }
+        }
+      }
+      // 宽行压缩回 OH x OW，同时加偏置
+      for (int r = 0; r < on; ++r) {
+        const float bias = bp != nullptr ? bp[oc0 + r] : 0.0f;
+        const float* w_plane = wide.data() + static_cast<long>(r) * OH * l.Wp;
+        float* o_plane = out + static_cast<long>(oc0 + r) * P;
+        for (int oy = 0; oy < OH; ++oy) {
+          for (int ox = 0; ox < OW; ++ox) {
+            o_plane[oy * OW + ox] = w_plane[static_cast<long>(oy) * l.Wp + ox] +
+                                    bias;
+          }
+        }
+      }
+    }
+  }
+}
+
+void backward_direct(const float* xp, const float* wp, const float* dyp,
+                     float* dxp, float* dwp, float* dbp, int N, int OC,
+                     const Conv2dShape& s) {
+  const int C = s.in_channels;
+  const int K = s.kernel_size;
+  const int OH = s.out_height();
+  const int OW = s.out_width();
+  const int P = OH * OW;
+  const long in_size = static_cast<long>(C) * s.height * s.width;
+  const WideLayout l = wide_layout(s);
+  const long wide_size = static_cast<long>(OH) * l.Wp;
+  const int len = static_cast<int>(l.len);
+  std::vector<float> padded(static_cast<size_t>(C * l.plane));
+  std::vector<float> dpadded(dxp != nullptr ? static_cast<size_t>(C * l.plane)
+                                            : 0);
+  // kChannelTile 个输出通道的 dy 宽行形式，多余的列为 0，不会污染 dW / dx
+  std::vector<float> dy_wide(static_cast<size_t>(kChannelTile) * wide_size,
+                             0.0f);
+
+  for (int n = 0; n < N; ++n) {
+    pad_image(xp + n * in_size, s, l, padded.data());
+    if (dxp != nullptr) std::fill(dpadded.begin(), dpadded.end(), 0.0f);
+    const float* dy = dyp + static_cast<long>(n) * OC * P;
+
+    for (int oc0 = 0; oc0 < OC; oc0 += kChannelTile) {
+      const int on = std::min(kChannelTile, OC - oc0);
+      const float* g[kChannelTile];
+      for (int r = 0; r < kChannelTile; ++r) {
+        float* wide_r = dy_wide.data() + r * wide_size;
+        g[r] = wide_r;
+        if (r >= on) {
+          std::fill(wide_r, wide_r + wide_size, 0.0f);
+          continue;
+        }
+        const float* dy_plane = dy + static_cast<long>(oc0 + r) * P;
+        float acc = 0.0f;
+        for (int oy = 0; oy < OH; ++oy) {
+          for (int ox = 0; ox < OW; ++ox) {
+            const float v = dy_plane[oy * OW + ox];
+            wide_r[static_cast<long>(oy) * l.Wp + ox] = v;
+            acc += v;
+          }
+        }
+        if (dbp != nullptr) dbp[oc0 + r] += acc;
+      }
+
+      for (int c = 0; c < C; ++c) {
+        for (int ky = 0; ky < K; ++ky) {
+          for (int kx = 0; kx < K; ++kx) {
+            const long off = c * l.plane + static_cast<long>(ky) * l.Wp + kx;
+            const int widx = (c * K + ky) * K + kx;
+            float w[kChannelTile] = {0.0f, 0.0f, 0.0f, 0.0f};
+            for (int r = 0; r < on; ++r) {
+              const long wi = static_cast<long>(oc0 + r) * C * K * K + widx;
+              dwp[wi] += dot(g[r], padded.data() + off, len);
+              w[r] = wp[wi];
+            }
+            if (dxp != nullptr) {
+              // 几个输出通道的贡献合并成一次读改写
+              float* dst = dpadded.data() + off;
+              for (int i = 0; i < len; ++i) {
+                dst[i] += w[0] * g[0][i] + w[1] * g[1][i] + w[2] * g[2][i] +
+                          w[3] * g[3][i];
+              }
+            }
+          }
+        }
+      }
+    }
+
+    if (dxp != nullptr) {
+      // 去掉填充，累加回 dx
+      float* dimg = dxp + n * in_size;
+      for (int c = 0; c < C; ++c) {
+        for (int y = 0; y < s.height; ++y) {
+          const float* src = dpadded.data() + c * l.plane +
+                             static_cast<long>(y + s.padding) * l.Wp +
+                             s.padding;
+          float* dst = dimg + (static_cast<long>(c) * s.height + y) * s.width;
+          for (int x = 0; x < s.width; ++x) dst[x] += src[x];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void conv2d_forward_kernel(const Matrix& x, const Matrix& W, const Matrix* b,
+                           const Conv2dShape& shape, Matrix& out,
+                           ConvAlgo algo) {
+  check_shapes("conv2d_forward_kernel", x, W, shape);
+  const int N = x.get_rows();
+  const int OC = W.get_rows();
+  const int P = shape.out_height() * shape.out_width();
+  const int CKK = W.get_cols();
+  if (out.get_rows() != N || out.get_cols() != OC * P ||
+      (b != nullptr && (b->get_rows() != 1 || b->get_cols() != OC))) {
+    throw std::invalid_argument(
+        "conv2d_forward_kernel: Dimensions mismatch. out " + shape_str(out) +
+        ".");
+  }
+  ProfileScope::add_counts(2.0 * N * OC * P * CKK,
+                           4.0 * (x.get_rows() * x.get_cols() + OC * CKK),
+                           4.0 * N * OC * P);
+  const float* bp = b != nullptr ? b->get_data_ptr() : nullptr;
+  if (use_direct(shape, algo)) {
+    forward_direct(x.get_data_ptr(), W.get_data_ptr(), bp, out.get_data_ptr(),
+                   N, OC, shape);
+  } else {
+    forward_im2col(x.get_data_ptr(), W.get_data_ptr(), bp, out.get_data_ptr(),
+                   N, OC, shape);
+  }
+}
+
+void conv2d_backward_kernel(const Matrix& x, const Matrix& W, const Matrix& dy,
+                            const Conv2dShape& shape, Matrix* dx, Matrix& dW,
+                            Matrix* db, ConvAlgo algo) {
+  check_shapes("conv2d_backward_kernel", x, W, shape);
+  const int N = x.get_rows();
+  const int OC = W.get_rows();
+  const int P = shape.out_height() * shape.out_width();
+  const int CKK = W.get_cols();
+  if (dy.get_rows() != N || dy.get_cols() != OC * P ||
+      dW.get_rows() != OC || dW.get_cols() != CKK ||
+      (dx != nullptr &&
+       (dx->get_rows() != N || dx->get_cols() != x.get_cols())) ||
+      (db != nullptr && (db->get_rows() != 1 || db->get_cols() != OC))) {
+    throw std::invalid_argument(
+        "conv2d_backward_kernel: Dimensions mismatch. dy " + shape_str(dy) +
+        ", dW " + shape_str(dW) + ".");
+  }
+  ProfileScope::add_counts(
+      (dx != nullptr ? 4.0 : 2.0) * N * OC * P * CKK,
+      4.0 * (x.get_rows() * x.get_cols() + OC * CKK + N * OC * P),
+      4.0 * (OC * CKK + (dx != nullptr ? x.get_rows() * x.get_cols() : 0)));
+  float* dxp = dx != nullptr ? dx->get_data_ptr() : nullptr;
+  float* dbp = db != nullptr ? db->get_data_ptr() : nullptr;
+  if (use_direct(shape, algo)) {
+    backward_direct(x.get_data_ptr(), W.get_data_ptr(), dy.get_data_ptr(), dxp,
+                    dW.get_data_ptr(), dbp, N, OC, shape);
+  } else {
+    backward_im2col(x.get_data_ptr(), W.get_data_ptr(), dy.get_data_ptr(), dxp,
+                    dW.get_data_ptr(), dbp, N, OC, shape);
+  }
+}
@@ -0,0 +1,40 @@
+#ifndef CONV_KERNELS_H
+#define CONV_KERNELS_H
+// 二维卷积计算核。Node 的值都是 Matrix，所以批量图像按 NCHW 展平成
+// N x (C*H*W) 的矩阵，每行一张图；卷积核为 OC x (C*K*K)，偏置为 1 x OC；
+// 输出为 N x (OC*OH*OW)，可以直接接下一层卷积或 reshape 后接 dense。
+
+#include "../core/Matrix.h"
+
+// 卷积的几何参数（方形卷积核，上下左右同样的零填充）
+struct Conv2dShape {
+  int in_channels = 1;
+  int height = 0;
+  int width = 0;
+  int kernel_size = 3;
+  int stride = 1;
+  int padding = 0;
+
+  [[nodiscard]] int out_height() const {
+    return (height + 2 * padding - kernel_size) / stride + 1;
+  }
+  [[nodiscard]] int out_width() const {
+    return (width + 2 * padding - kernel_size) / stride + 1;
+  }
+};
+
+// Auto：3x3 步长 1 走直接卷积，其余走 im2col + GEMM。
+// 另外两项用于测试与性能对比时强制选择某条路径。
+enum class ConvAlgo { Auto, Im2col, Direct };
+
+// out = conv(x, W) + b，b 可以为空指针。out 必须已是 N x (OC*OH*OW)。
+void conv2d_forward_kernel(const Matrix& x, const Matrix& W, const Matrix* b,
+                           const Conv2dShape& shape, Matrix& out,
+                           ConvAlgo algo = ConvAlgo::Auto);
+
+// 由上游梯度 dy 计算并累加 dW、db、dx；dx / db 为空指针时跳过。
+void conv2d_backward_kernel(const Matrix& x, const Matrix& W, const Matrix& dy,
+                            const Conv2dShape& shape, Matrix* dx, Matrix& dW,
+                            Matrix* db, ConvAlgo algo = ConvAlgo::Auto);
+
+#endif  // !CONV_KERNELS_H
@@ -0,0 +1,346 @@
+#include "fused_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../core/Profiler.h"
+
+namespace {
+
+// 一个输出 tile 为 kRowTile 行 x kColTile 列，累加器放在栈上，
+// 编译器可以把内层 j 循环向量化。
+constexpr int kRowTile = 4;
+constexpr int kColTile = 64;
+
+// 激活类型作为模板参数，保证内层循环里没有分支，便于向量化。
+template <Activation A>
+inline float apply_activation(float v) {
+  if constexpr (A == Activation::Relu) return v > 0.0f ? v : 0.0f;
+  if constexpr (A == Activation::Sigmoid) return 1.0f / (1.0f + std::exp(-v));
+  if constexpr (A == Activation::Tanh) return std::tanh(v);
+  return v;
+}
+
+// 激活函数的导数，全部用输出 y 表示，因此反向不需要保存激活前的值。
+template <Activation A>
+inline float activation_grad_from_output(float y) {
+  if constexpr (A == Activation::Relu) return y > 0.0f ? 1.0f : 0.0f;
+  if constexpr (A == Activation::Sigmoid) return y * (1.0f - y);
+  if constexpr (A == Activation::Tanh) return 1.0f - y * y;
+  return 1.0f;
+}
+
+// 把运行时的激活类型分发到对应的模板实例。
+template <template <Activation> class Impl, typename... Args>
+void dispatch_activation(Activation act, Args&&... args) {
+  switch (act) {
+    case Activation::Relu:
+      Impl<Activation::Relu>::run(std::forward<Args>(args)...);
+      break;
+    case Activation::Sigmoid:
+      Impl<Activation::Sigmoid>::run(std::forward<Args>(args)...);
+      break;
+    case Activation::Tanh:
+      Impl<Activation::Tanh>::run(std::forward<Args>(args)...);
+      break;
+    case Activation::None:
+    default:
+      Impl<Activation::None>::run(std::forward<Args>(args)...);
+      break;
+  }
+}
+
+// 操作数按元素类型展开为 float：fp32 原样返回，bf16 只是一次移位，
+// 内层循环仍能向量化，累加始终在 fp32 中进行。
+inline float load(float v) { return v; }
+inline float load(bf16 v) { return bf16_to_float(v); }
+
+// 8 路独立部分和，浮点归约不能重排时也能让编译器向量化
+template <typename T>
+inline float dot(const T* a, const float* b, int n) {
+  float part[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  int j = 0;
+  for (; j + 8 <= n; j += 8) {
+    for (int u = 0; u < 8; ++u) part[u] += load(a[j + u]) * b[j + u];
+  }
+  float s = 0.0f;
+  for (; j < n; ++j) s += load(a[j]) * b[j];
+  for (int u = 0; u < 8; ++u) s += part[u];
+  return s;
+}
+
+std::string shape_str(const Matrix& m) {
+  return std::to_string(m.get_rows()) + "x" + std::to_string(m.get_cols());
+}
+
+std::string shape_str(const BF16Matrix& m) {
+  return std::to_string(m.rows) + "x" + std::to_string(m.cols);
+}
+
+// 尾声写回：输出为 bf16 时直接转换，fp32 输出而操作数为 bf16 时舍入到
+// bf16 可表示的值，两种写法得到的激活完全相同。
+template <typename T>
+inline void store(float v, float& dst) {
+  if constexpr (std::is_same_v<T, bf16>) {
+    dst = round_to_bf16(v);
+  } else {
+    dst = v;
+  }
+}
+template <typename T>
+inline void store(float v, bf16& dst) {
+  dst = float_to_bf16(v);
+}
+
+// T 为 x / W 的元素类型（float 或 bf16），O 为输出的元素类型。bf16 时输出
+// 也舍入到 bf16，使激活在下一层的表示与保存给反向的值一致。
+template <Activation A>
+struct DenseForward {
+  template <typename T, typename O>
+  static void run(const T* xp, const T* wp, const float* bp, O* op, int M,
+                  int K, int N) {
+    float acc[kRowTile][kColTile];
+    for (int i0 = 0; i0 < M; i0 += kRowTile) {
+      const int rn = std::min(kRowTile, M - i0);
+      for (int j0 = 0; j0 < N; j0 += kColTile) {
+        const int jn = std::min(kColTile, N - j0);
+
+        // 累加器直接以偏置初始化，省去单独的加偏置遍历。
+        for (int r = 0; r < rn; ++r) {
+          for (int j = 0; j < jn; ++j) {
+            acc[r][j] = bp != nullptr ? bp[j0 + j] : 0.0f;
+          }
+        }
+
+        for (int k = 0; k < K; ++k) {
+          const T* w_row = wp + static_cast<long>(k) * N + j0;
+          for (int r = 0; r < rn; ++r) {
+            const float a = load(xp[static_cast<long>(i0 + r) * K + k]);
+            // MNIST 输入中大部分像素为 0，跳过可以省掉大量乘加。
+            if (a == 0.0f) continue;
+            float* acc_row = acc[r];
+            for (int j = 0; j < jn; ++j) acc_row[j] += a * load(w_row[j]);
+          }
+        }
+
+        // epilogue：激活后一次写回输出。
+        for (int r = 0; r < rn; ++r) {
+          O* o_row = op + static_cast<long>(i0 + r) * N + j0;
+          for (int j = 0; j < jn; ++j) {
+            store<T>(apply_activation<A>(acc[r][j]), o_row[j]);
+          }
+        }
+      }
+    }
+  }
+};
+
+template <Activation A>
+struct DenseBackward {
+  template <typename T, typename Y>
+  static void run(const T* xp, const T* wp, const Y* yp,
+                  const float* dyp, float* dxp, float* dwp, float* dbp, int M,
+                  int K, int N) {
+    // 每次处理 kRowTile 个样本：先算出这几行的 dz，再沿 k 扫描一遍，
+    // 同一行 W[k,:] / dW[k,:] 只加载一次就同时完成 dW 与 dx 的更新。
+    std::vector<float> dz(static_cast<size_t>(kRowTile) * N);
+    for (int i0 = 0; i0 < M; i0 += kRowTile) {
+      const int rn = std::min(kRowTile, M - i0);
+
+      for (int r = 0; r < rn; ++r) {
+        const long base = static_cast<long>(i0 + r) * N;
+        float* dz_row = dz.data() + static_cast<long>(r) * N;
+        for (int j = 0; j < N; ++j) {
+          dz_row[j] =
+              dyp[base + j] * activation_grad_from_output<A>(load(yp[base + j]));
+        }
+        if (dbp != nullptr) {
+          for (int j = 0; j < N; ++j) dbp[j] += dz_row[j];
+        }
+      }
+
+      for (int k = 0; k < K; ++k) {
+        const T* w_row = wp + static_cast<long>(k) * N;
+        float* dw_row = dwp + static_cast<long>(k) * N;
+        for (int r = 0; r < rn; ++r) {
+          const float* dz_row = dz.data() + static_cast<long>(r) * N;
+          const float a = load(xp[static_cast<long>(i0 + r) * K + k]);
+          if (a != 0.0f) {
+            for (int j = 0; j < N; ++j) dw_row[j] += a * dz_row[j];
+          }
+          if (dxp != nullptr) {
+            dxp[static_cast<long>(i0 + r) * K + k] += dot(w_row, dz_row, N);
+          }
+        }
+      }
+    }
+  }
+};
+
+}  // namespace
+
+void dense_forward_kernel(const Matrix& x, const Matrix& W, const Matrix* b,
+                          Activation act, Matrix& out) {
+  const int M = x.get_rows();
+  const int K = x.get_cols();
+  const int N = W.get_cols();
+  if (W.get_rows() != K || out.get_rows() != M || out.get_cols() != N ||
+      (b != nullptr && (b->get_rows() != 1 || b->get_cols() != N))) {
+    throw std::invalid_argument("dense_forward_kernel: Dimensions mismatch. x " +
+                                shape_str(x) + ", W " + shape_str(W) +
+                                ", out " + shape_str(out) + ".");
+  }
+  ProfileScope::add_counts(2.0 * M * K * N + 2.0 * M * N,
+                           4.0 * (M * K + K * N + N), 4.0 * M * N);
+  dispatch_activation<DenseForward>(act, x.get_data_ptr(), W.get_data_ptr(),
+                                    b != nullptr ? b->get_data_ptr() : nullptr,
+                                    out.get_data_ptr(), M, K, N);
+}
+
+void dense_backward_kernel(const Matrix& x, const Matrix& W, const Matrix& y,
+                           const Matrix& dy, Activation act, Matrix* dx,
+                           Matrix& dW, Matrix* db) {
+  const int M = x.get_rows();
+  const int K = x.get_cols();
+  const int N = W.get_cols();
+  if (W.get_rows() != K || y.get_rows() != M || y.get_cols() != N ||
+      dy.get_rows() != M || dy.get_cols() != N || dW.get_rows() != K ||
+      dW.get_cols() != N ||
+      (dx != nullptr && (dx->get_rows() != M || dx->get_cols() != K)) ||
+      (db != nullptr && (db->get_rows() != 1 || db->get_cols() != N))) {
+    throw std::invalid_argument(
+        "dense_backward_kernel: Dimensions mismatch. x " + shape_str(x) +
+        ", W " + shape_str(W) + ", dy " + shape_str(dy) + ".");
+  }
+  ProfileScope::add_counts(
+      4.0 * M * K * N + 3.0 * M * N,
+      4.0 * (M * K + K * N + 2 * M * N) + 4.0 * (K * N + M * K + N),
+      4.0 * (K * N + M * K + N));
+  dispatch_activation<DenseBackward>(
+      act, x.get_data_ptr(), W.get_data_ptr(), y.get_data_ptr(),
+      dy.get_data_ptr(), dx != nullptr ? dx->get_data_ptr() : nullptr,
+      dW.get_data_ptr(), db != nullptr ? db->get_data_ptr() : nullptr, M, K, N);
+}
+
+void dense_forward_kernel(const BF16Matrix& x, const BF16Matrix& W,
+                          const Matrix* b, Activation act, Matrix& out) {
+  const int M = x.rows;
+  const int K = x.cols;
+  const int N = W.cols;
+  if (W.rows != K || out.get_rows() != M || out.get_cols() != N ||
+      (b != nullptr && (b->get_rows() != 1 || b->get_cols() != N))) {
+    throw std::invalid_argument("dense_forward_kernel: Dimensions mismatch. x " +
+                                shape_str(x) + ", W " + shape_str(W) +
+                                ", out " + shape_str(out) + ".");
+  }
+  ProfileScope::add_counts(2.0 * M * K * N + 2.0 * M * N,
+                           2.0 * (M * K + K * N) + 4.0 * N, 4.0 * M * N);
+  dispatch_activation<DenseForward>(act, x.data.data(), W.data.data(),
+                                    b != nullptr ? b->get_data_ptr() : nullptr,
+                                    out.get_data_ptr(), M, K, N);
+}
+
+void dense_forward_kernel(const BF16Matrix& x, const BF16Matrix& W,
+                          const Matrix* b, Activation act, BF16Matrix& out) {
+  const int M = x.rows;
+  const int K = x.cols;
+  const int N = W.cols;
+  if (W.rows != K || out.rows != M || out.cols != N ||
+      (b != nullptr && (b->get_rows() != 1 || b->get_cols() != N))) {
+    throw std::invalid_argument("dense_forward_kernel: Dimensions mismatch. x " +
+                                shape_str(x) + ", W " + shape_str(W) +
+                                ", out " + shape_str(out) + ".");
+  }
+  ProfileScope::add_counts(2.0 * M * K * N + 2.0 * M * N,
+                           2.0 * (M * K + K * N) + 4.0 * N, 2.0 * M * N);
+  dispatch_activation<DenseForward>(act, x.data.data(), W.data.data(),
+                                    b != nullptr ? b->get_data_ptr() : nullptr,
+                                    out.data.data(), M, K, N);
+}
+
+void dense_backward_kernel(const BF16Matrix& x, const BF16Matrix& W,
+                           const Matrix& y, const Matrix& dy, Activation act,
+                           Matrix* dx, Matrix& dW, Matrix* db) {
+  const int M = x.rows;
+  const int K = x.cols;
+  const int N = W.cols;
+  if (W.rows != K || y.get_rows() != M || y.get_cols() != N ||
+      dy.get_rows() != M || dy.get_cols() != N || dW.get_rows() != K ||
+      dW.get_cols() != N ||
+      (dx != nullptr && (dx->get_rows() != M || dx->get_cols() != K)) ||
+      (db != nullptr && (db->get_rows() != 1 || db->get_cols() != N))) {
+    throw std::invalid_argument(
+        "dense_backward_kernel: Dimensions mismatch. x " + shape_str(x) +
+        ", W " + shape_str(W) + ", dy " + shape_str(dy) + ".");
+  }
+  ProfileScope::add_counts(
+      4.0 * M * K * N + 3.0 * M * N,
+      2.0 * (M * K + K * N) + 8.0 * M * N + 4.0 * (K * N + M * K + N),
+      4.0 * (K * N + M * K + N));
+  dispatch_activation<DenseBackward>(
+      act, x.data.data(), W.data.data(), y.get_data_ptr(), dy.get_data_ptr(),
+      dx != nullptr ? dx->get_data_ptr() : nullptr, dW.get_data_ptr(),
+      db != nullptr ? db->get_data_ptr() : nullptr, M, K, N);
+}
+
+void dense_backward_kernel(const BF16Matrix& x, const BF16Matrix& W,
+                           const BF16Matrix& y, const Matrix& dy, Activation act,
+                           Matrix* dx, Matrix& dW, Matrix* db) {
+  const int M = x.rows;
+  const int K = x.cols;
+  const int N = W.cols;
+  if (W.rows != K || y.rows != M || y.cols != N || dy.get_rows() != M ||
+      dy.get_cols() != N || dW.get_rows() != K || dW.get_cols() != N ||
+      (dx != nullptr && (dx->get_rows() != M || dx->get_cols() != K)) ||
+      (db != nullptr && (db->get_rows() != 1 || db->get_cols() != N))) {
+    throw std::invalid_argument(
+        "dense_backward_kernel: Dimensions mismatch. x " + shape_str(x) +
+        ", W " + shape_str(W) + ", dy " + shape_str(dy) + ".");
+  }
+  ProfileScope::add_counts(
+      4.0 * M * K * N + 3.0 * M * N,
+      2.0 * (M * K + K * N + M * N) + 4.0 * M * N + 4.0 * (K * N + M * K + N),
+      4.0 * (K * N + M * K + N));
+  dispatch_activation<DenseBackward>(
+      act, x.data.data(), W.data.data(), y.data.data(), dy.get_data_ptr(),
+      dx != nullptr ? dx->get_data_ptr() : nullptr, dW.get_data_ptr(),
+      db != nullptr ? db->get_data_ptr() : nullptr, M, K, N);
+}
+
+void argmax_rows_kernel(const Matrix& m, std::span<int> out) {
+  const int rows = m.get_rows();
+  const int cols = m.get_cols();
+  if (out.size() < static_cast<size_t>(rows) || cols < 1) {
+    throw std::invalid_argument("argmax_rows_kernel: output too small for " +
+                                shape_str(m) + ".");
+  }
+  ProfileScope::add_counts(static_cast<double>(rows) * cols,
+                           4.0 * rows * cols, 4.0 * rows);
+  const float* data = m.get_data_ptr();
+  // 分块保存当前最大值，块内的行在每一列上同时比较
+  constexpr int kBlock = 64;
+  float best[kBlock];
+  int index[kBlock];
+  for (int r0 = 0; r0 < rows; r0 += kBlock) {
+    const int n = std::min(kBlock, rows - r0);
+    const float* base = data + static_cast<size_t>(r0) * cols;
+    for (int i = 0; i < n; ++i) {
+      best[i] = base[static_cast<size_t>(i) * cols];
+      index[i] = 0;
+    }
+    for (int j = 1; j < cols; ++j) {
+      for (int i = 0; i < n; ++i) {
+        const float v = base[static_cast<size_t>(i) * cols + j];
+        const bool greater = v > best[i];
+        best[i] = greater ? v : best[i];
+        index[i] = greater ? j : index[i];
+      }
+    }
+    std::copy_n(index, n, out.begin() + r0);
+  }
+}
@@ -0,0 +1,52 @@
+#ifndef FUSED_KERNELS_H
+#define FUSED_KERNELS_H
+// 融合的全连接(dense)计算核：y = act(x * W + b)。
+// 前向在 GEMM 的尾声(epilogue)中完成偏置与激活，输出 tile
+// 还在寄存器/L1 中时就写回最终结果，避免 mul/add/激活 三次整矩阵遍历。
+
+#include <span>
+
+#include "../core/BFloat16.h"
+#include "../core/Matrix.h"
+
+enum class Activation { None, Relu, Sigmoid, Tanh };
+
+// GEMM 操作数的精度。BF16 时 x / W 以 bf16 参与乘法并在 fp32 中累加，
+// 偏置、梯度与主权重(master weights)保持 fp32。
+enum class Precision { FP32, BF16 };
+
+// out = act(x * W + b)，b 可以为空指针（不加偏置）。out 必须已是 MxN。
+void dense_forward_kernel(const Matrix& x, const Matrix& W, const Matrix* b,
+                          Activation act, Matrix& out);
+
+// 由保存的输出 y 与上游梯度 dy 一次遍历计算全部梯度，并累加到已有梯度上：
+//   dz = dy ⊙ act'(y)
+//   dW += xᵀ dz,  db += Σ_rows dz,  dx += dz Wᵀ
+// dx / db 为空指针时跳过对应的计算。
+void dense_backward_kernel(const Matrix& x, const Matrix& W, const Matrix& y,
+                           const Matrix& dy, Activation act, Matrix* dx,
+                           Matrix& dW, Matrix* db);
+
+// bf16 版本：x / W 为 bf16 副本，out 的每个元素舍入到 bf16 可表示的值。
+void dense_forward_kernel(const BF16Matrix& x, const BF16Matrix& W,
+                          const Matrix* b, Activation act, Matrix& out);
+
+// bf16 版本，输出直接在尾声中写成 bf16（混合精度下隐藏层的激活）。
+// out 必须已是 MxN。
+void dense_forward_kernel(const BF16Matrix& x, const BF16Matrix& W,
+                          const Matrix* b, Activation act, BF16Matrix& out);
+
+// bf16 版本：x / W 使用前向保存的 bf16 副本，梯度以 fp32 累加。
+void dense_backward_kernel(const BF16Matrix& x, const BF16Matrix& W,
+                           const Matrix& y, const Matrix& dy, Activation act,
+                           Matrix* dx, Matrix& dW, Matrix* db);
+// 同上，输出 y 以 bf16 保存
+void dense_backward_kernel(const BF16Matrix& x, const BF16Matrix& W,
+                           const BF16Matrix& y, const Matrix& dy, Activation act,
+                           Matrix* dx, Matrix& dW, Matrix* db);
+
+// 每行最大元素的列下标（并列时取最小的列），写入 out[0..rows)。
+// 按列扫描、在行之间做无分支的比较选择，内层循环可以向量化。
+void argmax_rows_kernel(const Matrix& m, std::span<int> out);
+
+#endif  // !FUSED_KERNELS_H
@@ -0,0 +1,102 @@
+#include "fusion.h"
+
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "fused_kernels.h"
+
+namespace {
+
+// 各个算子在 make_node 时记录的名字，pass 依赖它们识别算子类型。
+bool is_activation(const Node* n, Activation* act) {
+  if (n->name == "Sigmoid" || n->name == "Sigmoid_") {
+    *act = Activation::Sigmoid;
+    return true;
+  }
+  if (n->name == "Relu" || n->name == "Relu_") {
+    *act = Activation::Relu;
+    return true;
+  }
+  return false;
+}
+
+std::shared_ptr<Node> parent_at(const Node* n, size_t i) {
+  if (i >= n->parent.size()) return nullptr;
+  return n->parent[i].lock();
+}
+
+// 脱离计算图的中间节点：释放缓冲区与反向闭包持有的引用
+void detach(Node* n) {
+  n->value = Matrix(0, 0);
+  n->grad = Matrix(0, 0);
+  n->_backward = nullptr;
+  n->parent.clear();
+}
+
+}  // namespace
+
+int fuse_dense_chains(const std::shared_ptr<Node>& root) {
+  // 1. 与 Node::backward 相同的方式收集子图（后序，即拓扑序）
+  std::vector<std::shared_ptr<Node>> order;
+  std::unordered_set<Node*> visited;
+  std::function<void(Node*)> visit = [&](Node* node) {
+    visited.insert(node);
+    for (const auto& p : node->parent) {
+      if (auto sp = p.lock()) {
+        if (!visited.count(sp.get())) visit(sp.get());
+      }
+    }
+    order.push_back(node->shared_from_this());
+  };
+  visit(root.get());
+
+  // 2. 逆拓扑序扫描：先看到链尾，再沿输入找 add 与 mul。
+  //    中间节点只能被链内的下一个节点使用
+  int fused = 0;
+  std::unordered_set<Node*> removed;
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const std::shared_ptr<Node>& tail = *it;
+    if (removed.count(tail.get())) continue;
+
+    Activation act = Activation::None;
+    std::shared_ptr<Node> add;
+    if (is_activation(tail.get(), &act) && tail->parent.size() == 1) {
+      add = parent_at(tail.get(), 0);
+      if (!add || add->name != "add_broadcast" || add->consumers() != 1) continue;
+    } else if (tail->name == "add_broadcast") {
+      add = tail;
+    } else {
+      continue;
+    }
+    auto mm = parent_at(add.get(), 0);
+    auto b = parent_at(add.get(), 1);
+    if (!mm || !b || mm->name != "mul" || mm->consumers() != 1) continue;
+    auto x = parent_at(mm.get(), 0);
+    auto W = parent_at(mm.get(), 1);
+    if (!x || !W || x == W || x == b || W == b) continue;
+
+    // 3. 改写：链尾的值已经是 act(xW + b)，只需换掉输入与反向
+    tail->parent = {x, W, b};
+    tail->name = "dense";
+    tail->backward_reads_value = act != Activation::None;
+    std::weak_ptr<Node> tail_weak = tail;
+    tail->_backward = [x, W, b, act, tail_weak]() {
+      if (auto t = tail_weak.lock()) {
+        // 直接原地写三个梯度，需与并行反向中的其他写者互斥
+        std::scoped_lock lock(x->grad_mutex(), W->grad_mutex(), b->grad_mutex());
+        dense_backward_kernel(x->value, W->value, t->value, t->grad, act,
+                              &x->grad, W->grad, &b->grad);
+      }
+    };
+    detach(mm.get());
+    removed.insert(mm.get());
+    if (add != tail) {
+      detach(add.get());
+      removed.insert(add.get());
+    }
+    ++fused;
+  }
+  return fused;
+}
@@ -0,0 +1,23 @@
+#ifndef FUSION_H
+#define FUSION_H
+// 计算图优化：在已记录的计算图上做模式匹配，把
+//   act(add_with_broadcast(mul(X, W), b))  或  add_with_broadcast(mul(X, W), b)
+// （act 为 sigmoid / relu 及其原地版本）改写为一个与 dense() 相同的融合节点：
+// 链尾节点保留身份（下游算子的反向仍引用它），输入换成 {X, W, b}，反向换成
+// 一次遍历的融合 dense 反向；mul 与 add 的中间节点脱离计算图，其值与梯度
+// 缓冲区立即释放。
+//
+// 前向是即时执行(eager)的：pass 看到计算图时三个前向计算核已经执行完，
+// 改写节省的是反向的两次遍历与中间缓冲区。新代码应直接调用 dense()，
+// 前向也在 GEMM 的 epilogue 中完成偏置与激活。
+// 必须在前向完全构建完成、调用 root->backward() 之前执行。
+// 中间节点还有其他使用者（包括 root 子图之外的）时不融合该链。
+
+#include <memory>
+
+#include "../core/Node.h"
+
+// 返回被融合的链的数量。
+int fuse_dense_chains(const std::shared_ptr<Node>& root);
+
+#endif  // !FUSION_H
@@ -11,8 +11,8 @@
 
 // 随机平移（上下左右填0）
 void random_shift(Matrix& m, int max_shift) {
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
+  thread_local std::random_device rd;
+  thread_local std::mt19937 gen(rd());
   // 假设 image 是一个方形矩阵，所以直接用 get_rows() 或 get_cols() 都可以
   int size = m.get_rows();
   std::uniform_int_distribution<int> shift_dist(-max_shift, max_shift);
@@ -37,8 +37,8 @@ void random_shift(Matrix& m, int max_shift) {
 
 // 随机缩放（中心缩放，空白区域填0）
 void random_scale(Matrix& m, float min_scale, float max_scale) {
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
+  thread_local std::random_device rd;
+  thread_local std::mt19937 gen(rd());
   int size = m.get_rows();
   std::uniform_real_distribution<float> scale_dist(min_scale, max_scale);
   float scale = scale_dist(gen);
@@ -85,8 +85,8 @@ void random_scale(Matrix& m, float min_scale, float max_scale) {
 
 // 添加高斯噪声
 void add_gaussian_noise(Matrix& m, float mean, float stddev) {
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
+  thread_local std::random_device rd;
+  thread_local std::mt19937 gen(rd());
   std::normal_distribution<float> noise_dist(mean, stddev);
   for (int y = 0; y < m.get_rows(); ++y) {
     for (int x = 0; x < m.get_cols(); ++x) {
@@ -100,8 +100,8 @@ void add_gaussian_noise(Matrix& m, float mean, float stddev) {
 
 // 随机旋转（空白区域填0）
 void random_rotate(Matrix& m, float max_angle) {
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
+  thread_local std::random_device rd;
+  thread_local std::mt19937 gen(rd());
   std::uniform_real_distribution<float> angle_dist(-max_angle, max_angle);
   float angle_degrees = angle_dist(gen);
   if (std::abs(angle_degrees) < 1e-6) return;
@@ -142,13 +142,13 @@ void random_rotate(Matrix& m, float max_angle) {
 
 // 随机反转颜色（黑白翻转） - 这个函数你没有提供实现，我用你之前的代码补全
 void random_invert(Matrix& m, float prob) {
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
+  thread_local std::random_device rd;
+  thread_local std::mt19937 gen(rd());
   std::uniform_real_distribution<float> p_dist(0.0f, 1.0f);  // 避免与参数p冲突
   if (p_dist(gen) < prob) {
     for (int i = 0; i < m.get_rows() * m.get_cols(); ++i) {  // 遍历所有元素
-      m.get_data()[i] =
-          1.0f - m.get_data()[i];  // 假设 get_data() 返回 std::vector<float>&
+      // get_data() 返回覆盖整个矩阵的 std::span<float>
+      m.get_data()[i] = 1.0f - m.get_data()[i];
     }
   }
 }
@@ -156,8 +156,8 @@ void random_invert(Matrix& m, float prob) {
 // 随机擦除（随机区域置0）
 void random_erasing(Matrix& m, float erase_prob, float min_area_ratio,
                     float max_area_ratio) {
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
+  thread_local std::random_device rd;
+  thread_local std::mt19937 gen(rd());
   std::uniform_real_distribution<float> p(0.0f, 1.0f);
   if (p(gen) > erase_prob) return;
 
@@ -0,0 +1,301 @@
+#include "norm_kernels.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../core/Profiler.h"
+
+namespace {
+
+constexpr int kLanes = 8;
+
+std::string shape_str(const Matrix& m) {
+  return std::to_string(m.get_rows()) + "x" + std::to_string(m.get_cols());
+}
+
+bool is_row(const Matrix& m, int cols) {
+  return m.get_rows() == 1 && m.get_cols() == cols;
+}
+
+// 按列 Welford：逐行更新 F 个独立的 (mean, M2)，内层沿列连续可向量化
+void column_welford(const float* xp, int N, int F, float* mean, float* var) {
+  std::vector<float> m2(F, 0.0f);
+  for (int j = 0; j < F; ++j) mean[j] = 0.0f;
+  for (int i = 0; i < N; ++i) {
+    const float* row = xp + static_cast<long>(i) * F;
+    const float inv_n = 1.0f / static_cast<float>(i + 1);
+    for (int j = 0; j < F; ++j) {
+      const float d = row[j] - mean[j];
+      mean[j] += d * inv_n;
+      m2[j] += d * (row[j] - mean[j]);
+    }
+  }
+  const float inv_total = 1.0f / static_cast<float>(N);
+  for (int j = 0; j < F; ++j) var[j] = m2[j] * inv_total;
+}
+
+// 按行 Welford：kLanes 路独立累加后用 Chan 公式合并，避免串行依赖
+void row_welford(const float* row, int F, float& mean_out, float& var_out) {
+  float mean[kLanes] = {};
+  float m2[kLanes] = {};
+  const int chunks = F / kLanes;
+  for (int c = 0; c < chunks; ++c) {
+    const float* v = row + c * kLanes;
+    const float inv_n = 1.0f / static_cast<float>(c + 1);
+    for (int u = 0; u < kLanes; ++u) {
+      const float d = v[u] - mean[u];
+      mean[u] += d * inv_n;
+      m2[u] += d * (v[u] - mean[u]);
+    }
+  }
+  // 合并各路（每路样本数相同）
+  float n = static_cast<float>(chunks);
+  float total_mean = 0.0f;
+  float total_m2 = 0.0f;
+  float total_n = 0.0f;
+  if (chunks > 0) {
+    for (int u = 0; u < kLanes; ++u) {
+      const float new_n = total_n + n;
+      const float delta = mean[u] - total_mean;
+      total_mean += delta * n / new_n;
+      total_m2 += m2[u] + delta * delta * total_n * n / new_n;
+      total_n = new_n;
+    }
+  }
+  // 尾部元素逐个并入
+  for (int j = chunks * kLanes; j < F; ++j) {
+    total_n += 1.0f;
+    const float d = row[j] - total_mean;
+    total_mean += d / total_n;
+    total_m2 += d * (row[j] - total_mean);
+  }
+  mean_out = total_mean;
+  var_out = total_m2 / static_cast<float>(F);
+}
+
+}  // namespace
+
+void batch_norm_forward_kernel(const Matrix& x, const Matrix& gamma,
+                               const Matrix& beta, BatchNormState& state,
+                               bool training, Matrix& out, Matrix& mean,
+                               Matrix& inv_std) {
+  const int N = x.get_rows();
+  const int F = x.get_cols();
+  if (!is_row(gamma, F) || !is_row(beta, F) ||
+      !is_row(state.running_mean, F) || !is_row(state.running_var, F) ||
+      !is_row(mean, F) || !is_row(inv_std, F) || out.get_rows() != N ||
+      out.get_cols() != F) {
+    throw std::invalid_argument(
+        "batch_norm_forward_kernel: Dimensions mismatch. x " + shape_str(x) +
+        ", gamma " + shape_str(gamma) + ".");
+  }
+  if (training && N < 1) {
+    throw std::invalid_argument("batch_norm_forward_kernel: empty batch.");
+  }
+  float* mp = mean.get_data_ptr();
+  float* ip = inv_std.get_data_ptr();
+  float* rm = state.running_mean.get_data_ptr();
+  float* rv = state.running_var.get_data_ptr();
+
+  if (training) {
+    column_welford(x.get_data_ptr(), N, F, mp, ip);  // ip 暂存方差
+    const float unbias = N > 1 ? static_cast<float>(N) / (N - 1) : 1.0f;
+    const float m = state.momentum;
+    for (int j = 0; j < F; ++j) {
+      rm[j] = (1.0f - m) * rm[j] + m * mp[j];
+      rv[j] = (1.0f - m) * rv[j] + m * ip[j] * unbias;
+      ip[j] = 1.0f / std::sqrt(ip[j] + state.eps);
+    }
+  } else {
+    for (int j = 0; j < F; ++j) {
+      mp[j] = rm[j];
+      ip[j] = 1.0f / std::sqrt(rv[j] + state.eps);
+    }
+  }
+
+  // y = gamma * (x - mean) * inv_std + beta = x * a + c
+  std::vector<float> a(F), c(F);
+  const float* gp = gamma.get_data_ptr();
+  const float* bp = beta.get_data_ptr();
+  for (int j = 0; j < F; ++j) {
+    a[j] = gp[j] * ip[j];
+    c[j] = bp[j] - mp[j] * a[j];
+  }
+  const float* xp = x.get_data_ptr();
+  float* op = out.get_data_ptr();
+  for (int i = 0; i < N; ++i) {
+    const float* x_row = xp + static_cast<long>(i) * F;
+    float* o_row = op + static_cast<long>(i) * F;
+    for (int j = 0; j < F; ++j) o_row[j] = x_row[j] * a[j] + c[j];
+  }
+  ProfileScope::add_counts((training ? 7.0 : 2.0) * N * F,
+                           (training ? 8.0 : 4.0) * N * F, 4.0 * N * F);
+}
+
+void batch_norm_backward_kernel(const Matrix& x, const Matrix& gamma,
+                                const Matrix& mean, const Matrix& inv_std,
+                                const Matrix& dy, bool training, Matrix* dx,
+                                Matrix& dgamma, Matrix& dbeta) {
+  const int N = x.get_rows();
+  const int F = x.get_cols();
+  if (!is_row(gamma, F) || !is_row(mean, F) || !is_row(inv_std, F) ||
+      !is_row(dgamma, F) || !is_row(dbeta, F) || dy.get_rows() != N ||
+      dy.get_cols() != F ||
+      (dx != nullptr && (dx->get_rows() != N || dx->get_cols() != F))) {
+    throw std::invalid_argument(
+        "batch_norm_backward_kernel: Dimensions mismatch. x " + shape_str(x) +
+        ", dy " + shape_str(dy) + ".");
+  }
+  const float* xp = x.get_data_ptr();
+  const float* dyp = dy.get_data_ptr();
+  const float* mp = mean.get_data_ptr();
+  const float* ip = inv_std.get_data_ptr();
+  const float* gp = gamma.get_data_ptr();
+
+  // 第一遍：Σdy 与 Σdy·x̂
+  std::vector<float> sum_dy(F, 0.0f), sum_dy_xhat(F, 0.0f);
+  for (int i = 0; i < N; ++i) {
+    const float* x_row = xp + static_cast<long>(i) * F;
+    const float* g_row = dyp + static_cast<long>(i) * F;
+    for (int j = 0; j < F; ++j) {
+      sum_dy[j] += g_row[j];
+      sum_dy_xhat[j] += g_row[j] * (x_row[j] - mp[j]) * ip[j];
+    }
+  }
+  float* dgp = dgamma.get_data_ptr();
+  float* dbp = dbeta.get_data_ptr();
+  for (int j = 0; j < F; ++j) {
+    dgp[j] += sum_dy_xhat[j];
+    dbp[j] += sum_dy[j];
+  }
+  ProfileScope::add_counts(5.0 * N * F, 8.0 * N * F, 8.0 * F);
+  if (dx == nullptr) return;
+
+  // 第二遍：dx。推理模式下统计量是常数，dx = dy * gamma * inv_std
+  float* dxp = dx->get_data_ptr();
+  std::vector<float> scale(F), k_dy(F), k_xhat(F);
+  const float inv_n = 1.0f / static_cast<float>(N);
+  for (int j = 0; j < F; ++j) {
+    scale[j] = gp[j] * ip[j];
+    k_dy[j] = training ? sum_dy[j] * inv_n : 0.0f;
+    k_xhat[j] = training ? sum_dy_xhat[j] * inv_n : 0.0f;
+  }
+  for (int i = 0; i < N; ++i) {
+    const float* x_row = xp + static_cast<long>(i) * F;
+    const float* g_row = dyp + static_cast<long>(i) * F;
+    float* d_row = dxp + static_cast<long>(i) * F;
+    for (int j = 0; j < F; ++j) {
+      const float xhat = (x_row[j] - mp[j]) * ip[j];
+      d_row[j] += scale[j] * (g_row[j] - k_dy[j] - xhat * k_xhat[j]);
+    }
+  }
+  ProfileScope::add_counts(6.0 * N * F, 12.0 * N * F, 4.0 * N * F);
+}
+
+void layer_norm_forward_kernel(const Matrix& x, const Matrix& gamma,
+                               const Matrix& beta, float eps, Matrix& out,
+                               Matrix& mean, Matrix& inv_std) {
+  const int N = x.get_rows();
+  const int F = x.get_cols();
+  if (F < 1 || !is_row(gamma, F) || !is_row(beta, F) ||
+      mean.get_rows() != N || mean.get_cols() != 1 ||
+      inv_std.get_rows() != N || inv_std.get_cols() != 1 ||
+      out.get_rows() != N || out.get_cols() != F) {
+    throw std::invalid_argument(
+        "layer_norm_forward_kernel: Dimensions mismatch. x " + shape_str(x) +
+        ", gamma " + shape_str(gamma) + ".");
+  }
+  const float* xp = x.get_data_ptr();
+  const float* gp = gamma.get_data_ptr();
+  const float* bp = beta.get_data_ptr();
+  float* op = out.get_data_ptr();
+  float* mp = mean.get_data_ptr();
+  float* ip = inv_std.get_data_ptr();
+  for (int i = 0; i < N; ++i) {
+    const float* x_row = xp + static_cast<long>(i) * F;
+    float* o_row = op + static_cast<long>(i) * F;
+    float var;
+    row_welford(x_row, F, mp[i], var);
+    ip[i] = 1.0f / std::sqrt(var + eps);
+    const float m = mp[i];
+    const float inv = ip[i];
+    for (int j = 0; j < F; ++j) o_row[j] = (x_row[j] - m) * inv * gp[j] + bp[j];
+  }
+  ProfileScope::add_counts(9.0 * N * F, 8.0 * N * F + 8.0 * F,
+                           4.0 * N * F + 8.0 * N);
+}
+
+void layer_norm_backward_kernel(const Matrix& x, const Matrix& gamma,
+                                const Matrix& mean, const Matrix& inv_std,
+                                const Matrix& dy, Matrix* dx, Matrix& dgamma,
+                                Matrix& dbeta) {
+  const int N = x.get_rows();
+  const int F = x.get_cols();
+  if (!is_row(gamma, F) || !is_row(dgamma, F) || !is_row(dbeta, F) ||
+      mean.get_rows() != N || inv_std.get_rows() != N || dy.get_rows() != N ||
+      dy.get_cols() != F ||
+      (dx != nullptr && (dx->get_rows() != N || dx->get_cols() != F))) {
+    throw std::invalid_argument(
+        "layer_norm_backward_kernel: Dimensions mismatch. x " + shape_str(x) +
+        ", dy " + shape_str(dy) + ".");
+  }
+  const float* xp = x.get_data_ptr();
+  const float* dyp = dy.get_data_ptr();
+  const float* gp = gamma.get_data_ptr();
+  float* dgp = dgamma.get_data_ptr();
+  float* dbp = dbeta.get_data_ptr();
+  float* dxp = dx != nullptr ? dx->get_data_ptr() : nullptr;
+  const float inv_f = 1.0f / static_cast<float>(F);
+
+  for (int i = 0; i < N; ++i) {
+    const float* x_row = xp + static_cast<long>(i) * F;
+    const float* g_row = dyp + static_cast<long>(i) * F;
+    const float m = mean(i, 0);
+    const float inv = inv_std(i, 0);
+    // 一遍同时完成 dgamma / dbeta 与 dx 需要的两个行内求和
+    float sum_g = 0.0f;
+    float sum_g_xhat = 0.0f;
+    for (int j = 0; j < F; ++j) {
+      const float xhat = (x_row[j] - m) * inv;
+      const float g = g_row[j] * gp[j];
+      dgp[j] += g_row[j] * xhat;
+      dbp[j] += g_row[j];
+      sum_g += g;
+      sum_g_xhat += g * xhat;
+    }
+    if (dxp == nullptr) continue;
+    float* d_row = dxp + static_cast<long>(i) * F;
+    const float k_g = sum_g * inv_f;
+    const float k_xhat = sum_g_xhat * inv_f;
+    for (int j = 0; j < F; ++j) {
+      const float xhat = (x_row[j] - m) * inv;
+      d_row[j] += inv * (g_row[j] * gp[j] - k_g - xhat * k_xhat);
+    }
+  }
+  ProfileScope::add_counts(16.0 * N * F, 12.0 * N * F + 4.0 * F,
+                           4.0 * N * F + 8.0 * F);
+}
+
+void fold_batch_norm(Matrix& W, Matrix& b, const Matrix& gamma,
+                     const Matrix& beta, const BatchNormState& state) {
+  const int K = W.get_rows();
+  const int F = W.get_cols();
+  if (!is_row(b, F) || !is_row(gamma, F) || !is_row(beta, F) ||
+      !is_row(state.running_mean, F) || !is_row(state.running_var, F)) {
+    throw std::invalid_argument("fold_batch_norm: Dimensions mismatch. W " +
+                                shape_str(W) + ", gamma " + shape_str(gamma) +
+                                ".");
+  }
+  std::vector<float> a(F);
+  for (int j = 0; j < F; ++j) {
+    a[j] = gamma(0, j) / std::sqrt(state.running_var(0, j) + state.eps);
+    b(0, j) = a[j] * (b(0, j) - state.running_mean(0, j)) + beta(0, j);
+  }
+  float* wp = W.get_data_ptr();
+  for (int k = 0; k < K; ++k) {
+    float* w_row = wp + static_cast<long>(k) * F;
+    for (int j = 0; j < F; ++j) w_row[j] *= a[j];
+  }
+}
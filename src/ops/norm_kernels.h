@@ -0,0 +1,48 @@
+#ifndef NORM_KERNELS_H
+#define NORM_KERNELS_H
+// 归一化计算核。x 为 N x F，gamma / beta 为 1 x F。
+// 均值与方差用 Welford 算法一次遍历得到；缩放与平移合并成 y = x * a + c，
+// 输出只需再遍历一次。反向不保存 x̂，而是由 x 与保存的 mean / inv_std 重算。
+
+#include "../core/Matrix.h"
+
+// batch_norm 的推理用滑动统计量，训练时在前向中更新
+struct BatchNormState {
+  Matrix running_mean;
+  Matrix running_var;
+  float momentum = 0.1f;
+  float eps = 1e-5f;
+
+  explicit BatchNormState(int features)
+      : running_mean(1, features, 0.0f), running_var(1, features, 1.0f) {}
+};
+
+// 训练模式：按列统计本批的 mean / inv_std（1 x F）写入输出参数，
+// 并更新 state 的滑动统计量（方差用无偏估计）。
+// 推理模式：直接使用 state 的滑动统计量，mean / inv_std 同样写出供反向使用。
+void batch_norm_forward_kernel(const Matrix& x, const Matrix& gamma,
+                               const Matrix& beta, BatchNormState& state,
+                               bool training, Matrix& out, Matrix& mean,
+                               Matrix& inv_std);
+// 累加 dx、dgamma、dbeta；dx 为空时跳过。training 需与前向一致。
+void batch_norm_backward_kernel(const Matrix& x, const Matrix& gamma,
+                                const Matrix& mean, const Matrix& inv_std,
+                                const Matrix& dy, bool training, Matrix* dx,
+                                Matrix& dgamma, Matrix& dbeta);
+
+// 按行归一化；mean / inv_std 为 N x 1
+void layer_norm_forward_kernel(const Matrix& x, const Matrix& gamma,
+                               const Matrix& beta, float eps, Matrix& out,
+                               Matrix& mean, Matrix& inv_std);
+void layer_norm_backward_kernel(const Matrix& x, const Matrix& gamma,
+                                const Matrix& mean, const Matrix& inv_std,
+                                const Matrix& dy, Matrix* dx, Matrix& dgamma,
+                                Matrix& dbeta);
+
+// 把推理模式的 batch_norm 折叠进它前面的全连接层（y = x * W + b）：
+// W 的第 j 列乘以 a_j = gamma_j / sqrt(running_var_j + eps)，
+// b_j 变为 a_j * b_j + beta_j - a_j * running_mean_j。之后可以去掉 batch_norm。
+void fold_batch_norm(Matrix& W, Matrix& b, const Matrix& gamma,
+                     const Matrix& beta, const BatchNormState& state);
+
+#endif  // !NORM_KERNELS_H
@@ -1,36 +1,162 @@
 #include "ops.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "../core/Graph.h"
 #include "../core/Matrix.h"
+#include "../core/Philox.h"
+#include "../core/Profiler.h"
+#include "../core/ThreadPool.h"
+
+namespace {
+// 性能分析用：矩阵占用的字节数
+double bytes_of(const Matrix &m) {
+  return 4.0 * m.get_rows() * m.get_cols();
+}
 
-std::shared_ptr<Node> add(Graph &graph, std::shared_ptr<Node> a,
-                          std::shared_ptr<Node> b) {
-  Matrix c_value = a->value + b->value;
-  std::vector<std::weak_ptr<Node>> parents = {a, b};
+// dropout 的掩码由 (seed, step, 元素下标) 经 Philox 决定：u >= threshold
+// 的元素保留并乘以 scale。前向写 out = mask ⊙ in * scale，反向累加
+// out += mask ⊙ in * scale，两者生成的掩码完全相同，因此不必保存掩码。
+template <bool Accumulate>
+void apply_dropout_mask(const float *in, float *out, long n,
+                        uint32_t threshold, float scale, uint64_t seed,
+                        uint64_t step) {
+  const long blocks = n / 4;
+  for (long blk = 0; blk < blocks; ++blk) {
+    const philox::Block r = philox::random_block(seed, step, blk);
+    for (int u = 0; u < 4; ++u) {
+      const long i = blk * 4 + u;
+      const float v = r[u] >= threshold ? in[i] * scale : 0.0f;
+      if constexpr (Accumulate) {
+        out[i] += v;
+      } else {
+        out[i] = v;
+      }
+    }
+  }
+  if (blocks * 4 < n) {
+    const philox::Block r = philox::random_block(seed, step, blocks);
+    for (long i = blocks * 4; i < n; ++i) {
+      const float v = r[i - blocks * 4] >= threshold ? in[i] * scale : 0.0f;
+      if constexpr (Accumulate) {
+        out[i] += v;
+      } else {
+        out[i] = v;
+      }
+    }
+  }
+}
 
-  auto c = graph.make_node(std::move(c_value), parents, "add");
+long numel_of(const Matrix &m) {
+  return static_cast<long>(m.get_rows()) * m.get_cols();
+}
+
+// 激活函数及其导数，导数都用输出 y 表示，反向只需要保存的输出
+inline float relu_fn(float x) { return x > 0.0f ? x : 0.0f; }
+inline float relu_grad_fn(float y) { return y > 0.0f ? 1.0f : 0.0f; }
+inline float sigmoid_fn(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+inline float sigmoid_grad_fn(float y) { return y * (1.0f - y); }
+
+// out 可以与 in 相同（原地）
+template <typename F>
+void activation_forward(const float *in, float *out, long n, F f) {
+  for (long i = 0; i < n; ++i) out[i] = f(in[i]);
+}
+
+// 激活的反向，单次遍历、不产生临时矩阵：
+//   原地激活时 c.grad 与 a.grad 共享存储，直接 grad *= f'(y)；
+//   否则 a.grad += c.grad ⊙ f'(y)。
+template <typename Deriv>
+void activation_backward(Node &a, Node &c, Deriv deriv) {
+  const long n = numel_of(c.grad);
+  const float *y = c.value.get_data_ptr();
+  if (c.grad.shares_storage_with(a.grad)) {
+    float *g = c.grad.get_data_ptr();
+    for (long i = 0; i < n; ++i) g[i] *= deriv(y[i]);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(a.grad_mutex());
+  const float *g = c.grad.get_data_ptr();
+  float *dst = a.grad.get_data_ptr();
+  for (long i = 0; i < n; ++i) dst[i] += g[i] * deriv(y[i]);
+}
+
+// 原地激活：输出节点的 value 与 grad 分别和输入共享存储，
+// 输入随后被标记为已覆盖。调用者需先确认 a->can_overwrite_value()。
+template <typename F, typename Deriv>
+std::shared_ptr<Node> activation_inplace(Graph &graph,
+                                         const std::shared_ptr<Node> &a,
+                                         const std::string &name, F f,
+                                         Deriv deriv) {
+  float *v = a->value.get_data_ptr();
+  activation_forward(v, v, numel_of(a->value), f);
+  auto c = graph.make_node(Matrix::from_tensor(a->value), {a}, name);
+  // a 没有其他消费者，c 收到的梯度就是 a 的全部梯度，二者共用一块缓冲
+  c->grad = Matrix::from_tensor(a->grad);
+  a->mark_overwritten();
 
-  
   std::weak_ptr<Node> c_weak = c;
+  c->_backward = [a, c_weak, deriv]() {
+    if (auto c_shared = c_weak.lock()) {
+      activation_backward(*a, *c_shared, deriv);
+      ProfileScope::add_counts(2 * bytes_of(a->grad) / 4,
+                               2 * bytes_of(a->grad), bytes_of(a->grad));
+    }
+  };
+  return c;
+}
+// 逐元素二元运算的公共实现，按 NumPy 规则广播
+std::shared_ptr<Node> broadcast_binary(Graph &graph,
+                                       const std::shared_ptr<Node> &a,
+                                       const std::shared_ptr<Node> &b,
+                                       BinaryOp op, const char *name) {
+  ProfileScope scope(name);
+  auto [rows, cols] = broadcast_shape(a->value, b->value, name);
+  Matrix out(rows, cols);
+  broadcast_forward_kernel(op, a->value, b->value, out);
+
+  auto c = graph.make_node(std::move(out), {a, b}, name);
+  // 只有除法对 b 的导数用到输出 a / b
+  c->backward_reads_value = op == BinaryOp::Div;
 
-  c->_backward = [a, b, c_weak]() {
+  std::weak_ptr<Node> c_weak = c;
+  c->_backward = [a, b, op, c_weak]() {
     if (auto c_shared = c_weak.lock()) {
-      a->grad = a->grad + c_shared->grad;
-      b->grad = b->grad + c_shared->grad;
+      if (a == b) {
+        std::lock_guard<std::mutex> lock(a->grad_mutex());
+        broadcast_backward_kernel(op, a->value, b->value, c_shared->value,
+                                  c_shared->grad, &a->grad, &b->grad);
+      } else {
+        std::scoped_lock lock(a->grad_mutex(), b->grad_mutex());
+        broadcast_backward_kernel(op, a->value, b->value, c_shared->value,
+                                  c_shared->grad, &a->grad, &b->grad);
+      }
     }
   };
   return c;
 }
+}  // namespace
+
+std::shared_ptr<Node> add(Graph &graph, std::shared_ptr<Node> a,
+                          std::shared_ptr<Node> b) {
+  return broadcast_binary(graph, a, b, BinaryOp::Add, "add");
+}
 
 std::shared_ptr<Node> sum(Graph &graph, const std::shared_ptr<Node> a) {
+  ProfileScope scope("sum");
   Matrix m = a->value.sum();
+  ProfileScope::add_counts(bytes_of(a->value) / 4, bytes_of(a->value), 4);
   std::vector<std::weak_ptr<Node>> parents = {a};
   std::shared_ptr<Node> c = graph.make_node(m, parents, "sum");
+  c->backward_reads_value = false;
 
   std::weak_ptr<Node> c_weak = c;
 
@@ -41,125 +167,112 @@ std::shared_ptr<Node> sum(Graph &graph, const std::shared_ptr<Node> a) {
       Matrix grad_to_propagate(a->value.get_rows(), a->value.get_cols(),
                                upstream_grad_val);
 
-      a->grad = a->grad + grad_to_propagate;
+      a->accumulate_grad(grad_to_propagate);
+      ProfileScope::add_counts(bytes_of(a->grad) / 4, 2 * bytes_of(a->grad),
+                               2 * bytes_of(a->grad));
     }
   };
   return c;
 }
 std::shared_ptr<Node> mul(Graph &graph, std::shared_ptr<Node> a,
                           std::shared_ptr<Node> b) {
+  ProfileScope scope("mul");
   Matrix c_value = a->value * b->value;
+  ProfileScope::add_counts(
+      2.0 * a->value.get_rows() * a->value.get_cols() * b->value.get_cols(),
+      bytes_of(a->value) + bytes_of(b->value), bytes_of(c_value));
   std::vector<std::weak_ptr<Node>> parents = {a, b};
 
   auto c = graph.make_node(std::move(c_value), parents, "mul");
+  c->backward_reads_value = false;
 
   std::weak_ptr<Node> c_weak = c;
 
   c->_backward = [a, b, c_weak]() {
     if (auto c_shared = c_weak.lock()) {
-      a->grad = a->grad + c_shared->grad * b->value.transpose();
-      b->grad = b->grad + a->value.transpose() * c_shared->grad;
+      // dA 与 dB 相互独立，在线程池中执行反向时并发计算
+      parallel_invoke(
+          [&]() { a->accumulate_grad(c_shared->grad * b->value.transpose()); },
+          [&]() { b->accumulate_grad(a->value.transpose() * c_shared->grad); });
+      ProfileScope::add_counts(
+          4.0 * a->value.get_rows() * a->value.get_cols() * b->value.get_cols(),
+          2 * (bytes_of(a->value) + bytes_of(b->value) +
+               bytes_of(c_shared->grad)),
+          bytes_of(a->grad) + bytes_of(b->grad));
     }
   };
   return c;
 }
 
 std::shared_ptr<Node> sigmoid(Graph &graph, std::shared_ptr<Node> a) {
-  
-  int rows = a->value.get_rows();
-  int cols = a->value.get_cols();
-  Matrix m(rows, cols);  
-
-  for (int i = 0; i < rows; ++i) {
-    for (int j = 0; j < cols; ++j) {
-      
-      m(i, j) = 1.0f / (1.0f + std::exp(-a->value(i, j)));
-    }
-  }
-
-  
-  std::vector<std::weak_ptr<Node>> parents;
-  parents.push_back(a);
-  std::shared_ptr<Node> c =
-      graph.make_node(m, parents, "Sigmoid");  
-
-  
-  std::weak_ptr<Node> c_weak = c;  
+  ProfileScope scope("sigmoid");
+  ProfileScope::add_counts(4 * bytes_of(a->value) / 4, bytes_of(a->value),
+                           bytes_of(a->value));
+  Matrix m(a->value.get_rows(), a->value.get_cols());
+  activation_forward(a->value.get_data_ptr(), m.get_data_ptr(),
+                     numel_of(m), sigmoid_fn);
 
-  c->_backward = [a, c_weak]() {          
-    if (auto c_shared = c_weak.lock()) {  
-      Matrix upstream_grad = c_shared->grad;  
+  std::shared_ptr<Node> c = graph.make_node(std::move(m), {a}, "Sigmoid");
 
-      
-      
-      Matrix local_grad(a->value.get_rows(), a->value.get_cols());
-      for (int i = 0; i < local_grad.get_rows(); ++i) {
-        for (int j = 0; j < local_grad.get_cols(); ++j) {
-          float sigmoid_val =
-              c_shared->value(i, j);  
-          local_grad(i, j) = sigmoid_val * (1.0f - sigmoid_val);
-        }
-      }
-
-      
-      a->grad = a->grad + upstream_grad.element_mul(local_grad);
+  std::weak_ptr<Node> c_weak = c;
+  c->_backward = [a, c_weak]() {
+    if (auto c_shared = c_weak.lock()) {
+      activation_backward(*a, *c_shared, sigmoid_grad_fn);
+      ProfileScope::add_counts(3 * bytes_of(a->grad) / 4,
+                               3 * bytes_of(a->grad), bytes_of(a->grad));
     }
   };
-  return c;  
+  return c;
 }
+
 std::shared_ptr<Node> relu(Graph &graph, std::shared_ptr<Node> a) {
-  int rows = a->value.get_rows();
-  int cols = a->value.get_cols();
-  Matrix m(rows, cols);
-  for (int i = 0; i < rows; ++i) {
-    for (int j = 0; j < cols; ++j) {
-      m(i, j) = std::fmax(0.0f, a->value(i, j));
-    }
-  }
-  std::vector<std::weak_ptr<Node>> parents;
-  parents.push_back(a);
-  std::shared_ptr<Node> c = graph.make_node(m, parents, "Relu");
+  ProfileScope scope("relu");
+  ProfileScope::add_counts(bytes_of(a->value) / 4, bytes_of(a->value),
+                           bytes_of(a->value));
+  Matrix m(a->value.get_rows(), a->value.get_cols());
+  activation_forward(a->value.get_data_ptr(), m.get_data_ptr(),
+                     numel_of(m), relu_fn);
+
+  std::shared_ptr<Node> c = graph.make_node(std::move(m), {a}, "Relu");
 
   std::weak_ptr<Node> c_weak = c;
   c->_backward = [a, c_weak]() {
     if (auto c_shared = c_weak.lock()) {
-      Matrix upstream_grad = c_shared->grad;
-
-      
-      Matrix local_grad(a->value.get_rows(), a->value.get_cols());
-      for (int i = 0; i < local_grad.get_rows(); ++i) {
-        for (int j = 0; j < local_grad.get_cols(); ++j) {
-          local_grad(i, j) = (a->value(i, j) > 0.0f) ? 1.0f : 0.0f;
-        }
-      }
-
-      a->grad = a->grad + upstream_grad.element_mul(local_grad);
+      activation_backward(*a, *c_shared, relu_grad_fn);
+      ProfileScope::add_counts(2 * bytes_of(a->grad) / 4,
+                               3 * bytes_of(a->grad), bytes_of(a->grad));
     }
   };
   return c;
 }
 
+std::shared_ptr<Node> relu_(Graph &graph, const std::shared_ptr<Node> &a) {
+  if (!a->can_overwrite_value()) return relu(graph, a);
+  ProfileScope scope("relu_");
+  auto c = activation_inplace(graph, a, "Relu_", relu_fn, relu_grad_fn);
+  ProfileScope::add_counts(bytes_of(a->value) / 4, bytes_of(a->value),
+                           bytes_of(a->value));
+  return c;
+}
+
+std::shared_ptr<Node> sigmoid_(Graph &graph, const std::shared_ptr<Node> &a) {
+  if (!a->can_overwrite_value()) return sigmoid(graph, a);
+  ProfileScope scope("sigmoid_");
+  auto c =
+      activation_inplace(graph, a, "Sigmoid_", sigmoid_fn, sigmoid_grad_fn);
+  ProfileScope::add_counts(4 * bytes_of(a->value) / 4, bytes_of(a->value),
+                           bytes_of(a->value));
+  return c;
+}
 
 std::shared_ptr<Node> element_mul(Graph &graph, std::shared_ptr<Node> a,
                                   std::shared_ptr<Node> b) {
-  Matrix result_value = a->value.element_mul(b->value);
-  auto c = graph.make_node(std::move(result_value), {a, b}, "element_mul");
+  return broadcast_binary(graph, a, b, BinaryOp::Mul, "element_mul");
+}
 
-  std::weak_ptr<Node> c_weak = c;
-  c->_backward = [a, b, c_weak]() {
-    if (auto c_shared = c_weak.lock()) {
-      auto upstream_grad = c_shared->grad;
-      if (a == b) {
-        
-        a->grad = a->grad + (upstream_grad.element_mul(a->value) * 2.0f);
-      } else {
-        
-        a->grad = a->grad + upstream_grad.element_mul(b->value);
-        b->grad = b->grad + upstream_grad.element_mul(a->value);
-      }
-    }
-  };
-  return c;
+std::shared_ptr<Node> div(Graph &graph, const std::shared_ptr<Node> &a,
+                          const std::shared_ptr<Node> &b) {
+  return broadcast_binary(graph, a, b, BinaryOp::Div, "div");
 }
 
 
@@ -180,53 +293,273 @@ std::shared_ptr<Node> mse_loss(Graph &graph,
 
 std::shared_ptr<Node> sub(Graph &graph, std::shared_ptr<Node> a,
                           std::shared_ptr<Node> b) {
-  Matrix result_value = a->value - b->value;
-  auto c = graph.make_node(std::move(result_value), {a, b}, "sub");
+  return broadcast_binary(graph, a, b, BinaryOp::Sub, "sub");
+}
+std::shared_ptr<Node> add_with_broadcast(Graph &graph,
+                                         const std::shared_ptr<Node> &a,
+                                         const std::shared_ptr<Node> &b) {
+  // fuse_dense_chains 按名字识别偏置加法，并把 b 当作 dense 的偏置，
+  // 因此保留 (M,N) + (1,N) 的约定
+  if (a->value.get_cols() != b->value.get_cols() || b->value.get_rows() != 1) {
+    throw std::invalid_argument(
+        "Dimension mismatch for add_with_broadcast. Expected (M,N) + (1,N).");
+  }
+  return broadcast_binary(graph, a, b, BinaryOp::Add, "add_broadcast");
+}
+
+std::shared_ptr<Node> dense(Graph &graph, const std::shared_ptr<Node> &x,
+                            const std::shared_ptr<Node> &W,
+                            const std::shared_ptr<Node> &b,
+                            Activation activation, Precision precision,
+                            Precision output_precision) {
+  ProfileScope scope("dense");
+  if (x == W || (b && (b == x || b == W))) {
+    throw std::invalid_argument("dense: x, W and b must be distinct nodes.");
+  }
+  if (precision == Precision::FP32 &&
+      (output_precision == Precision::BF16 || x->bf16_only())) {
+    throw std::invalid_argument(
+        "dense: bf16-only inputs and outputs require Precision::BF16.");
+  }
+  std::vector<std::weak_ptr<Node>> parents = {x, W};
+  if (b) parents.push_back(b);
+
+  std::shared_ptr<Node> c;
+  // bf16 操作数优先使用节点上已有的 bf16 值（上一层的输出、参数的持久副本），
+  // 没有时才在这里转换；反向闭包共享持有它们
+  std::shared_ptr<const BF16Matrix> x16, W16;
+  if (precision == Precision::BF16) {
+    x16 = x->value16 ? x->value16 : std::make_shared<const BF16Matrix>(x->value);
+    W16 = W->value16 ? W->value16 : std::make_shared<const BF16Matrix>(W->value);
+    if (output_precision == Precision::BF16) {
+      auto out = std::make_shared<BF16Matrix>(x16->rows, W16->cols);
+      dense_forward_kernel(*x16, *W16, b ? &b->value : nullptr, activation, *out);
+      c = graph.make_node(std::move(out), parents, "dense", true);
+    } else {
+      Matrix out(x16->rows, W16->cols);
+      dense_forward_kernel(*x16, *W16, b ? &b->value : nullptr, activation, out);
+      c = graph.make_node(std::move(out), parents, "dense", true);
+    }
+  } else {
+    Matrix out(x->value.get_rows(), W->value.get_cols());
+    dense_forward_kernel(x->value, W->value, b ? &b->value : nullptr,
+                         activation, out);
+    c = graph.make_node(std::move(out), parents, "dense");
+  }
+  // 只有带激活的 dense 由输出 y 求导
+  c->backward_reads_value = activation != Activation::None;
 
   std::weak_ptr<Node> c_weak = c;
-  c->_backward = [a, b, c_weak]() {
+  c->_backward = [x, W, b, activation, x16, W16, c_weak]() {
     if (auto c_shared = c_weak.lock()) {
-      a->grad = a->grad + c_shared->grad;
-      b->grad = b->grad - c_shared->grad;
+      auto run = [&](Matrix *db) {
+        if (c_shared->value16) {
+          dense_backward_kernel(*x16, *W16, *c_shared->value16, c_shared->grad,
+                                activation, &x->grad, W->grad, db);
+        } else if (x16) {
+          dense_backward_kernel(*x16, *W16, c_shared->value, c_shared->grad,
+                                activation, &x->grad, W->grad, db);
+        } else {
+          dense_backward_kernel(x->value, W->value, c_shared->value,
+                                c_shared->grad, activation, &x->grad, W->grad,
+                                db);
+        }
+      };
+      // 计算核原地累加三个梯度，持锁以便与并行反向中的其他写者互斥
+      std::unique_lock<std::mutex> lock_x(x->grad_mutex(), std::defer_lock);
+      std::unique_lock<std::mutex> lock_w(W->grad_mutex(), std::defer_lock);
+      if (b) {
+        std::unique_lock<std::mutex> lock_b(b->grad_mutex(), std::defer_lock);
+        std::lock(lock_x, lock_w, lock_b);
+        run(&b->grad);
+      } else {
+        std::lock(lock_x, lock_w);
+        run(nullptr);
+      }
     }
   };
   return c;
 }
-std::shared_ptr<Node> add_with_broadcast(
-    Graph &graph,
-    const std::shared_ptr<Node> &a,    
-    const std::shared_ptr<Node> &b) {  
-  
-  if (a->value.get_cols() != b->value.get_cols() || b->value.get_rows() != 1) {
-    throw std::invalid_argument(
-        "Dimension mismatch for add_with_broadcast. Expected (M,N) + (1,N).");
+
+std::shared_ptr<Node> conv2d(Graph &graph, const std::shared_ptr<Node> &x,
+                             const std::shared_ptr<Node> &W,
+                             const std::shared_ptr<Node> &b,
+                             const Conv2dShape &shape) {
+  ProfileScope scope("conv2d");
+  if (x == W || (b && (b == x || b == W))) {
+    throw std::invalid_argument("conv2d: x, W and b must be distinct nodes.");
   }
+  Matrix out(x->value.get_rows(),
+             W->value.get_rows() * shape.out_height() * shape.out_width());
+  conv2d_forward_kernel(x->value, W->value, b ? &b->value : nullptr, shape,
+                        out);
 
-  
-  Matrix result_value = a->value;  
-  
-  for (int i = 0; i < a->value.get_rows(); ++i) {
-    for (int j = 0; j < a->value.get_cols(); ++j) {
-      result_value(i, j) += b->value(0, j);
+  std::vector<std::weak_ptr<Node>> parents = {x, W};
+  if (b) parents.push_back(b);
+  auto c = graph.make_node(std::move(out), parents, "conv2d");
+  c->backward_reads_value = false;
+
+  std::weak_ptr<Node> c_weak = c;
+  c->_backward = [x, W, b, shape, c_weak]() {
+    if (auto c_shared = c_weak.lock()) {
+      std::unique_lock<std::mutex> lock_x(x->grad_mutex(), std::defer_lock);
+      std::unique_lock<std::mutex> lock_w(W->grad_mutex(), std::defer_lock);
+      if (b) {
+        std::unique_lock<std::mutex> lock_b(b->grad_mutex(), std::defer_lock);
+        std::lock(lock_x, lock_w, lock_b);
+        conv2d_backward_kernel(x->value, W->value, c_shared->grad, shape,
+                               &x->grad, W->grad, &b->grad);
+      } else {
+        std::lock(lock_x, lock_w);
+        conv2d_backward_kernel(x->value, W->value, c_shared->grad, shape,
+                               &x->grad, W->grad, nullptr);
+      }
+    }
+  };
+  return c;
+}
+
+std::shared_ptr<Node> max_pool2d(Graph &graph, const std::shared_ptr<Node> &x,
+                                 const Pool2dShape &shape) {
+  ProfileScope scope("max_pool2d");
+  Matrix out(x->value.get_rows(),
+             shape.channels * shape.out_height() * shape.out_width());
+  std::vector<int32_t> argmax;
+  max_pool2d_forward_kernel(x->value, shape, out, argmax);
+
+  auto c = graph.make_node(std::move(out), {x}, "max_pool2d");
+  c->backward_reads_value = false;
+
+  std::weak_ptr<Node> c_weak = c;
+  c->_backward = [x, argmax = std::move(argmax), c_weak]() {
+    if (auto c_shared = c_weak.lock()) {
+      std::lock_guard<std::mutex> lock(x->grad_mutex());
+      max_pool2d_backward_kernel(c_shared->grad, argmax, x->grad);
     }
+  };
+  return c;
+}
+
+std::shared_ptr<Node> avg_pool2d(Graph &graph, const std::shared_ptr<Node> &x,
+                                 const Pool2dShape &shape) {
+  ProfileScope scope("avg_pool2d");
+  Matrix out(x->value.get_rows(),
+             shape.channels * shape.out_height() * shape.out_width());
+  avg_pool2d_forward_kernel(x->value, shape, out);
+
+  auto c = graph.make_node(std::move(out), {x}, "avg_pool2d");
+  c->backward_reads_value = false;
+
+  std::weak_ptr<Node> c_weak = c;
+  c->_backward = [x, shape, c_weak]() {
+    if (auto c_shared = c_weak.lock()) {
+      std::lock_guard<std::mutex> lock(x->grad_mutex());
+      avg_pool2d_backward_kernel(c_shared->grad, shape, x->grad);
+    }
+  };
+  return c;
+}
+
+std::shared_ptr<Node> batch_norm(Graph &graph, const std::shared_ptr<Node> &x,
+                                 const std::shared_ptr<Node> &gamma,
+                                 const std::shared_ptr<Node> &beta,
+                                 BatchNormState &state, bool training) {
+  ProfileScope scope("batch_norm");
+  if (x == gamma || x == beta || gamma == beta) {
+    throw std::invalid_argument(
+        "batch_norm: x, gamma and beta must be distinct nodes.");
   }
+  const int F = x->value.get_cols();
+  Matrix out(x->value.get_rows(), F);
+  Matrix mean(1, F);
+  Matrix inv_std(1, F);
+  batch_norm_forward_kernel(x->value, gamma->value, beta->value, state,
+                            training, out, mean, inv_std);
 
-  
-  auto c = graph.make_node(std::move(result_value), {a, b}, "add_broadcast");
+  auto c = graph.make_node(std::move(out), {x, gamma, beta}, "batch_norm");
+  c->backward_reads_value = false;
 
-  
   std::weak_ptr<Node> c_weak = c;
-  c->_backward = [a, b, c_weak]() {
+  c->_backward = [x, gamma, beta, training, mean = std::move(mean),
+                  inv_std = std::move(inv_std), c_weak]() {
     if (auto c_shared = c_weak.lock()) {
-      
-      a->grad = a->grad + c_shared->grad;
+      std::scoped_lock lock(x->grad_mutex(), gamma->grad_mutex(),
+                            beta->grad_mutex());
+      batch_norm_backward_kernel(x->value, gamma->value, mean, inv_std,
+                                 c_shared->grad, training, &x->grad,
+                                 gamma->grad, beta->grad);
+    }
+  };
+  return c;
+}
 
-      
-      
-      b->grad = b->grad + c_shared->grad.sum_rows();
+std::shared_ptr<Node> layer_norm(Graph &graph, const std::shared_ptr<Node> &x,
+                                 const std::shared_ptr<Node> &gamma,
+                                 const std::shared_ptr<Node> &beta,
+                                 float eps) {
+  ProfileScope scope("layer_norm");
+  if (x == gamma || x == beta || gamma == beta) {
+    throw std::invalid_argument(
+        "layer_norm: x, gamma and beta must be distinct nodes.");
+  }
+  const int N = x->value.get_rows();
+  Matrix out(N, x->value.get_cols());
+  Matrix mean(N, 1);
+  Matrix inv_std(N, 1);
+  layer_norm_forward_kernel(x->value, gamma->value, beta->value, eps, out,
+                            mean, inv_std);
+
+  auto c = graph.make_node(std::move(out), {x, gamma, beta}, "layer_norm");
+  c->backward_reads_value = false;
+
+  std::weak_ptr<Node> c_weak = c;
+  c->_backward = [x, gamma, beta, mean = std::move(mean),
+                  inv_std = std::move(inv_std), c_weak]() {
+    if (auto c_shared = c_weak.lock()) {
+      std::scoped_lock lock(x->grad_mutex(), gamma->grad_mutex(),
+                            beta->grad_mutex());
+      layer_norm_backward_kernel(x->value, gamma->value, mean, inv_std,
+                                 c_shared->grad, &x->grad, gamma->grad,
+                                 beta->grad);
     }
   };
+  return c;
+}
 
+std::shared_ptr<Node> dropout(Graph &graph, const std::shared_ptr<Node> &x,
+                              float p, uint64_t seed, uint64_t step,
+                              bool training) {
+  if (!(p >= 0.0f && p < 1.0f)) {
+    throw std::invalid_argument("dropout: p must be in [0, 1), got " +
+                                std::to_string(p) + ".");
+  }
+  if (!training || p == 0.0f) return x;
+  ProfileScope scope("dropout");
+
+  // 保留概率 1 - p：32 位随机数 >= p * 2^32 时保留
+  const uint32_t threshold =
+      static_cast<uint32_t>(std::min<double>(p * 4294967296.0, 4294967295.0));
+  const float scale = 1.0f / (1.0f - p);
+  const long n = static_cast<long>(x->value.get_rows()) * x->value.get_cols();
+  Matrix out(x->value.get_rows(), x->value.get_cols());
+  apply_dropout_mask<false>(x->value.get_data_ptr(), out.get_data_ptr(), n,
+                            threshold, scale, seed, step);
+  ProfileScope::add_counts(2.0 * n, bytes_of(out), bytes_of(out));
+
+  auto c = graph.make_node(std::move(out), {x}, "dropout");
+  c->backward_reads_value = false;
+
+  std::weak_ptr<Node> c_weak = c;
+  c->_backward = [x, threshold, scale, seed, step, c_weak]() {
+    if (auto c_shared = c_weak.lock()) {
+      const Matrix &dy = c_shared->grad;
+      const long n = static_cast<long>(dy.get_rows()) * dy.get_cols();
+      std::lock_guard<std::mutex> lock(x->grad_mutex());
+      apply_dropout_mask<true>(dy.get_data_ptr(), x->grad.get_data_ptr(), n,
+                               threshold, scale, seed, step);
+      ProfileScope::add_counts(3.0 * n, 2 * bytes_of(dy), bytes_of(dy));
+    }
+  };
   return c;
 }
 
@@ -259,6 +592,10 @@ Matrix softmax(const Matrix other) {
 
 std::shared_ptr<Node> softmax_cross_entropy_loss(
     Graph &graph, std::shared_ptr<Node> logits, std::shared_ptr<Node> targets) {
+  ProfileScope scope("softmax_cross_entropy_loss");
+  ProfileScope::add_counts(5 * bytes_of(logits->value) / 4,
+                           2 * bytes_of(logits->value),
+                           bytes_of(logits->value));
   
   Matrix logits_val = logits->value;
   Matrix probabilities = Matrix(logits_val.get_rows(), logits_val.get_cols());
@@ -315,9 +652,80 @@ std::shared_ptr<Node> softmax_cross_entropy_loss(
                     (1.0f / static_cast<float>(probabilities.get_rows()));
 
       
-      logits->grad = logits->grad + grad;
+      logits->accumulate_grad(grad);
+      ProfileScope::add_counts(3 * bytes_of(grad) / 4, 4 * bytes_of(grad),
+                               2 * bytes_of(grad));
     }
   };
 
   return loss_node;
 }
+
+std::shared_ptr<Node> sparse_softmax_cross_entropy_loss(
+    Graph &graph, const std::shared_ptr<Node> &logits,
+    const std::vector<int> &labels) {
+  ProfileScope scope("sparse_softmax_cross_entropy_loss");
+  if (logits->bf16_only()) {
+    throw std::invalid_argument(
+        "sparse_softmax_cross_entropy_loss: logits must be fp32, got the "
+        "bf16-only output of '" + logits->name + "'.");
+  }
+  const int rows = logits->value.get_rows();
+  const int cols = logits->value.get_cols();
+  if (static_cast<int>(labels.size()) != rows) {
+    throw std::invalid_argument(
+        "sparse_softmax_cross_entropy_loss: labels size " +
+        std::to_string(labels.size()) + " != logits rows " +
+        std::to_string(rows) + ".");
+  }
+
+  // grad 即反向需要的全部信息：(softmax(logits) - onehot) / rows
+  Matrix grad(rows, cols);
+  const float *lp = logits->value.get_data_ptr();
+  float *gp = grad.get_data_ptr();
+  const float inv_rows = 1.0f / static_cast<float>(rows);
+  double total_loss = 0.0;
+
+  for (int i = 0; i < rows; ++i) {
+    const float *l_row = lp + static_cast<long>(i) * cols;
+    float *g_row = gp + static_cast<long>(i) * cols;
+    const int label = labels[i];
+    if (label < 0 || label >= cols) {
+      throw std::out_of_range("sparse_softmax_cross_entropy_loss: label " +
+                              std::to_string(label) + " out of range.");
+    }
+
+    float max_logit = l_row[0];
+    for (int j = 1; j < cols; ++j) max_logit = std::max(max_logit, l_row[j]);
+
+    // exp 的结果先暂存在梯度行里，求和后再整体缩放
+    float sum_exp = 0.0f;
+    for (int j = 0; j < cols; ++j) {
+      g_row[j] = std::exp(l_row[j] - max_logit);
+      sum_exp += g_row[j];
+    }
+
+    // -log(p_label) = log(sum_exp) - (l_label - max)
+    total_loss += std::log(sum_exp) - (l_row[label] - max_logit);
+
+    const float scale = inv_rows / sum_exp;
+    for (int j = 0; j < cols; ++j) g_row[j] *= scale;
+    g_row[label] -= inv_rows;
+  }
+  ProfileScope::add_counts(5.0 * rows * cols, bytes_of(logits->value),
+                           bytes_of(grad));
+
+  Matrix loss_matrix(1, 1, static_cast<float>(total_loss * inv_rows));
+  auto loss_node = graph.make_node(std::move(loss_matrix), {logits},
+                                   "sparse_softmax_cross_entropy_loss");
+
+  std::weak_ptr<Node> loss_node_weak = loss_node;
+  loss_node->_backward = [logits, grad = std::move(grad), loss_node_weak]() {
+    if (auto loss_shared = loss_node_weak.lock()) {
+      logits->accumulate_grad(grad, loss_shared->grad(0, 0));
+      ProfileScope::add_counts(2.0 * grad.get_rows() * grad.get_cols(),
+                               2 * bytes_of(grad), bytes_of(grad));
+    }
+  };
+  return loss_node;
+}
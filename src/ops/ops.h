@@ -1,12 +1,20 @@
 #ifndef OPS_H
 #define OPS_H
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "../core/Graph.h"
 #include "../core/Matrix.h"
+#include "broadcast_kernels.h"
+#include "conv_kernels.h"
+#include "fused_kernels.h"
+#include "norm_kernels.h"
+#include "pool_kernels.h"
 
-// 生明加法运算函数
+// add / sub / element_mul / div 按 NumPy 规则广播：每一维相等或其中一个为 1。
+// 被广播的操作数不会展开，反向把梯度沿广播维度求和。
 std::shared_ptr<Node> add(Graph& graph, std::shared_ptr<Node> a,
                           std::shared_ptr<Node> b);
 
@@ -18,6 +26,12 @@ std::shared_ptr<Node> sum(Graph& graph, std::shared_ptr<Node> a);
 std::shared_ptr<Node> relu(Graph& graph, std::shared_ptr<Node> a);
 
 std::shared_ptr<Node> sigmoid(Graph& graph, std::shared_ptr<Node> a);
+
+// 原地版本：当 a->can_overwrite_value() 成立时直接覆盖 a 的值，输出节点与 a
+// 共用 value 和 grad 的存储，反向单次遍历完成 grad *= f'(y)；之后 a 不能再
+// 作为其他算子的输入。条件不满足时退化为普通的 relu / sigmoid。
+std::shared_ptr<Node> relu_(Graph& graph, const std::shared_ptr<Node>& a);
+std::shared_ptr<Node> sigmoid_(Graph& graph, const std::shared_ptr<Node>& a);
 std::shared_ptr<Node> sub(Graph& graph, std::shared_ptr<Node> a,
                           std::shared_ptr<Node> b);
 
@@ -27,10 +41,64 @@ std::shared_ptr<Node> mse_loss(Graph& graph,
 
 std::shared_ptr<Node> element_mul(Graph& graph, std::shared_ptr<Node> a,
                                   std::shared_ptr<Node> b);
+std::shared_ptr<Node> div(Graph& graph, const std::shared_ptr<Node>& a,
+                          const std::shared_ptr<Node>& b);
 
+// 偏置加法 (M,N) + (1,N)，融合 pass（见 fusion.h）按名字 "add_broadcast" 识别它
 std::shared_ptr<Node> add_with_broadcast(Graph& graph,
                                          const std::shared_ptr<Node>& a,
                                          const std::shared_ptr<Node>& b);
+// 全连接层 y = act(x * W + b)，前向在 GEMM 尾声中完成偏置与激活，
+// 反向由保存的输出一次遍历算出 dW、db、dx。b 可以为空。
+// precision 为 BF16 时混合精度计算：节点中的 W 仍是 fp32 主权重，GEMM 读取
+// x / W 的 bf16 形式（节点有 value16 时直接使用，否则本次调用转换一份），
+// 梯度以 fp32 累加，优化器直接更新 fp32 主权重。output_precision 为 BF16 时
+// 输出节点只保存 bf16 的值（见 Node::value16），只能作为下一层 bf16 dense 的
+// 输入，交给其他算子时 Graph::make_node 抛出 std::invalid_argument；
+// 为 FP32 时输出舍入到 bf16 可表示的值，以 fp32 保存（如交给损失的 logits）。
+std::shared_ptr<Node> dense(Graph& graph, const std::shared_ptr<Node>& x,
+                            const std::shared_ptr<Node>& W,
+                            const std::shared_ptr<Node>& b,
+                            Activation activation = Activation::None,
+                            Precision precision = Precision::FP32,
+                            Precision output_precision = Precision::FP32);
+
+// 批量二维卷积。x 为 N x (C*H*W)（每行一张 NCHW 展平的图），
+// W 为 OC x (C*K*K)，b 为 1 x OC 或空；输出 N x (OC*OH*OW)。
+// 3x3 步长 1 使用直接卷积，其余尺寸使用 im2col + GEMM。
+std::shared_ptr<Node> conv2d(Graph& graph, const std::shared_ptr<Node>& x,
+                             const std::shared_ptr<Node>& W,
+                             const std::shared_ptr<Node>& b,
+                             const Conv2dShape& shape);
+
+// 二维最大池化 / 平均池化，布局同 conv2d：N x (C*H*W) -> N x (C*OH*OW)。
+// 最大池化前向保存 argmax 下标，反向直接散射梯度。2x2 步长 2 有专门的快速路径。
+std::shared_ptr<Node> max_pool2d(Graph& graph, const std::shared_ptr<Node>& x,
+                                 const Pool2dShape& shape);
+std::shared_ptr<Node> avg_pool2d(Graph& graph, const std::shared_ptr<Node>& x,
+                                 const Pool2dShape& shape);
+
+// 批归一化，x 为 N x F，gamma / beta 为 1 x F。训练模式使用本批统计量并
+// 更新 state 的滑动统计量；推理模式使用滑动统计量，可用 fold_batch_norm
+// 折叠进前一层 dense 的权重。
+std::shared_ptr<Node> batch_norm(Graph& graph, const std::shared_ptr<Node>& x,
+                                 const std::shared_ptr<Node>& gamma,
+                                 const std::shared_ptr<Node>& beta,
+                                 BatchNormState& state, bool training = true);
+// 层归一化：对每行的 F 个特征归一化
+std::shared_ptr<Node> layer_norm(Graph& graph, const std::shared_ptr<Node>& x,
+                                 const std::shared_ptr<Node>& gamma,
+                                 const std::shared_ptr<Node>& beta,
+                                 float eps = 1e-5f);
+
+// dropout：以概率 p 置零，保留的元素乘以 1 / (1 - p)。
+// 掩码由计数器型 RNG 按 (seed, step, 元素下标) 生成，反向重新生成而不保存，
+// 结果与线程数无关。每个训练步应传入不同的 step。
+// training 为 false 或 p 为 0 时直接返回 x。
+std::shared_ptr<Node> dropout(Graph& graph, const std::shared_ptr<Node>& x,
+                              float p, uint64_t seed, uint64_t step,
+                              bool training = true);
+
 Matrix one_hot_encode(const Matrix& Y_labels, int num_classes = 10);
 
 Matrix softmax(const Matrix other);
@@ -38,4 +106,10 @@ Matrix softmax(const Matrix other);
 std::shared_ptr<Node> softmax_cross_entropy_loss(Graph& graph,
                                                  std::shared_ptr<Node> logits,
                                                  std::shared_ptr<Node> target);
+
+// 以类别下标作为标签的 softmax 交叉熵，无需 one-hot 目标矩阵。
+// 每行一次遍历完成 max/exp/sum/log 与梯度计算，只为反向保存梯度本身。
+std::shared_ptr<Node> sparse_softmax_cross_entropy_loss(
+    Graph& graph, const std::shared_ptr<Node>& logits,
+    const std::vector<int>& labels);
 #endif  // !OPS_H
@@ -0,0 +1,232 @@
+#include "pool_kernels.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "../core/Profiler.h"
+
+namespace {
+
+std::string shape_str(const Matrix& m) {
+  return std::to_string(m.get_rows()) + "x" + std::to_string(m.get_cols());
+}
+
+void check_shapes(const char* who, const Matrix& x, const Pool2dShape& s,
+                  const Matrix& out) {
+  if (s.channels <= 0 || s.kernel_size <= 0 || s.stride <= 0 ||
+      s.out_height() <= 0 || s.out_width() <= 0) {
+    throw std::invalid_argument(std::string(who) + ": invalid pool geometry.");
+  }
+  if (x.get_cols() != s.channels * s.height * s.width ||
+      out.get_rows() != x.get_rows() ||
+      out.get_cols() != s.channels * s.out_height() * s.out_width()) {
+    throw std::invalid_argument(std::string(who) + ": Dimensions mismatch. x " +
+                                shape_str(x) + ", out " + shape_str(out) + ".");
+  }
+}
+
+// 以下每个函数处理一个 H x W 的平面；base 是平面首元素在样本行内的列号，
+// 用于把 argmax 记录成行内下标。内层循环都沿输出的 ox 连续，便于向量化。
+
+// 2x2、步长 2：两行两列四个数直接比较，无窗口循环
+void max_plane_2x2(const float* in, int W, int OH, int OW, int32_t base,
+                   float* out, int32_t* idx) {
+  for (int oy = 0; oy < OH; ++oy) {
+    const float* r0 = in + static_cast<long>(2 * oy) * W;
+    const float* r1 = r0 + W;
+    const int32_t i0 = base + 2 * oy * W;
+    float* o = out + static_cast<long>(oy) * OW;
+    int32_t* id = idx + static_cast<long>(oy) * OW;
+    for (int ox = 0; ox < OW; ++ox) {
+      const float a = r0[2 * ox], b = r0[2 * ox + 1];
+      const float c = r1[2 * ox], d = r1[2 * ox + 1];
+      const bool top_right = b > a;
+      const float top = top_right ? b : a;
+      const bool bottom_right = d > c;
+      const float bottom = bottom_right ? d : c;
+      const bool use_bottom = bottom > top;
+      o[ox] = use_bottom ? bottom : top;
+      id[ox] = i0 + 2 * ox +
+               (use_bottom ? W + static_cast<int>(bottom_right)
+                           : static_cast<int>(top_right));
+    }
+  }
+}
+
+void max_plane(const float* in, const Pool2dShape& s, int32_t base,
+               float* out, int32_t* idx) {
+  const int W = s.width;
+  const int OH = s.out_height();
+  const int OW = s.out_width();
+  for (int oy = 0; oy < OH; ++oy) {
+    float* o = out + static_cast<long>(oy) * OW;
+    int32_t* id = idx + static_cast<long>(oy) * OW;
+    for (int ox = 0; ox < OW; ++ox) {
+      o[ox] = -std::numeric_limits<float>::infinity();
+      id[ox] = base + oy * s.stride * W + ox * s.stride;
+    }
+    for (int ky = 0; ky < s.kernel_size; ++ky) {
+      const int iy = oy * s.stride + ky;
+      const float* row = in + static_cast<long>(iy) * W;
+      for (int kx = 0; kx < s.kernel_size; ++kx) {
+        const int32_t i0 = base + iy * W + kx;
+        for (int ox = 0; ox < OW; ++ox) {
+          const float v = row[ox * s.stride + kx];
+          const bool better = v > o[ox];
+          o[ox] = better ? v : o[ox];
+          id[ox] = better ? i0 + ox * s.stride : id[ox];
+        }
+      }
+    }
+  }
+}
+
+void avg_plane_2x2(const float* in, int W, int OH, int OW, float* out) {
+  for (int oy = 0; oy < OH; ++oy) {
+    const float* r0 = in + static_cast<long>(2 * oy) * W;
+    const float* r1 = r0 + W;
+    float* o = out + static_cast<long>(oy) * OW;
+    for (int ox = 0; ox < OW; ++ox) {
+      o[ox] = 0.25f * (r0[2 * ox] + r0[2 * ox + 1] + r1[2 * ox] +
+                       r1[2 * ox + 1]);
+    }
+  }
+}
+
+void avg_plane(const float* in, const Pool2dShape& s, float* out) {
+  const int W = s.width;
+  const int OH = s.out_height();
+  const int OW = s.out_width();
+  const float inv = 1.0f / static_cast<float>(s.kernel_size * s.kernel_size);
+  for (int oy = 0; oy < OH; ++oy) {
+    float* o = out + static_cast<long>(oy) * OW;
+    for (int ox = 0; ox < OW; ++ox) o[ox] = 0.0f;
+    for (int ky = 0; ky < s.kernel_size; ++ky) {
+      const float* row = in + static_cast<long>(oy * s.stride + ky) * W;
+      for (int kx = 0; kx < s.kernel_size; ++kx) {
+        for (int ox = 0; ox < OW; ++ox) o[ox] += row[ox * s.stride + kx];
+      }
+    }
+    for (int ox = 0; ox < OW; ++ox) o[ox] *= inv;
+  }
+}
+
+void avg_plane_backward(const float* dy, const Pool2dShape& s, float* dx) {
+  const int W = s.width;
+  const int OH = s.out_height();
+  const int OW = s.out_width();
+  const float inv = 1.0f / static_cast<float>(s.kernel_size * s.kernel_size);
+  for (int oy = 0; oy < OH; ++oy) {
+    const float* g = dy + static_cast<long>(oy) * OW;
+    for (int ky = 0; ky < s.kernel_size; ++ky) {
+      float* row = dx + static_cast<long>(oy * s.stride + ky) * W;
+      for (int kx = 0; kx < s.kernel_size; ++kx) {
+        for (int ox = 0; ox < OW; ++ox) row[ox * s.stride + kx] += g[ox] * inv;
+      }
+    }
+  }
+}
+
+bool is_2x2_stride2(const Pool2dShape& s) {
+  return s.kernel_size == 2 && s.stride == 2;
+}
+
+}  // namespace
+
+void max_pool2d_forward_kernel(const Matrix& x, const Pool2dShape& shape,
+                               Matrix& out, std::vector<int32_t>& argmax) {
+  check_shapes("max_pool2d_forward_kernel", x, shape, out);
+  const int N = x.get_rows();
+  const int C = shape.channels;
+  const int H = shape.height;
+  const int W = shape.width;
+  const int OH = shape.out_height();
+  const int OW = shape.out_width();
+  const long in_plane = static_cast<long>(H) * W;
+  const long out_plane = static_cast<long>(OH) * OW;
+  argmax.resize(static_cast<size_t>(N) * C * out_plane);
+  ProfileScope::add_counts(
+      static_cast<double>(N) * C * out_plane * shape.kernel_size *
+          shape.kernel_size,
+      4.0 * N * C * in_plane, 8.0 * N * C * out_plane);
+
+  const float* xp = x.get_data_ptr();
+  float* op = out.get_data_ptr();
+  for (long p = 0; p < static_cast<long>(N) * C; ++p) {
+    // 平面 p 是第 p / C 个样本的第 p % C 个通道
+    const int32_t base = static_cast<int32_t>((p % C) * in_plane);
+    if (is_2x2_stride2(shape)) {
+      max_plane_2x2(xp + p * in_plane, W, OH, OW, base, op + p * out_plane,
+                    argmax.data() + p * out_plane);
+    } else {
+      max_plane(xp + p * in_plane, shape, base, op + p * out_plane,
+                argmax.data() + p * out_plane);
+    }
+  }
+}
+
+void max_pool2d_backward_kernel(const Matrix& dy,
+                                const std::vector<int32_t>& argmax,
+                                Matrix& dx) {
+  const int N = dy.get_rows();
+  const int cols = dy.get_cols();
+  if (argmax.size() != static_cast<size_t>(N) * cols || dx.get_rows() != N) {
+    throw std::invalid_argument(
+        "max_pool2d_backward_kernel: Dimensions mismatch. dy " +
+        shape_str(dy) + ", dx " + shape_str(dx) + ".");
+  }
+  ProfileScope::add_counts(static_cast<double>(N) * cols, 8.0 * N * cols,
+                           4.0 * N * cols);
+  const float* gp = dy.get_data_ptr();
+  float* dxp = dx.get_data_ptr();
+  const long dx_cols = dx.get_cols();
+  for (int n = 0; n < N; ++n) {
+    const float* g = gp + static_cast<long>(n) * cols;
+    const int32_t* id = argmax.data() + static_cast<long>(n) * cols;
+    float* d = dxp + n * dx_cols;
+    for (int j = 0; j < cols; ++j) d[id[j]] += g[j];
+  }
+}
+
+void avg_pool2d_forward_kernel(const Matrix& x, const Pool2dShape& shape,
+                               Matrix& out) {
+  check_shapes("avg_pool2d_forward_kernel", x, shape, out);
+  const long planes = static_cast<long>(x.get_rows()) * shape.channels;
+  const long in_plane = static_cast<long>(shape.height) * shape.width;
+  const long out_plane =
+      static_cast<long>(shape.out_height()) * shape.out_width();
+  ProfileScope::add_counts(
+      static_cast<double>(planes) * out_plane * shape.kernel_size *
+          shape.kernel_size,
+      4.0 * planes * in_plane, 4.0 * planes * out_plane);
+
+  const float* xp = x.get_data_ptr();
+  float* op = out.get_data_ptr();
+  for (long p = 0; p < planes; ++p) {
+    if (is_2x2_stride2(shape)) {
+      avg_plane_2x2(xp + p * in_plane, shape.width, shape.out_height(),
+                    shape.out_width(), op + p * out_plane);
+    } else {
+      avg_plane(xp + p * in_plane, shape, op + p * out_plane);
+    }
+  }
+}
+
+void avg_pool2d_backward_kernel(const Matrix& dy, const Pool2dShape& shape,
+                                Matrix& dx) {
+  check_shapes("avg_pool2d_backward_kernel", dx, shape, dy);
+  const long planes = static_cast<long>(dx.get_rows()) * shape.channels;
+  const long in_plane = static_cast<long>(shape.height) * shape.width;
+  const long out_plane =
+      static_cast<long>(shape.out_height()) * shape.out_width();
+  ProfileScope::add_counts(
+      2.0 * planes * out_plane * shape.kernel_size * shape.kernel_size,
+      4.0 * planes * (out_plane + in_plane), 4.0 * planes * in_plane);
+
+  const float* gp = dy.get_data_ptr();
+  float* dxp = dx.get_data_ptr();
+  for (long p = 0; p < planes; ++p) {
+    avg_plane_backward(gp + p * out_plane, shape, dxp + p * in_plane);
+  }
+}
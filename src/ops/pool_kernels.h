@@ -0,0 +1,41 @@
+#ifndef POOL_KERNELS_H
+#define POOL_KERNELS_H
+// 二维池化计算核。布局与 conv2d 相同：x 为 N x (C*H*W)，输出 N x (C*OH*OW)。
+// 窗口完全落在图内（无填充），不足一个窗口的边缘行列被丢弃。
+
+#include <cstdint>
+#include <vector>
+
+#include "../core/Matrix.h"
+
+struct Pool2dShape {
+  int channels = 1;
+  int height = 0;
+  int width = 0;
+  int kernel_size = 2;
+  int stride = 2;
+
+  [[nodiscard]] int out_height() const {
+    return (height - kernel_size) / stride + 1;
+  }
+  [[nodiscard]] int out_width() const {
+    return (width - kernel_size) / stride + 1;
+  }
+};
+
+// 最大池化。argmax 大小为 N*C*OH*OW，记录每个输出取自该样本行内的哪一列，
+// 反向直接按下标散射梯度，不需要重新比较。窗口内有相等的最大值时取第一个。
+void max_pool2d_forward_kernel(const Matrix& x, const Pool2dShape& shape,
+                               Matrix& out, std::vector<int32_t>& argmax);
+// dx[n, argmax] += dy
+void max_pool2d_backward_kernel(const Matrix& dy,
+                                const std::vector<int32_t>& argmax,
+                                Matrix& dx);
+
+void avg_pool2d_forward_kernel(const Matrix& x, const Pool2dShape& shape,
+                               Matrix& out);
+// 每个窗口内的 dx 累加 dy / (K*K)
+void avg_pool2d_backward_kernel(const Matrix& dy, const Pool2dShape& shape,
+                                Matrix& dx);
+
+#endif  // !POOL_KERNELS_H
@@ -2,6 +2,7 @@
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include "LoadImage.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -87,7 +88,8 @@ Matrix LoadImage::image_to_mnist(const std::string& image_path, int num) {
   }
 
   Matrix m(1, target_size * target_size);
-  m.get_data().assign(final_matrix_data.begin(), final_matrix_data.end());
+  std::copy(final_matrix_data.begin(), final_matrix_data.end(),
+            m.get_data().begin());
   return m;
 }
 
@@ -138,7 +140,7 @@ Matrix LoadImage::image_to_mnist(const std::string& image_path) {
 
   Matrix m(1, target_size * target_size);
 
-  m.get_data().assign(final_matrix.begin(), final_matrix.end());
+  std::copy(final_matrix.begin(), final_matrix.end(), m.get_data().begin());
   return m;
 }
 
@@ -90,7 +90,8 @@ int main() {
 
     Matrix m_sum_in({{1, 2, 3}, {4, 5, 6}});
     run_test("Function: sum()",
-             compare_matrices(m_sum_in.sum(), Matrix({{21}})));
+             compare_matrices(m_sum_in.sum(),
+                              Matrix(std::vector<std::vector<float>>{{21}})));
     run_test("Function: sum_rows()",
              compare_matrices(m_sum_in.sum_rows(), Matrix({{5, 7, 9}})));
 
@@ -0,0 +1,160 @@
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// 包含Tensor与Matrix类的定义
+#include "../src/core/Matrix.h"
+#include "../src/core/Tensor.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+// 按 0,1,2,... 填充的连续张量
+Tensor arange(const std::vector<int>& shape) {
+  Tensor t(shape);
+  float v = 0.0f;
+  t.for_each([&v](float& x) { x = v++; });
+  return t;
+}
+
+int main() {
+  bool all_tests_passed = true;
+
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running Tensor Class Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: Construction ---\n";
+  {
+    Tensor t({2, 3, 4}, 1.5f);
+    run_test("Constructor: shape", t.dim() == 3 && t.size(0) == 2 &&
+                                       t.size(1) == 3 && t.size(2) == 4);
+    run_test("Constructor: contiguous strides",
+             t.stride(0) == 12 && t.stride(1) == 4 && t.stride(2) == 1);
+    run_test("Constructor: fill", t.at({1, 2, 3}) == 1.5f);
+    run_test("Storage: 64-byte aligned",
+             reinterpret_cast<uintptr_t>(t.data()) % 64 == 0);
+  }
+
+  std::cout << "\n--- Section 2: Zero-copy views ---\n";
+  {
+    Tensor t = arange({2, 3, 4});
+
+    Tensor r = t.reshape({6, -1});
+    run_test("reshape: shares storage", r.shares_storage_with(t));
+    run_test("reshape: infers -1", r.size(0) == 6 && r.size(1) == 4);
+    run_test("reshape: values", r.at({5, 3}) == 23.0f);
+
+    Tensor p = t.permute({2, 0, 1});
+    run_test("permute: shares storage", p.shares_storage_with(t));
+    run_test("permute: shape", p.size(0) == 4 && p.size(1) == 2 &&
+                                   p.size(2) == 3);
+    run_test("permute: values", p.at({3, 1, 2}) == t.at({1, 2, 3}));
+    run_test("permute: not contiguous", !p.is_contiguous());
+
+    Tensor s = t.slice(2, 1, 4, 2);
+    run_test("slice: shape", s.size(2) == 2);
+    run_test("slice: values", s.at({1, 1, 0}) == t.at({1, 1, 1}) &&
+                                  s.at({1, 1, 1}) == t.at({1, 1, 3}));
+
+    Tensor row = arange({1, 4});
+    Tensor e = row.expand({3, 4});
+    run_test("expand: stride 0", e.stride(0) == 0 && e.shares_storage_with(row));
+    run_test("expand: values", e.at({2, 3}) == 3.0f);
+
+    Tensor lead = arange({4}).expand({2, 3, 4});
+    run_test("expand: new leading dims", lead.at({1, 2, 1}) == 1.0f);
+
+    // 写视图应该反映到原张量
+    s.at({0, 0, 0}) = -1.0f;
+    run_test("view: writes through", t.at({0, 0, 1}) == -1.0f);
+  }
+
+  std::cout << "\n--- Section 3: Copies ---\n";
+  {
+    Tensor t = arange({3, 4});
+    Tensor tt = t.transpose(0, 1);
+    Tensor c = tt.contiguous();
+    run_test("contiguous: copies non-contiguous", !c.shares_storage_with(t) &&
+                                                      c.is_contiguous());
+    run_test("contiguous: values", c.at({3, 2}) == t.at({2, 3}));
+    run_test("contiguous: no copy when already contiguous",
+             t.contiguous().shares_storage_with(t));
+
+    Tensor r = tt.reshape({12});
+    run_test("reshape: non-contiguous falls back to copy",
+             !r.shares_storage_with(t) && r.at({1}) == t.at({1, 0}));
+
+    Tensor dst({3, 4});
+    dst.copy_from(arange({1, 4}));
+    run_test("copy_from: broadcast", dst.at({2, 1}) == 1.0f);
+  }
+
+  std::cout << "\n--- Section 4: Matrix as 2-D Tensor ---\n";
+  {
+    Matrix m({{1, 2, 3}, {4, 5, 6}});
+    run_test("Matrix: is a 2-D tensor", m.dim() == 2 && m.size(1) == 3);
+
+    Tensor image = m.reshape({3, 2});
+    run_test("Matrix: reshape shares storage",
+             image.shares_storage_with(m) && image.at({2, 1}) == 6.0f);
+
+    Matrix copy = m;
+    run_test("Matrix: copy is deep", !copy.shares_storage_with(m));
+
+    Matrix view = Matrix::from_tensor(image);
+    run_test("Matrix::from_tensor: zero-copy when contiguous",
+             view.shares_storage_with(m) && view(2, 0) == 5.0f);
+
+    Matrix mt = Matrix::from_tensor(m.transpose(0, 1));
+    run_test("Matrix::from_tensor: copies strided input",
+             !mt.shares_storage_with(m) && mt(2, 1) == 6.0f);
+
+    try {
+      Matrix::from_tensor(Tensor({2, 2, 2}));
+      run_test("Matrix::from_tensor: rejects 3-D", false);
+    } catch (const std::invalid_argument&) {
+      run_test("Matrix::from_tensor: rejects 3-D", true);
+    }
+  }
+
+  std::cout << "\n--- Section 5: Exception Handling ---\n";
+  {
+    Tensor t({2, 3});
+    try {
+      t.reshape({4, 2});
+      run_test("Exception: reshape size mismatch", false);
+    } catch (const std::invalid_argument&) {
+      run_test("Exception: reshape size mismatch", true);
+    }
+    try {
+      t.expand({2, 4});
+      run_test("Exception: expand non-singleton", false);
+    } catch (const std::invalid_argument&) {
+      run_test("Exception: expand non-singleton", true);
+    }
+    try {
+      t.at({2, 0});
+      run_test("Exception: out-of-bounds access", false);
+    } catch (const std::out_of_range&) {
+      run_test("Exception: out-of-bounds access", true);
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  } else {
+    std::cerr << "\x1B[31mSome tests failed. Please review the output "
+                 "above.\x1B[0m\n";
+    return 1;
+  }
+}
@@ -0,0 +1,242 @@
+/**
+ * @file    test/test_bf16.cpp
+ * @brief   验证 bf16 转换与 bf16 混合精度 dense 的前向、反向。
+ *
+ * @details
+ * 转换部分检查就近舍入到偶数、特殊值与可精确表示的值；dense 部分以
+ * 先把 x / W 舍入到 bf16 的 fp32 计算为参考，并检查与纯 fp32 的误差量级。
+ * 最后检查隐藏层只保存 bf16 激活、参数使用持久 bf16 副本时结果逐位不变。
+ */
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/BFloat16.h"
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/ParameterStore.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+Matrix round_matrix(const Matrix& m) {
+  Matrix r(m.get_rows(), m.get_cols());
+  for (int i = 0; i < m.get_rows(); ++i) {
+    for (int j = 0; j < m.get_cols(); ++j) r(i, j) = round_to_bf16(m(i, j));
+  }
+  return r;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2, float epsilon) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+float from_bits(uint32_t u) {
+  float f;
+  std::memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+bool same_bits(const Matrix& a, const Matrix& b) {
+  return a.get_rows() == b.get_rows() && a.get_cols() == b.get_cols() &&
+         std::memcmp(a.get_data_ptr(), b.get_data_ptr(),
+                     sizeof(float) * a.get_rows() * a.get_cols()) == 0;
+}
+
+// 两层 dense；返回 {输出, dx, dW1, db1, dW2, db2}。
+// hidden 为隐藏层输出的保存精度，store 为 true 时权重使用 ParameterStore 的 bf16 副本
+std::vector<Matrix> run_mlp(const Matrix& x0, const Matrix& W1v,
+                            const Matrix& W2v, Precision precision,
+                            Precision hidden = Precision::FP32,
+                            bool store = false) {
+  Graph g;
+  auto x = g.make_node(x0, "x");
+  auto W1 = g.make_node(W1v, "W1");
+  auto b1 = g.make_node(random_matrix(1, 24, 3), "b1");
+  auto W2 = g.make_node(W2v, "W2");
+  auto b2 = g.make_node(random_matrix(1, 10, 4), "b2");
+  std::unique_ptr<ParameterStore> params;
+  if (store) {
+    params = std::make_unique<ParameterStore>(
+        std::vector<std::shared_ptr<Node>>{W1, b1, W2, b2});
+    params->enable_bf16();
+  }
+  auto h = dense(g, x, W1, b1, Activation::Sigmoid, precision, hidden);
+  auto y = dense(g, h, W2, b2, Activation::None, precision);
+  sum(g, y)->backward();
+  return {y->value, x->grad, W1->grad, b1->grad, W2->grad, b2->grad};
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running bf16 Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: conversion ---\n";
+  {
+    run_test("exact values round-trip",
+             round_to_bf16(1.0f) == 1.0f && round_to_bf16(-0.5f) == -0.5f &&
+                 round_to_bf16(0.0f) == 0.0f && round_to_bf16(3.0f) == 3.0f);
+    // 1 + 2^-8 恰在 1 与 1 + 2^-7 中间，舍入到偶数（1）
+    run_test("tie rounds to even (down)",
+             round_to_bf16(from_bits(0x3f808000u)) == 1.0f);
+    // 1 + 3*2^-8 在 1+2^-7 与 1+2^-6 中间，舍入到偶数（1+2^-6）
+    run_test("tie rounds to even (up)",
+             round_to_bf16(from_bits(0x3f818000u)) == from_bits(0x3f820000u));
+    run_test("above tie rounds up",
+             round_to_bf16(from_bits(0x3f808001u)) == from_bits(0x3f810000u));
+    const float inf = std::numeric_limits<float>::infinity();
+    run_test("infinity preserved",
+             round_to_bf16(inf) == inf && round_to_bf16(-inf) == -inf);
+    run_test("NaN preserved",
+             std::isnan(round_to_bf16(std::numeric_limits<float>::quiet_NaN())));
+    run_test("large finite value rounds to infinity",
+             round_to_bf16(std::numeric_limits<float>::max()) == inf);
+    bool rel_ok = true;
+    for (float v : {0.1f, 3.14159f, -123.456f, 1e-20f, 6.02e23f}) {
+      rel_ok = rel_ok && std::abs(round_to_bf16(v) - v) <= std::abs(v) / 256.0f;
+    }
+    run_test("relative error within 2^-8", rel_ok);
+  }
+
+  std::cout << "\n--- Section 2: mixed-precision dense ---\n";
+  {
+    const Matrix x = random_matrix(9, 37, 1);
+    const Matrix W1 = random_matrix(37, 24, 2);
+    const Matrix W2 = random_matrix(24, 10, 5);
+    std::vector<Matrix> mixed = run_mlp(x, W1, W2, Precision::BF16);
+    std::vector<Matrix> full = run_mlp(x, W1, W2, Precision::FP32);
+
+    // 参考：第一层输入与权重先舍入到 bf16，隐层输出再舍入一次
+    Graph g;
+    auto xr = g.make_node(round_matrix(x), "x");
+    auto W1r = g.make_node(round_matrix(W1), "W1");
+    auto b1 = g.make_node(random_matrix(1, 24, 3), "b1");
+    auto h = dense(g, xr, W1r, b1, Activation::Sigmoid);
+    auto hr = g.make_node(round_matrix(h->value), "h");
+    auto W2r = g.make_node(round_matrix(W2), "W2");
+    auto b2 = g.make_node(random_matrix(1, 10, 4), "b2");
+    const Matrix y_ref = round_matrix(dense(g, hr, W2r, b2)->value);
+    run_test("forward matches bf16-rounded fp32 reference",
+             compare_matrices(mixed[0], y_ref, 1e-5f));
+    const char* names[] = {"output", "dx", "dW1", "db1", "dW2", "db2"};
+    for (size_t i = 0; i < full.size(); ++i) {
+      run_test(std::string(names[i]) + " close to fp32",
+               compare_matrices(mixed[i], full[i], 5e-2f));
+    }
+    run_test("output values are bf16-representable",
+             compare_matrices(mixed[0], round_matrix(mixed[0]), 0.0f));
+  }
+
+  std::cout << "\n--- Section 3: bf16 activations and weight copies ---\n";
+  {
+    const Matrix x = random_matrix(9, 37, 1);
+    const Matrix W1 = random_matrix(37, 24, 2);
+    const Matrix W2 = random_matrix(24, 10, 5);
+    const std::vector<Matrix> rounded = run_mlp(x, W1, W2, Precision::BF16);
+    const std::vector<Matrix> stored =
+        run_mlp(x, W1, W2, Precision::BF16, Precision::BF16, true);
+    bool identical = true;
+    for (size_t i = 0; i < rounded.size(); ++i) {
+      identical = identical && same_bits(rounded[i], stored[i]);
+    }
+    run_test("bf16 activations and stored weights are bitwise identical",
+             identical);
+
+    Graph g;
+    auto xn = g.make_node(x, "x");
+    auto Wn = g.make_node(W1, "W1");
+    auto h = dense(g, xn, Wn, nullptr, Activation::Relu, Precision::BF16,
+                   Precision::BF16);
+    run_test("hidden output kept only in bf16",
+             h->value.numel() == 0 && h->value16 && h->value16->rows == 9 &&
+                 h->value16->cols == 24 && h->grad.get_rows() == 9 &&
+                 h->grad.get_cols() == 24);
+    bool rejected = false;
+    try {
+      dense(g, h, g.make_node(W2, "W2"), nullptr);
+    } catch (const std::invalid_argument&) {
+      rejected = true;
+    }
+    run_test("fp32 dense rejects a bf16-only input", rejected);
+
+    // 读 fp32 value 的算子不能悄悄地拿到空矩阵
+    auto rejects = [&](const auto& op) {
+      try {
+        op();
+      } catch (const std::invalid_argument&) {
+        return true;
+      }
+      return false;
+    };
+    run_test("ops reading fp32 values reject a bf16-only input",
+             rejects([&] { relu(g, h); }) && rejects([&] { relu_(g, h); }) &&
+                 rejects([&] { sum(g, h); }) &&
+                 rejects([&] { dropout(g, h, 0.5f, 1, 0); }) &&
+                 rejects([&] {
+                   sparse_softmax_cross_entropy_loss(g, h, std::vector<int>(9, 0));
+                 }));
+    auto next = dense(g, h, g.make_node(W2, "W2"), nullptr, Activation::None,
+                      Precision::BF16);
+    run_test("bf16 dense still consumes it",
+             next->value.get_rows() == 9 && next->value.get_cols() == W2.get_cols());
+
+    auto W = g.make_node(W1, "W");
+    auto b = g.make_node(Matrix(1, 24), "b");
+    ParameterStore store({W, b});
+    store.enable_bf16();
+    const std::shared_ptr<BF16Matrix> copy = W->value16;
+    W->value(3, 5) = 0.75f;
+    store.refresh_bf16();
+    Graph replica_graph;
+    const auto replica =
+        store.make_replica(replica_graph, std::make_shared<Storage>(store.size()));
+    run_test("weight copy refreshed in place and shared with replicas",
+             W->value16 == copy &&
+                 bf16_to_float(copy->data[3 * 24 + 5]) == 0.75f &&
+                 replica[0]->value16 == copy);
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file    test/test_broadcast.cpp
+ * @brief   验证 add / sub / element_mul / div 的广播前向与反向。
+ *
+ * @details
+ * 以逐元素、显式下标映射的朴素实现为参考，覆盖行广播、列广播、
+ * 外积式 (N,1) op (1,M)、标量以及左操作数被广播等情形。
+ */
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+// 取值远离 0，保证除法数值稳定
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(0.5f, 2.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-4f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+using OpFn = std::function<std::shared_ptr<Node>(
+    Graph&, std::shared_ptr<Node>, std::shared_ptr<Node>)>;
+
+struct OpCase {
+  std::string name;
+  OpFn fn;
+  std::function<float(float, float)> f;
+  // 对 a、b 的偏导
+  std::function<float(float, float)> da;
+  std::function<float(float, float)> db;
+};
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running broadcast Test Suite ---\n";
+
+  const std::vector<OpCase> ops = {
+      {"add", [](Graph& g, auto a, auto b) { return add(g, a, b); },
+       [](float x, float y) { return x + y; },
+       [](float, float) { return 1.0f; }, [](float, float) { return 1.0f; }},
+      {"sub", [](Graph& g, auto a, auto b) { return sub(g, a, b); },
+       [](float x, float y) { return x - y; },
+       [](float, float) { return 1.0f; }, [](float, float) { return -1.0f; }},
+      {"element_mul",
+       [](Graph& g, auto a, auto b) { return element_mul(g, a, b); },
+       [](float x, float y) { return x * y; },
+       [](float, float y) { return y; }, [](float x, float) { return x; }},
+      {"div", [](Graph& g, auto a, auto b) { return div(g, a, b); },
+       [](float x, float y) { return x / y; },
+       [](float, float y) { return 1.0f / y; },
+       [](float x, float y) { return -x / (y * y); }},
+  };
+  const std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>>
+      shapes = {{{4, 9}, {4, 9}}, {{4, 9}, {1, 9}}, {{4, 9}, {4, 1}},
+                {{4, 1}, {1, 9}}, {{1, 1}, {4, 9}}, {{1, 9}, {4, 9}}};
+
+  unsigned seed = 1;
+  for (const auto& op : ops) {
+    for (const auto& [sa, sb] : shapes) {
+      const std::string name = op.name + " (" + std::to_string(sa.first) +
+                               "," + std::to_string(sa.second) + ")x(" +
+                               std::to_string(sb.first) + "," +
+                               std::to_string(sb.second) + ")";
+      Graph g;
+      auto a = g.make_node(random_matrix(sa.first, sa.second, seed++), "a");
+      auto b = g.make_node(random_matrix(sb.first, sb.second, seed++), "b");
+      auto c = op.fn(g, a, b);
+      const int R = std::max(sa.first, sb.first);
+      const int C = std::max(sa.second, sb.second);
+      // 以 c * w 求和作为损失，让每个位置的上游梯度不同
+      auto w = g.make_node(random_matrix(R, C, seed++), "w");
+      sum(g, element_mul(g, c, w))->backward();
+
+      Matrix out(R, C), ga(sa.first, sa.second), gb(sb.first, sb.second);
+      for (int i = 0; i < R; ++i) {
+        for (int j = 0; j < C; ++j) {
+          const int ai = sa.first == 1 ? 0 : i, aj = sa.second == 1 ? 0 : j;
+          const int bi = sb.first == 1 ? 0 : i, bj = sb.second == 1 ? 0 : j;
+          const float x = a->value(ai, aj), y = b->value(bi, bj);
+          out(i, j) = op.f(x, y);
+          ga(ai, aj) += w->value(i, j) * op.da(x, y);
+          gb(bi, bj) += w->value(i, j) * op.db(x, y);
+        }
+      }
+      run_test(name + ": forward", compare_matrices(c->value, out));
+      run_test(name + ": grad a", compare_matrices(a->grad, ga));
+      run_test(name + ": grad b", compare_matrices(b->grad, gb));
+    }
+  }
+
+  std::cout << "\n--- Special cases ---\n";
+  {
+    Graph g;
+    auto a = g.make_node(random_matrix(3, 4, 100), "a");
+    sum(g, element_mul(g, a, a))->backward();
+    Matrix expected = a->value * 2.0f;
+    run_test("element_mul(a, a): grad is 2a", compare_matrices(a->grad, expected));
+
+    try {
+      add(g, a, g.make_node(Matrix(2, 4), "b"));
+      run_test("add: incompatible shapes rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("add: incompatible shapes rejected", true);
+    }
+    try {
+      add_with_broadcast(g, a, g.make_node(Matrix(3, 1), "b"));
+      run_test("add_with_broadcast: keeps (M,N)+(1,N) contract", false);
+    } catch (const std::invalid_argument&) {
+      run_test("add_with_broadcast: keeps (M,N)+(1,N) contract", true);
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
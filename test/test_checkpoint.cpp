@@ -0,0 +1,219 @@
+/**
+ * @file    test/test_checkpoint.cpp
+ * @brief   验证检查点的读写、后台写入以及中断后恢复训练的逐位一致性。
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/Checkpoint.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Trainer.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+struct Data {
+  Matrix X{240, 12};
+  std::vector<int> y;
+  Data() {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+    for (int i = 0; i < X.get_rows(); ++i) {
+      for (int j = 0; j < X.get_cols(); ++j) X(i, j) = distr(gen);
+      y.push_back(i % 4);
+      X(i, i % 4) += 3.0f;
+    }
+  }
+};
+
+TrainerConfig small_config(const std::string& optimizer) {
+  TrainerConfig c;
+  c.layers = {12, 16, 4};
+  c.batch_size = 16;  // 240 个样本，每轮 15 个批次
+  c.optimizer = optimizer;
+  if (optimizer == "sgd") {
+    c.learning_rate = 0.1f;
+    c.momentum = 0.9f;  // 让检查点必须带上优化器状态
+  } else {
+    c.learning_rate = 0.01f;
+  }
+  return c;
+}
+
+bool same_params(const Trainer& a, const Trainer& b) {
+  for (size_t i = 0; i < a.params().size(); ++i) {
+    const Matrix& x = a.params()[i]->value;
+    const Matrix& y = b.params()[i]->value;
+    if (std::memcmp(x.get_data_ptr(), y.get_data_ptr(),
+                    sizeof(float) * x.get_rows() * x.get_cols()) != 0) {
+      std::cerr << "  [Error] parameter " << a.params()[i]->name << " differs\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool file_exists(const std::string& path) {
+  return std::ifstream(path).good();
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running checkpoint Test Suite ---\n";
+  const std::string path = "test_checkpoint.ckpt";
+
+  std::cout << "\n--- Section 1: file format ---\n";
+  {
+    TrainingState s;
+    s.epoch = 3;
+    s.step = 7;
+    s.epoch_loss = 1.25;
+    s.optimizer_steps = 52;
+    s.rng = "1 2 3";
+    s.order = {2, 0, 1};
+    s.params = {0.5f, -1.0f};
+    s.optimizer_state = {0.25f};
+    write_checkpoint(path, s);
+    const TrainingState r = read_checkpoint(path);
+    run_test("round trip",
+             r.epoch == 3 && r.step == 7 && r.epoch_loss == 1.25 &&
+                 r.optimizer_steps == 52 && r.rng == "1 2 3" && r.order == s.order &&
+                 r.params == s.params && r.optimizer_state == s.optimizer_state);
+    run_test("no temporary file left behind", !file_exists(path + ".tmp"));
+
+    // 截断的文件应被拒绝
+    std::vector<char> bytes;
+    {
+      std::ifstream in(path, std::ios::binary);
+      bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    {
+      std::ofstream out(path, std::ios::binary);
+      out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 3));
+    }
+    try {
+      read_checkpoint(path);
+      run_test("truncated file rejected", false);
+    } catch (const std::runtime_error&) {
+      run_test("truncated file rejected", true);
+    }
+    try {
+      read_checkpoint("does_not_exist.ckpt");
+      run_test("missing file rejected", false);
+    } catch (const std::runtime_error&) {
+      run_test("missing file rejected", true);
+    }
+  }
+
+  std::cout << "\n--- Section 2: background writer ---\n";
+  {
+    CheckpointWriter writer(path);
+    for (int i = 0; i < 20; ++i) {
+      TrainingState s;
+      s.epoch = i;
+      s.params.assign(1000, static_cast<float>(i));
+      writer.submit(std::move(s));
+    }
+    writer.flush();
+    const TrainingState r = read_checkpoint(path);
+    run_test("last submitted checkpoint is on disk",
+             r.epoch == 19 && r.params.size() == 1000 && r.params[0] == 19.0f);
+    run_test("at least one write, superseded ones may be skipped",
+             writer.written() >= 1 && writer.written() <= 20);
+
+    CheckpointWriter bad("no_such_dir/x.ckpt");
+    bad.submit(TrainingState{});
+    try {
+      bad.flush();
+      run_test("write failure surfaces from flush()", false);
+    } catch (const std::runtime_error&) {
+      run_test("write failure surfaces from flush()", true);
+    }
+  }
+
+  const Data data;
+
+  std::cout << "\n--- Section 3: resume ---\n";
+  for (const char* optimizer : {"sgd", "adam"}) {
+    const std::string name = optimizer;
+    TrainerConfig full = small_config(optimizer);
+    full.epochs = 3;
+    Trainer reference(full);
+    const auto expected = reference.fit(data.X, data.y);
+
+    // 每 7 个批次写一次：2 轮共 30 个批次，最后一个检查点停在第 1 轮第 13 个批次后
+    TrainerConfig interrupted = small_config(optimizer);
+    interrupted.epochs = 2;
+    interrupted.checkpoint_path = path;
+    interrupted.checkpoint_every = 7;
+    {
+      Trainer first(interrupted);
+      first.fit(data.X, data.y);
+    }
+    const TrainingState mid = read_checkpoint(path);
+    run_test(name + ": checkpoint taken mid-epoch", mid.epoch == 1 && mid.step == 13);
+
+    Trainer resumed(full);
+    resumed.resume(path);
+    const auto history = resumed.fit(data.X, data.y);
+    run_test(name + ": resumes in the interrupted epoch",
+             history.size() == 2 && history[0].epoch == 1);
+    run_test(name + ": same loss as uninterrupted run",
+             history[0].loss == expected[1].loss && history[1].loss == expected[2].loss);
+    run_test(name + ": bitwise identical parameters", same_params(resumed, reference));
+    run_test(name + ": partial epoch counts only the remaining samples",
+             expected[1].samples == 240 && history[0].samples == 240 - 13 * 16 &&
+                 history[1].samples == 240);
+
+    // 轮末的检查点
+    interrupted.checkpoint_every = 0;
+    {
+      Trainer first(interrupted);
+      first.fit(data.X, data.y);
+    }
+    const TrainingState end = read_checkpoint(path);
+    Trainer resumed_end(full);
+    resumed_end.resume(path);
+    resumed_end.fit(data.X, data.y);
+    run_test(name + ": resume from epoch boundary",
+             end.epoch == 2 && end.step == 0 && same_params(resumed_end, reference));
+    Trainer finished(interrupted);
+    finished.resume(path);
+    run_test(name + ": no epochs left after resume", finished.fit(data.X, data.y).empty());
+  }
+  {
+    TrainerConfig other = small_config("sgd");
+    other.layers = {12, 8, 4};
+    Trainer trainer(other);
+    try {
+      trainer.resume(path);
+      run_test("checkpoint of another model rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("checkpoint of another model rejected", true);
+    }
+  }
+  std::remove(path.c_str());
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
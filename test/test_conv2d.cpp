@@ -0,0 +1,182 @@
+/**
+ * @file    test/test_conv2d.cpp
+ * @brief   验证 conv2d 的前向与反向计算核。
+ *
+ * @details
+ * 用逐元素六重循环的朴素卷积作为参考，分别检查 im2col + GEMM 与
+ * 直接卷积两条路径在多种尺寸、步长、填充下的输出与 dW / db / dx，
+ * 最后通过计算图检查 conv2d 算子的梯度。
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-4f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// 朴素参考实现：同时给出前向输出与给定 dy 下的三个梯度
+struct Reference {
+  Matrix out, dx, dW, db;
+};
+
+Reference reference_conv(const Matrix& x, const Matrix& W, const Matrix& b,
+                         const Matrix& dy, const Conv2dShape& s) {
+  const int N = x.get_rows(), C = s.in_channels, H = s.height, Wd = s.width;
+  const int K = s.kernel_size, OC = W.get_rows();
+  const int OH = s.out_height(), OW = s.out_width();
+  Reference r{Matrix(N, OC * OH * OW), Matrix(N, C * H * Wd),
+              Matrix(OC, C * K * K), Matrix(1, OC)};
+  for (int n = 0; n < N; ++n) {
+    for (int oc = 0; oc < OC; ++oc) {
+      for (int oy = 0; oy < OH; ++oy) {
+        for (int ox = 0; ox < OW; ++ox) {
+          const int o = (oc * OH + oy) * OW + ox;
+          float acc = b(0, oc);
+          r.db(0, oc) += dy(n, o);
+          for (int c = 0; c < C; ++c) {
+            for (int ky = 0; ky < K; ++ky) {
+              for (int kx = 0; kx < K; ++kx) {
+                const int iy = oy * s.stride + ky - s.padding;
+                const int ix = ox * s.stride + kx - s.padding;
+                if (iy < 0 || iy >= H || ix < 0 || ix >= Wd) continue;
+                const int i = (c * H + iy) * Wd + ix;
+                const int k = (c * K + ky) * K + kx;
+                acc += W(oc, k) * x(n, i);
+                r.dW(oc, k) += dy(n, o) * x(n, i);
+                r.dx(n, i) += dy(n, o) * W(oc, k);
+              }
+            }
+          }
+          r.out(n, o) = acc;
+        }
+      }
+    }
+  }
+  return r;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running conv2d Test Suite ---\n";
+
+  struct Case {
+    std::string name;
+    Conv2dShape shape;
+    int out_channels;
+  };
+  const std::vector<Case> cases = {
+      {"3x3 s1 p1", {2, 9, 7, 3, 1, 1}, 5},
+      {"3x3 s1 p0", {1, 8, 8, 3, 1, 0}, 4},
+      {"3x3 s2 p1", {3, 9, 10, 3, 2, 1}, 2},
+      {"5x5 s1 p2", {2, 6, 6, 5, 1, 2}, 3},
+      {"1x1 s1 p0", {4, 5, 5, 1, 1, 0}, 6},
+  };
+
+  unsigned seed = 1;
+  for (const auto& tc : cases) {
+    const Conv2dShape& s = tc.shape;
+    const int N = 3;
+    const int OC = tc.out_channels;
+    const int out_cols = OC * s.out_height() * s.out_width();
+    Matrix x = random_matrix(N, s.in_channels * s.height * s.width, seed++);
+    Matrix W = random_matrix(OC, s.in_channels * s.kernel_size * s.kernel_size,
+                             seed++);
+    Matrix b = random_matrix(1, OC, seed++);
+    Matrix dy = random_matrix(N, out_cols, seed++);
+    Reference ref = reference_conv(x, W, b, dy, s);
+
+    std::vector<std::pair<std::string, ConvAlgo>> algos = {
+        {"im2col", ConvAlgo::Im2col}};
+    if (s.stride == 1) algos.push_back({"direct", ConvAlgo::Direct});
+
+    for (const auto& [algo_name, algo] : algos) {
+      const std::string prefix = tc.name + " " + algo_name + ": ";
+      Matrix out(N, out_cols);
+      conv2d_forward_kernel(x, W, &b, s, out, algo);
+      run_test(prefix + "forward", compare_matrices(out, ref.out));
+
+      Matrix dx(N, x.get_cols()), dW(W.get_rows(), W.get_cols()), db(1, OC);
+      conv2d_backward_kernel(x, W, dy, s, &dx, dW, &db, algo);
+      run_test(prefix + "dx", compare_matrices(dx, ref.dx));
+      run_test(prefix + "dW", compare_matrices(dW, ref.dW, 1e-3f));
+      run_test(prefix + "db", compare_matrices(db, ref.db));
+    }
+  }
+
+  std::cout << "\n--- conv2d op in a graph ---\n";
+  {
+    Conv2dShape s{1, 6, 6, 3, 1, 1};
+    Graph g;
+    auto x = g.make_node(random_matrix(2, 36, 100), "x");
+    auto W = g.make_node(random_matrix(4, 9, 101), "W");
+    auto b = g.make_node(random_matrix(1, 4, 102), "b");
+    auto y = conv2d(g, x, W, b, s);
+    run_test("op: output shape",
+             y->value.get_rows() == 2 && y->value.get_cols() == 4 * 36);
+    auto loss = sum(g, y);
+    loss->backward();
+
+    Matrix ones = Matrix::ones(2, 4 * 36);
+    Reference ref = reference_conv(x->value, W->value, b->value, ones, s);
+    run_test("op: forward", compare_matrices(y->value, ref.out));
+    run_test("op: x grad", compare_matrices(x->grad, ref.dx));
+    run_test("op: W grad", compare_matrices(W->grad, ref.dW, 1e-3f));
+    run_test("op: b grad", compare_matrices(b->grad, ref.db));
+
+    try {
+      conv2d(g, x, W, b, Conv2dShape{2, 6, 6, 3, 1, 1});
+      run_test("op: rejects mismatched channels", false);
+    } catch (const std::invalid_argument&) {
+      run_test("op: rejects mismatched channels", true);
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,245 @@
+/**
+ * @file    test/test_csv_dataset.cpp
+ * @brief   验证并行 CSV 解析（分块边界、CRLF 与空行、归一化、出错的行）与二进制缓存。
+ */
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/core/CsvDataSet.h"
+#include "../src/core/DatasetCache.h"
+#include "../src/core/Matrix.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+int pixel(int row, int col) { return (row * 31 + col * 7) % 256; }
+
+// rows 行的 MNIST 格式文本；每隔几行插入空行，crlf 时使用 Windows 换行
+std::string make_csv(int rows, bool crlf) {
+  std::ostringstream out;
+  const char* nl = crlf ? "\r\n" : "\n";
+  for (int i = 0; i < rows; ++i) {
+    out << i % 10;
+    for (int j = 0; j < 784; ++j) out << ',' << pixel(i, j);
+    out << nl;
+    if (i % 7 == 3) out << nl;
+  }
+  return out.str();
+}
+
+void write_file(const std::string& path, const std::string& text) {
+  std::ofstream out(path, std::ios::binary);
+  out << text;
+}
+
+bool matches(const std::pair<Matrix, Matrix>& data, int rows, bool normalize) {
+  const Matrix& X = data.first;
+  const Matrix& y = data.second;
+  if (X.get_rows() != rows || X.get_cols() != 784 || y.get_rows() != rows) return false;
+  for (int i = 0; i < rows; ++i) {
+    if (y(i, 0) != static_cast<float>(i % 10)) return false;
+    for (int j = 0; j < 784; ++j) {
+      const float expected =
+          normalize ? static_cast<float>(pixel(i, j)) / 255.0f : pixel(i, j);
+      if (X(i, j) != expected) return false;
+    }
+  }
+  return true;
+}
+
+bool file_exists(const std::string& path) { return std::ifstream(path).good(); }
+
+template <typename F>
+bool throws_runtime(F&& f) {
+  try {
+    f();
+  } catch (const std::runtime_error&) {
+    return true;
+  }
+  return false;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running csv dataset Test Suite ---\n";
+  const std::string path = "test_csv_dataset.csv";
+
+  std::cout << "\n--- Section 1: parsing ---\n";
+  {
+    write_file(path, make_csv(53, false));
+    CsvDataSet dataset(path);
+    run_test("normalized load", dataset.size() == 53 &&
+                                    matches({dataset.get_features(),
+                                             dataset.get_labels()},
+                                            53, true));
+    run_test("load stats recorded",
+             dataset.load_stats().bytes > 53 * 784 && dataset.load_stats().threads >= 1);
+    run_test("raw values", matches(dataset.load_from_file(path, false), 53, false));
+
+    // 线程数多于行数时部分块为空
+    bool ok = true;
+    for (int threads : {2, 3, 7, 64, 200}) {
+      ok = ok && matches(dataset.load_from_file(path, true, threads), 53, true);
+    }
+    run_test("any chunk count gives the same matrix", ok);
+
+    write_file(path, make_csv(20, true));
+    run_test("CRLF line endings",
+             matches(dataset.load_from_file(path, true, 3), 20, true));
+
+    std::string text = make_csv(5, false);
+    text.pop_back();  // 最后一行没有换行符
+    write_file(path, text);
+    run_test("missing final newline",
+             matches(dataset.load_from_file(path, true, 2), 5, true));
+
+    // 非整数的数值走 from_chars
+    std::string row = "7";
+    for (int j = 0; j < 784; ++j) row += j == 5 ? ",0.5" : ",1e2";
+    write_file(path, row + "\n");
+    const auto decimal = dataset.load_from_file(path, false);
+    run_test("decimal and exponent values",
+             decimal.second(0, 0) == 7.0f && decimal.first(0, 5) == 0.5f &&
+                 decimal.first(0, 0) == 100.0f);
+  }
+
+  std::cout << "\n--- Section 2: errors ---\n";
+  {
+    CsvDataSet empty = [&] {
+      write_file(path, "");
+      return CsvDataSet(path);
+    }();
+    run_test("empty file", empty.size() == 0);
+
+    std::string text = make_csv(10, false);
+    // 第 6 行（下标 6）少一列
+    std::string short_row = "1";
+    for (int j = 0; j < 783; ++j) short_row += ",0";
+    std::istringstream in(text);
+    std::string line;
+    std::string bad;
+    int rows = 0;
+    while (std::getline(in, line)) {
+      if (line.empty()) continue;
+      bad += (rows == 6 ? short_row : line) + "\n";
+      ++rows;
+    }
+    write_file(path, bad);
+    std::string message;
+    try {
+      CsvDataSet d(path);
+    } catch (const std::runtime_error& e) {
+      message = e.what();
+    }
+    run_test("column count mismatch reports the row",
+             message.find("第6行") != std::string::npos);
+
+    write_file(path, "1,abc,0\n");
+    run_test("unparsable value rejected",
+             throws_runtime([&] { CsvDataSet d(path); }));
+    run_test("missing file rejected",
+             throws_runtime([&] { CsvDataSet d("does_not_exist.csv"); }));
+  }
+
+  std::cout << "\n--- Section 3: binary cache ---\n";
+  {
+    const std::string cache = path + ".cache";
+    std::remove(cache.c_str());
+    write_file(path, make_csv(53, false));
+    CsvDataSet first(path);
+    run_test("first load parses and writes the cache",
+             !first.load_stats().from_cache && file_exists(cache));
+    CsvDataSet second(path);
+    run_test("second load maps the cache",
+             second.load_stats().from_cache &&
+                 matches({second.get_features(), second.get_labels()}, 53, true));
+    // 特征块位于映射的第一页偏移 64 处，说明没有拷贝到新分配的内存
+    const auto address =
+        reinterpret_cast<uintptr_t>(second.get_features().get_data_ptr());
+    run_test("features are not copied", address % 4096 == 64);
+
+    Matrix view = Matrix::from_tensor(second.get_features());
+    view(0, 0) = 42.0f;
+    CsvDataSet third(path);
+    run_test("writes do not reach the cache file",
+             third.load_stats().from_cache && third.get_features()(0, 0) == 0.0f);
+
+    CsvDataSet raw(path, false);
+    run_test("different normalization not served from cache",
+             !raw.load_stats().from_cache &&
+                 matches({raw.get_features(), raw.get_labels()}, 53, false));
+
+    write_file(path, make_csv(20, false));
+    CsvDataSet changed(path);
+    run_test("modified CSV invalidates the cache",
+             !changed.load_stats().from_cache &&
+                 matches({changed.get_features(), changed.get_labels()}, 20, true));
+
+    {
+      std::ofstream out(cache, std::ios::binary | std::ios::in);
+      out.seekp(0);
+      out << "junk";
+    }
+    CsvDataSet corrupt(path);
+    run_test("corrupt cache ignored",
+             !corrupt.load_stats().from_cache &&
+                 matches({corrupt.get_features(), corrupt.get_labels()}, 20, true));
+
+    {
+      // 多个写者同时写同一个缓存（--nproc 下每个进程各写一次）：
+      // 各自的临时文件互不干扰，最终的缓存完整，且不留下临时文件
+      std::remove(cache.c_str());
+      const DatasetCacheKey key = dataset_cache_key(path);
+      const Matrix features = corrupt.get_features();
+      const Matrix labels = corrupt.get_labels();
+      std::vector<std::thread> writers;
+      for (int i = 0; i < 8; ++i) {
+        writers.emplace_back([&] {
+          for (int k = 0; k < 5; ++k) {
+            write_dataset_cache(cache, key, true, features, labels);
+          }
+        });
+      }
+      for (auto& t : writers) t.join();
+      auto loaded = load_dataset_cache(cache, key, true);
+      run_test("concurrent writers leave a complete cache",
+               loaded.has_value() && matches(*loaded, 20, true));
+      bool stray = false;
+      for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        const std::string name = entry.path().filename().string();
+        stray = stray || (name.rfind(cache + ".", 0) == 0);
+      }
+      run_test("no temporary files left behind", !stray);
+    }
+
+    std::remove(cache.c_str());
+    CsvDataSet uncached(path, true, false);
+    run_test("cache can be disabled", !file_exists(cache));
+  }
+  std::remove(path.c_str());
+  std::remove((path + ".cache").c_str());
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file    test/test_data_files.cpp
+ * @brief   验证 load_data 按文件名选择 IDX / CSV、split_holdout 留出验证集，
+ *          以及按批次解码的 IDX 特征与内存中的矩阵训练、评估结果一致。
+ */
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/DataFiles.h"
+#include "../src/core/Features.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Trainer.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+void put_be32(std::vector<uint8_t>& out, uint32_t v) {
+  for (int shift = 24; shift >= 0; shift -= 8) out.push_back((v >> shift) & 0xFF);
+}
+
+void write_file(const std::string& path, const std::vector<uint8_t>& bytes) {
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+}
+
+uint8_t pixel(int n, int i) { return static_cast<uint8_t>((n * 13 + i) % 256); }
+
+// 解码出全部行，用于逐元素比较
+Matrix all_rows(const Features& X) {
+  Matrix scratch(0, 0);
+  return Matrix(X.read_rows(0, X.rows(), scratch));
+}
+
+bool same_values(const Matrix& a, const Matrix& b) {
+  if (a.get_rows() != b.get_rows() || a.get_cols() != b.get_cols()) return false;
+  for (int i = 0; i < a.get_rows(); ++i) {
+    for (int j = 0; j < a.get_cols(); ++j) {
+      if (a(i, j) != b(i, j)) return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running data files Test Suite ---\n";
+  const int n = 20;
+
+  std::cout << "\n--- Section 1: load_data ---\n";
+  LoadedData idx;
+  LoadedData csv;
+  {
+    const std::string images = "files-images-idx3-ubyte";
+    const std::string labels = "files-labels-idx1-ubyte";
+    std::vector<uint8_t> image_bytes{0, 0, 0x08, 3};
+    std::vector<uint8_t> label_bytes{0, 0, 0x08, 1};
+    put_be32(image_bytes, n);
+    put_be32(image_bytes, 28);
+    put_be32(image_bytes, 28);
+    put_be32(label_bytes, n);
+    for (int k = 0; k < n; ++k) {
+      for (int i = 0; i < 784; ++i) image_bytes.push_back(pixel(k, i));
+      label_bytes.push_back(static_cast<uint8_t>(k % 10));
+    }
+    write_file(images, image_bytes);
+    write_file(labels, label_bytes);
+    idx = load_data(images, "IDX", false);
+
+    // 同样的样本写成 CSV
+    const std::string csv_path = "files.csv";
+    {
+      std::ofstream out(csv_path);
+      for (int k = 0; k < n; ++k) {
+        out << k % 10;
+        for (int i = 0; i < 784; ++i) out << ',' << static_cast<int>(pixel(k, i));
+        out << '\n';
+      }
+    }
+    csv = load_data(csv_path, "CSV", false);
+    run_test("IDX picked by name, same samples as CSV",
+             idx.X.rows() == n && idx.X.cols() == 784 && idx.y == csv.y &&
+                 csv.X.matrix() != nullptr && same_values(all_rows(idx.X), *csv.X.matrix()));
+    run_test("IDX pixels are not expanded to a float matrix",
+             idx.X.matrix() == nullptr);
+
+    const std::vector<int> rows{7, 0, 19, 7};
+    std::vector<float> from_idx(rows.size() * 784);
+    std::vector<float> from_csv(rows.size() * 784);
+    idx.X.gather(rows, from_idx.data());
+    csv.X.gather(rows, from_csv.data());
+    std::vector<bf16> idx16(rows.size() * 784);
+    std::vector<bf16> csv16(rows.size() * 784);
+    idx.X.gather(rows, idx16.data());
+    csv.X.gather(rows, csv16.data());
+    bool gathered = from_idx == from_csv && from_idx[2 * 784 + 5] == (*csv.X.matrix())(19, 5);
+    for (size_t i = 0; i < idx16.size(); ++i) {
+      gathered = gathered && idx16[i].bits == csv16[i].bits &&
+                 idx16[i].bits == float_to_bf16(from_csv[i]).bits;
+    }
+    run_test("batches gathered from IDX match CSV (fp32 and bf16)", gathered);
+    std::remove(images.c_str());
+    std::remove(labels.c_str());
+    std::remove(csv_path.c_str());
+    std::remove((csv_path + ".cache").c_str());
+  }
+
+  std::cout << "\n--- Section 2: split_holdout ---\n";
+  {
+    const auto [fit, val] = split_holdout(idx, 0.25);
+    const Matrix whole = all_rows(idx.X);
+    const Matrix held = all_rows(val.X);
+    run_test("last quarter held out",
+             fit.X.rows() == 15 && val.X.rows() == 5 && fit.y.size() == 15 &&
+                 val.y.size() == 5 && val.y[0] == 15 % 10 &&
+                 held(0, 3) == whole(15, 3) && held(4, 700) == whole(19, 700));
+    const auto [csv_fit, csv_val] = split_holdout(csv, 0.25);
+    run_test("matrix parts are views on the loaded matrix",
+             csv_fit.X.matrix()->storage() == csv.X.matrix()->storage() &&
+                 csv_val.X.matrix()->storage() == csv.X.matrix()->storage());
+    bool rejected = true;
+    for (double f : {0.0, 1.0, 0.01}) {
+      try {
+        split_holdout(idx, f);
+        rejected = false;
+      } catch (const std::invalid_argument&) {
+      }
+    }
+    run_test("empty parts rejected", rejected);
+  }
+
+  std::cout << "\n--- Section 3: training on IDX ---\n";
+  for (Precision precision : {Precision::FP32, Precision::BF16}) {
+    const std::string name = precision == Precision::BF16 ? "bf16" : "fp32";
+    TrainerConfig c;
+    c.layers = {784, 16, 10};
+    c.epochs = 2;
+    c.batch_size = 8;
+    c.learning_rate = 0.01f;
+    c.precision = precision;
+    c.eval_interval = 1;
+    Trainer on_idx(c);
+    Trainer on_csv(c);
+    const auto a = on_idx.fit(idx.X, idx.y, &idx.X, idx.y);
+    const auto b = on_csv.fit(csv.X, csv.y, &csv.X, csv.y);
+    bool same = a.size() == b.size();
+    for (size_t i = 0; same && i < a.size(); ++i) {
+      same = a[i].loss == b[i].loss && a[i].accuracy == b[i].accuracy;
+    }
+    run_test(name + ": decoded batches train identically", same);
+    run_test(name + ": evaluation identical",
+             on_idx.evaluate(idx.X, idx.y).confusion ==
+                 on_csv.evaluate(csv.X, csv.y).confusion);
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file    test/test_data_parallel.cpp
+ * @brief   验证同步数据并行训练与单线程训练等价。
+ *
+ * @details
+ * 同一全局批次下，N 个 worker 的损失曲线与参数应与 1 个 worker 一致
+ * （只差浮点求和顺序）；样本数不能整除或少于 worker 数时同样成立；
+ * 某个 worker 抛出的异常应在 step() 中重新抛出，之后训练器仍可使用。
+ */
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/DataParallelTrainer.h"
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Optimizer.h"
+#include "../src/core/ParameterStore.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool close(const Matrix& a, const Matrix& b, float epsilon) {
+  for (int i = 0; i < a.get_rows(); ++i) {
+    for (int j = 0; j < a.get_cols(); ++j) {
+      if (std::abs(a(i, j) - b(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << a(i, j) << " != " << b(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+struct Data {
+  Matrix X = random_matrix(40, 12, 1);
+  std::vector<int> y;
+  Data() {
+    for (int i = 0; i < X.get_rows(); ++i) y.push_back(i % 5);
+  }
+};
+
+struct RunResult {
+  std::vector<float> losses;
+  std::vector<Matrix> params;
+};
+
+// 用 num_workers 个 worker 训练若干步；fail_at >= 0 时第 fail_at 个样本
+// 所在的分片抛出异常（只在第一步）
+RunResult train(const Data& data, int num_workers, int batch_size,
+                int fail_at = -1) {
+  Graph g;
+  auto W1 = g.make_node(random_matrix(12, 8, 2), "W1");
+  auto b1 = g.make_node(random_matrix(1, 8, 3), "b1");
+  auto W2 = g.make_node(random_matrix(8, 5, 4), "W2");
+  auto b2 = g.make_node(random_matrix(1, 5, 5), "b2");
+  ParameterStore store({W1, b1, W2, b2});
+  SGD optimizer(store, 0.1f, 0.9f);
+  bool first_step = true;
+  auto loss_fn = [&](Graph& graph, const std::vector<std::shared_ptr<Node>>& p,
+                     std::span<const int> shard) {
+    Matrix xb(static_cast<int>(shard.size()), data.X.get_cols());
+    std::vector<int> yb;
+    for (size_t i = 0; i < shard.size(); ++i) {
+      if (first_step && shard[i] == fail_at) {
+        throw std::runtime_error("injected failure");
+      }
+      for (int j = 0; j < data.X.get_cols(); ++j) {
+        xb(static_cast<int>(i), j) = data.X(shard[i], j);
+      }
+      yb.push_back(data.y[shard[i]]);
+    }
+    auto x = graph.make_node(std::move(xb), "x");
+    auto h = dense(graph, x, p[0], p[1], Activation::Sigmoid);
+    auto logits = dense(graph, h, p[2], p[3]);
+    return sparse_softmax_cross_entropy_loss(graph, logits, yb);
+  };
+  DataParallelTrainer trainer(store, optimizer, num_workers, loss_fn);
+
+  RunResult result;
+  std::vector<int> order(data.X.get_rows());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+  for (int epoch = 0; epoch < 3; ++epoch) {
+    for (size_t start = 0; start < order.size(); start += batch_size) {
+      const size_t len = std::min<size_t>(batch_size, order.size() - start);
+      try {
+        result.losses.push_back(
+            trainer.step(std::span<const int>(order).subspan(start, len)));
+      } catch (const std::runtime_error&) {
+        result.losses.push_back(-1.0f);
+      }
+      first_step = false;
+    }
+  }
+  result.params = {W1->value, b1->value, W2->value, b2->value};
+  return result;
+}
+
+bool same_run(const RunResult& a, const RunResult& b) {
+  if (a.losses.size() != b.losses.size()) return false;
+  for (size_t i = 0; i < a.losses.size(); ++i) {
+    if (std::abs(a.losses[i] - b.losses[i]) > 1e-5f) {
+      std::cerr << "  [Error] loss " << i << ": " << a.losses[i]
+                << " != " << b.losses[i] << "\n";
+      return false;
+    }
+  }
+  for (size_t i = 0; i < a.params.size(); ++i) {
+    if (!close(a.params[i], b.params[i], 1e-5f)) return false;
+  }
+  return true;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running data-parallel Test Suite ---\n";
+
+  const Data data;
+  std::cout << "\n--- Section 1: matches single-thread training ---\n";
+  {
+    const RunResult ref = train(data, 1, 8);
+    for (int workers : {2, 3, 4}) {
+      run_test(std::to_string(workers) + " workers, batch 8",
+               same_run(train(data, workers, 8), ref));
+    }
+    // 40 个样本按 6 个一批，最后一批 4 个少于 worker 数
+    const RunResult ref6 = train(data, 1, 6);
+    run_test("uneven shards and empty workers",
+             same_run(train(data, 5, 6), ref6));
+  }
+
+  std::cout << "\n--- Section 2: error handling ---\n";
+  {
+    const RunResult r = train(data, 3, 8, 6);
+    run_test("worker exception surfaces from step()", r.losses[0] == -1.0f);
+    run_test("trainer keeps working after a failed step",
+             r.losses.size() > 1 && r.losses[1] > 0.0f);
+    try {
+      Graph g;
+      auto W = g.make_node(random_matrix(2, 2, 1), "W");
+      ParameterStore store({W});
+      SGD optimizer({W}, 0.1f);
+      DataParallelTrainer trainer(
+          store, optimizer, 2,
+          [](Graph&, const std::vector<std::shared_ptr<Node>>& p,
+             std::span<const int>) { return p[0]; });
+      run_test("optimizer must target the store", false);
+    } catch (const std::invalid_argument&) {
+      run_test("optimizer must target the store", true);
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
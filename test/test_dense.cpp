@@ -0,0 +1,280 @@
+/**
+ * @file    test/test_dense.cpp
+ * @brief   验证融合 dense（GEMM + 偏置 + 激活）的前向与 dx / dW / db。
+ *
+ * @details
+ * 每种激活、有无偏置各测一遍：
+ * - 小矩阵：与 double 精度按定义计算的前向、以及中心差分的梯度比较，
+ *   损失取 Σ R ⊙ y（R 为固定随机矩阵）；
+ * - 较大、不是分块大小整数倍的矩阵：与 mul + add_with_broadcast + 激活
+ *   组成的未融合计算图比较（tanh 没有单独的算子，与 double 精度的
+ *   解析梯度比较）。
+ */
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-4f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+using Grid = std::vector<std::vector<double>>;
+
+Grid to_grid(const Matrix& m) {
+  Grid g(m.get_rows(), std::vector<double>(m.get_cols()));
+  for (int i = 0; i < m.get_rows(); ++i) {
+    for (int j = 0; j < m.get_cols(); ++j) g[i][j] = m(i, j);
+  }
+  return g;
+}
+
+Matrix to_matrix(const Grid& g) {
+  Matrix m(g.size(), g[0].size());
+  for (size_t i = 0; i < g.size(); ++i) {
+    for (size_t j = 0; j < g[i].size(); ++j) m(i, j) = static_cast<float>(g[i][j]);
+  }
+  return m;
+}
+
+double activate(double z, Activation act) {
+  switch (act) {
+    case Activation::Relu:
+      return z > 0.0 ? z : 0.0;
+    case Activation::Sigmoid:
+      return 1.0 / (1.0 + std::exp(-z));
+    case Activation::Tanh:
+      return std::tanh(z);
+    default:
+      return z;
+  }
+}
+
+// 由输出 y 求 act'(z)
+double derivative(double y, Activation act) {
+  switch (act) {
+    case Activation::Relu:
+      return y > 0.0 ? 1.0 : 0.0;
+    case Activation::Sigmoid:
+      return y * (1.0 - y);
+    case Activation::Tanh:
+      return 1.0 - y * y;
+    default:
+      return 1.0;
+  }
+}
+
+// y = act(xW + b)；b 为空表示没有偏置
+Grid reference_dense(const Grid& x, const Grid& W, const Grid* b, Activation act) {
+  const size_t M = x.size(), K = W.size(), N = W[0].size();
+  Grid y(M, std::vector<double>(N));
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      double z = b ? (*b)[0][j] : 0.0;
+      for (size_t k = 0; k < K; ++k) z += x[i][k] * W[k][j];
+      y[i][j] = activate(z, act);
+    }
+  }
+  return y;
+}
+
+// Σ R ⊙ y 对 x / W / b 的解析梯度
+struct Grads {
+  Grid dx, dW, db;
+};
+Grads reference_grads(const Grid& x, const Grid& W, const Grid& y, const Grid& R,
+                      Activation act) {
+  const size_t M = x.size(), K = W.size(), N = W[0].size();
+  Grads g{Grid(M, std::vector<double>(K)), Grid(K, std::vector<double>(N)),
+          Grid(1, std::vector<double>(N))};
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      const double dz = R[i][j] * derivative(y[i][j], act);
+      g.db[0][j] += dz;
+      for (size_t k = 0; k < K; ++k) {
+        g.dx[i][k] += dz * W[k][j];
+        g.dW[k][j] += x[i][k] * dz;
+      }
+    }
+  }
+  return g;
+}
+
+// 对 grid 中每个元素做中心差分，得到 Σ R ⊙ f() 的梯度
+Matrix numeric_grad(Grid& param, const Grid& R, const std::function<Grid()>& f) {
+  const double h = 1e-5;
+  Matrix g(param.size(), param[0].size());
+  auto loss = [&]() {
+    Grid y = f();
+    double s = 0.0;
+    for (size_t i = 0; i < y.size(); ++i) {
+      for (size_t j = 0; j < y[i].size(); ++j) s += R[i][j] * y[i][j];
+    }
+    return s;
+  };
+  for (size_t i = 0; i < param.size(); ++i) {
+    for (size_t j = 0; j < param[i].size(); ++j) {
+      const double old = param[i][j];
+      param[i][j] = old + h;
+      const double up = loss();
+      param[i][j] = old - h;
+      const double down = loss();
+      param[i][j] = old;
+      g(i, j) = static_cast<float>((up - down) / (2 * h));
+    }
+  }
+  return g;
+}
+
+struct Run {
+  Matrix y{0, 0}, dx{0, 0}, dW{0, 0}, db{0, 0};
+};
+
+// 以 Σ R ⊙ y 为损失做一次前向与反向；fused 为 false 时用未融合的算子
+Run run(const Matrix& x_val, const Matrix& W_val, const Matrix& b_val, bool bias,
+        Activation act, const Matrix& R, bool fused) {
+  Graph g;
+  auto x = g.make_node(x_val, "x");
+  auto W = g.make_node(W_val, "W");
+  auto b = g.make_node(b_val, "b");
+  std::shared_ptr<Node> y;
+  if (fused) {
+    y = dense(g, x, W, bias ? b : nullptr, act);
+  } else {
+    y = mul(g, x, W);
+    if (bias) y = add_with_broadcast(g, y, b);
+    if (act == Activation::Relu) y = relu(g, y);
+    if (act == Activation::Sigmoid) y = sigmoid(g, y);
+  }
+  sum(g, element_mul(g, y, g.make_node(R, "R")))->backward();
+  return {y->value, x->grad, W->grad, b->grad};
+}
+
+const char* name_of(Activation act) {
+  switch (act) {
+    case Activation::Relu:
+      return "relu";
+    case Activation::Sigmoid:
+      return "sigmoid";
+    case Activation::Tanh:
+      return "tanh";
+    default:
+      return "none";
+  }
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running dense Test Suite ---\n";
+  const Activation activations[] = {Activation::None, Activation::Relu,
+                                    Activation::Sigmoid, Activation::Tanh};
+
+  std::cout << "\n--- Section 1: reference and finite differences ---\n";
+  {
+    const int M = 5, K = 7, N = 6;
+    const Matrix x_val = random_matrix(M, K, 1);
+    const Matrix W_val = random_matrix(K, N, 2);
+    const Matrix b_val = random_matrix(1, N, 3);
+    const Matrix R = random_matrix(M, N, 4);
+    for (Activation act : activations) {
+      for (bool bias : {true, false}) {
+        const std::string name =
+            std::string(name_of(act)) + (bias ? " + bias" : " no bias");
+        const Run r = run(x_val, W_val, b_val, bias, act, R, true);
+        Grid xg = to_grid(x_val), Wg = to_grid(W_val), bg = to_grid(b_val),
+             Rg = to_grid(R);
+        auto f = [&]() { return reference_dense(xg, Wg, bias ? &bg : nullptr, act); };
+        run_test(name + ": forward", compare_matrices(r.y, to_matrix(f())));
+        bool grads = compare_matrices(r.dx, numeric_grad(xg, Rg, f), 1e-3f) &&
+                     compare_matrices(r.dW, numeric_grad(Wg, Rg, f), 1e-3f);
+        // 没有偏置时 b 不参与计算，梯度保持为 0
+        grads = grads && compare_matrices(r.db, bias ? numeric_grad(bg, Rg, f)
+                                                     : Matrix(1, N),
+                                          1e-3f);
+        run_test(name + ": dx, dW, db", grads);
+      }
+    }
+  }
+
+  std::cout << "\n--- Section 2: against the unfused graph ---\n";
+  {
+    // 不是分块与向量宽度的整数倍，覆盖各个尾部
+    const int M = 37, K = 70, N = 45;
+    const Matrix x_val = random_matrix(M, K, 5);
+    const Matrix W_val = random_matrix(K, N, 6);
+    const Matrix b_val = random_matrix(1, N, 7);
+    const Matrix R = random_matrix(M, N, 8);
+    for (Activation act : activations) {
+      for (bool bias : {true, false}) {
+        const std::string name =
+            std::string(name_of(act)) + (bias ? " + bias" : " no bias");
+        const Run fused = run(x_val, W_val, b_val, bias, act, R, true);
+        Run expected;
+        if (act == Activation::Tanh) {
+          const Grid bg = to_grid(b_val);
+          const Grid y = reference_dense(to_grid(x_val), to_grid(W_val),
+                                         bias ? &bg : nullptr, act);
+          const Grads g =
+              reference_grads(to_grid(x_val), to_grid(W_val), y, to_grid(R), act);
+          expected = {to_matrix(y), to_matrix(g.dx), to_matrix(g.dW),
+                      bias ? to_matrix(g.db) : Matrix(1, N)};
+        } else {
+          expected = run(x_val, W_val, b_val, bias, act, R, false);
+        }
+        run_test(name + ": forward", compare_matrices(fused.y, expected.y));
+        run_test(name + ": dx, dW, db",
+                 compare_matrices(fused.dx, expected.dx) &&
+                     compare_matrices(fused.dW, expected.dW) &&
+                     compare_matrices(fused.db, expected.db));
+      }
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file    test/test_dropout.cpp
+ * @brief   验证 Philox 随机数发生器与 dropout 算子。
+ *
+ * @details
+ * Philox4x32-10 与 Random123 公布的已知答案比较；dropout 检查保留比例、
+ * 缩放、确定性、不同 step 的掩码不同，以及反向重新生成的掩码与前向一致。
+ */
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Philox.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running dropout Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: Philox known answers ---\n";
+  {
+    constexpr philox::Block zero = philox::philox4x32({0, 0, 0, 0}, 0, 0);
+    static_assert(zero[0] == 0x6627e8d5u && zero[3] == 0x9b00dbd8u);
+    run_test("Philox: zero counter/key",
+             zero == philox::Block{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu,
+                                   0x9b00dbd8u});
+    philox::Block pi = philox::philox4x32(
+        {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}, 0xa4093822u,
+        0x299f31d0u);
+    run_test("Philox: pi counter/key",
+             pi == philox::Block{0xd16cfe09u, 0x94fdccebu, 0x5001e420u,
+                                 0x24126ea1u});
+  }
+
+  std::cout << "\n--- Section 2: dropout forward ---\n";
+  const int rows = 64, cols = 257;  // 元素数不是 4 的倍数，覆盖尾块
+  const float p = 0.3f;
+  {
+    Graph g;
+    auto x = g.make_node(Matrix(rows, cols, 2.0f), "x");
+    auto y = dropout(g, x, p, 42, 7);
+    int kept = 0;
+    bool values_ok = true;
+    for (int i = 0; i < rows; ++i) {
+      for (int j = 0; j < cols; ++j) {
+        const float v = y->value(i, j);
+        if (v != 0.0f) {
+          ++kept;
+          values_ok = values_ok && std::abs(v - 2.0f / (1.0f - p)) < 1e-6f;
+        }
+      }
+    }
+    const double keep_rate = static_cast<double>(kept) / (rows * cols);
+    run_test("dropout: keep rate ~ 1 - p", std::abs(keep_rate - (1 - p)) < 0.02);
+    run_test("dropout: kept values scaled by 1/(1-p)", values_ok);
+
+    auto y2 = dropout(g, x, p, 42, 7);
+    bool same = true, differs = false;
+    auto y3 = dropout(g, x, p, 42, 8);
+    for (int i = 0; i < rows; ++i) {
+      for (int j = 0; j < cols; ++j) {
+        same = same && y->value(i, j) == y2->value(i, j);
+        differs = differs || y->value(i, j) != y3->value(i, j);
+      }
+    }
+    run_test("dropout: same (seed, step) gives same mask", same);
+    run_test("dropout: different step gives different mask", differs);
+
+    run_test("dropout: inference returns input", dropout(g, x, p, 42, 7, false) == x);
+    try {
+      dropout(g, x, 1.0f, 42, 7);
+      run_test("dropout: rejects p = 1", false);
+    } catch (const std::invalid_argument&) {
+      run_test("dropout: rejects p = 1", true);
+    }
+  }
+
+  std::cout << "\n--- Section 3: dropout backward ---\n";
+  {
+    Graph g;
+    auto x = g.make_node(Matrix(rows, cols, 1.0f), "x");
+    auto y = dropout(g, x, p, 3, 11);
+    sum(g, y)->backward();
+    // 输入全为 1 时，x 的梯度应与输出逐元素相同（同一掩码、同一缩放）
+    bool match = true;
+    for (int i = 0; i < rows; ++i) {
+      for (int j = 0; j < cols; ++j) {
+        match = match && x->grad(i, j) == y->value(i, j);
+      }
+    }
+    run_test("dropout: backward regenerates forward mask", match);
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file    test/test_evaluator.cpp
+ * @brief   验证 argmax 计算核、分类指标，以及分批 / 异步评估与计算图前向一致。
+ */
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/Evaluator.h"
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/ops/fused_kernels.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, std::mt19937& gen) {
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+int naive_argmax(const Matrix& m, int row) {
+  int best = 0;
+  for (int j = 1; j < m.get_cols(); ++j) {
+    if (m(row, j) > m(row, best)) best = j;
+  }
+  return best;
+}
+
+// 在计算图上整体前向，得到参考的混淆矩阵
+std::vector<int64_t> graph_confusion(const std::vector<std::shared_ptr<Node>>& params,
+                                     const Matrix& X, const std::vector<int>& y,
+                                     int classes, Precision precision) {
+  Graph graph;
+  auto x = graph.make_node(X, "X");
+  const size_t num_layers = params.size() / 2;
+  for (size_t l = 0; l < num_layers; ++l) {
+    x = dense(graph, x, params[2 * l], params[2 * l + 1],
+              l + 1 == num_layers ? Activation::None : Activation::Relu, precision);
+  }
+  std::vector<int64_t> confusion(static_cast<size_t>(classes) * classes, 0);
+  for (int i = 0; i < X.get_rows(); ++i) {
+    confusion[static_cast<size_t>(y[i]) * classes + naive_argmax(x->value, i)]++;
+  }
+  return confusion;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running evaluator Test Suite ---\n";
+  std::mt19937 gen(11);
+
+  std::cout << "\n--- Section 1: argmax kernel ---\n";
+  {
+    const Matrix m = random_matrix(130, 10, gen);  // 130 行跨过两个整块加尾块
+    std::vector<int> out(m.get_rows());
+    argmax_rows_kernel(m, out);
+    bool ok = true;
+    for (int i = 0; i < m.get_rows(); ++i) ok = ok && out[i] == naive_argmax(m, i);
+    run_test("matches a scalar loop", ok);
+
+    Matrix ties(3, 4, 1.0f);
+    ties(1, 2) = 2.0f;
+    ties(1, 3) = 2.0f;
+    ties(2, 0) = -1.0f;
+    std::vector<int> tie_out(3);
+    argmax_rows_kernel(ties, tie_out);
+    run_test("ties resolve to the lowest column",
+             tie_out[0] == 0 && tie_out[1] == 2 && tie_out[2] == 1);
+
+    std::vector<int> small(2);
+    try {
+      argmax_rows_kernel(ties, small);
+      run_test("short output rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("short output rejected", true);
+    }
+  }
+
+  std::cout << "\n--- Section 2: metrics ---\n";
+  {
+    EvalResult r;
+    r.num_classes = 3;
+    // 第 2 类从未出现也从未被预测
+    r.confusion = {3, 1, 0,
+                   2, 4, 0,
+                   0, 0, 0};
+    auto near = [](double a, double b) { return std::abs(a - b) < 1e-9; };
+    run_test("total and correct", r.total() == 10 && r.correct() == 7);
+    run_test("accuracy", near(r.accuracy(), 70.0));
+    run_test("precision and recall",
+             near(r.precision(0), 60.0) && near(r.recall(0), 75.0) &&
+                 near(r.precision(1), 80.0) && near(r.recall(1), 100.0 * 4 / 6));
+    run_test("f1", near(r.f1(0), 2.0 * 60.0 * 75.0 / 135.0));
+    run_test("empty class scores zero",
+             r.precision(2) == 0.0 && r.recall(2) == 0.0 && r.f1(2) == 0.0);
+    run_test("macro f1 averages all classes",
+             near(r.macro_f1(), (r.f1(0) + r.f1(1)) / 3.0));
+    run_test("empty result", EvalResult{}.accuracy() == 0.0);
+  }
+
+  // 20-16-12-5 的网络，300 个样本
+  Graph owner;
+  std::vector<std::shared_ptr<Node>> params;
+  const std::vector<int> layers{20, 16, 12, 5};
+  for (size_t l = 0; l + 1 < layers.size(); ++l) {
+    params.push_back(owner.make_node(random_matrix(layers[l], layers[l + 1], gen), "W"));
+    params.push_back(owner.make_node(random_matrix(1, layers[l + 1], gen), "b"));
+  }
+  const Matrix X = random_matrix(300, 20, gen);
+  std::vector<int> y(X.get_rows());
+  for (int i = 0; i < X.get_rows(); ++i) y[i] = i % 5;
+
+  std::cout << "\n--- Section 3: batched evaluation ---\n";
+  {
+    const auto expected = graph_confusion(params, X, y, 5, Precision::FP32);
+    bool ok = true;
+    for (int batch : {1, 7, 64, 300, 1000}) {
+      Evaluator evaluator(Activation::Relu, Precision::FP32, batch);
+      const EvalResult r = evaluator.evaluate(params, X, y);
+      if (r.num_classes != 5 || r.confusion != expected) {
+        std::cerr << "  [Error] batch size " << batch << " differs\n";
+        ok = false;
+      }
+    }
+    run_test("any batch size matches the graph forward", ok);
+
+    Evaluator evaluator(Activation::Relu, Precision::FP32, 64);
+    const EvalResult first = evaluator.evaluate(params, X, y);
+    const EvalResult second = evaluator.evaluate(params, X, y);
+    run_test("reused buffers give the same result", first.confusion == second.confusion);
+
+    Evaluator bf16(Activation::Relu, Precision::BF16, 64);
+    run_test("bf16 matches the bf16 graph forward",
+             bf16.evaluate(params, X, y).confusion ==
+                 graph_confusion(params, X, y, 5, Precision::BF16));
+
+    const Matrix empty(0, 20);
+    run_test("empty data set", evaluator.evaluate(params, empty, {}).total() == 0);
+  }
+
+  std::cout << "\n--- Section 4: asynchronous evaluation ---\n";
+  {
+    Evaluator evaluator(Activation::Relu, Precision::FP32, 32);
+    const EvalResult expected = evaluator.evaluate(params, X, y);
+    auto future = evaluator.evaluate_async(params, X, y);
+    // 后台线程用的是快照，之后修改参数不影响结果
+    const Matrix saved = params[4]->value;
+    params[4]->value.fill(0.0f);
+    const EvalResult r = future.get();
+    params[4]->value = saved;
+    run_test("uses a snapshot of the parameters", r.confusion == expected.confusion);
+  }
+
+  std::cout << "\n--- Section 5: errors ---\n";
+  {
+    try {
+      Evaluator bad(Activation::Relu, Precision::FP32, 0);
+      run_test("non-positive batch size rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("non-positive batch size rejected", true);
+    }
+    Evaluator evaluator(Activation::Relu);
+    std::vector<int> bad_labels = y;
+    bad_labels[17] = 5;
+    try {
+      evaluator.evaluate(params, X, bad_labels);
+      run_test("out-of-range label rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("out-of-range label rejected", true);
+    }
+    try {
+      evaluator.evaluate(params, X, std::vector<int>(10, 0));
+      run_test("label count mismatch rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("label count mismatch rejected", true);
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file    test/test_fusion.cpp
+ * @brief   验证 fuse_dense_chains 把 act(add_with_broadcast(mul(X, W), b)) 改写为
+ *          融合 dense 节点后，梯度与未改写的计算图一致。
+ *
+ * @details
+ * 同一个三层网络分别以未融合、融合（顺序反向与线程池并行反向）的方式求梯度，
+ * 逐元素比较；并检查改写后的节点结构、中间缓冲区的释放，以及中间结果
+ * 另有使用者时不融合。
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/ThreadPool.h"
+#include "../src/ops/fusion.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-5f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+struct Result {
+  float loss = 0.0f;
+  std::vector<Matrix> grads;  // x, W1, b1, W2, b2, W3, b3
+  int fused = 0;
+  std::vector<std::shared_ptr<Node>> tails;
+  std::shared_ptr<Node> inner_mul;  // 第一层的 mul 节点
+};
+
+// 三层：sigmoid 层、原地 relu 层、无激活的输出层
+Result run_network(bool fuse, ThreadPool* pool) {
+  Graph g;
+  auto x = g.make_node(random_matrix(16, 12, 1), "x");
+  auto W1 = g.make_node(random_matrix(12, 10, 2), "W1");
+  auto b1 = g.make_node(random_matrix(1, 10, 3), "b1");
+  auto W2 = g.make_node(random_matrix(10, 8, 4), "W2");
+  auto b2 = g.make_node(random_matrix(1, 8, 5), "b2");
+  auto W3 = g.make_node(random_matrix(8, 4, 6), "W3");
+  auto b3 = g.make_node(random_matrix(1, 4, 7), "b3");
+
+  Result r;
+  r.inner_mul = mul(g, x, W1);
+  auto h1 = sigmoid(g, add_with_broadcast(g, r.inner_mul, b1));
+  auto h2 = relu_(g, add_with_broadcast(g, mul(g, h1, W2), b2));
+  auto logits = add_with_broadcast(g, mul(g, h2, W3), b3);
+  std::vector<int> labels(16);
+  for (int i = 0; i < 16; ++i) labels[i] = i % 4;
+  auto loss = sparse_softmax_cross_entropy_loss(g, logits, labels);
+
+  if (fuse) r.fused = fuse_dense_chains(loss);
+  if (pool != nullptr) {
+    loss->backward(*pool);
+  } else {
+    loss->backward();
+  }
+  r.loss = loss->value(0, 0);
+  r.grads = {x->grad, W1->grad, b1->grad, W2->grad, b2->grad, W3->grad, b3->grad};
+  r.tails = {h1, h2, logits};
+  return r;
+}
+
+bool same_grads(const Result& a, const Result& b) {
+  bool ok = a.grads.size() == b.grads.size();
+  for (size_t i = 0; ok && i < a.grads.size(); ++i) {
+    ok = compare_matrices(a.grads[i], b.grads[i]);
+  }
+  return ok;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running fusion Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: rewrite ---\n";
+  const Result reference = run_network(false, nullptr);
+  const Result fused = run_network(true, nullptr);
+  run_test("three chains fused", fused.fused == 3);
+  bool structure = true;
+  for (const auto& t : fused.tails) {
+    structure = structure && t->name == "dense" && t->parent.size() == 3;
+  }
+  run_test("chain tails become dense nodes with inputs {x, W, b}", structure);
+  run_test("intermediate buffers released",
+           fused.inner_mul->value.numel() == 0 && fused.inner_mul->grad.numel() == 0 &&
+               fused.inner_mul->parent.empty());
+  run_test("loss unchanged", fused.loss == reference.loss);
+
+  std::cout << "\n--- Section 2: gradients ---\n";
+  run_test("fused backward matches the unfused graph", same_grads(reference, fused));
+  ThreadPool pool(4);
+  bool parallel = true;
+  for (int i = 0; i < 10; ++i) {
+    parallel = parallel && same_grads(reference, run_network(true, &pool));
+  }
+  run_test("fused parallel backward matches", parallel);
+
+  std::cout << "\n--- Section 3: shared intermediates ---\n";
+  {
+    // mul 的结果另有使用者：改写会丢掉它那一路的梯度
+    Graph g;
+    auto x = g.make_node(random_matrix(4, 3, 8), "x");
+    auto W = g.make_node(random_matrix(3, 2, 9), "W");
+    auto b = g.make_node(random_matrix(1, 2, 10), "b");
+    auto m = mul(g, x, W);
+    auto h = sigmoid(g, add_with_broadcast(g, m, b));
+    auto loss = sum(g, add(g, h, m));
+    run_test("shared intermediate left alone",
+             fuse_dense_chains(loss) == 0 && h->name == "Sigmoid");
+
+    // add 的使用者不在 root 的子图中：激活不能并入，只融合 mul + add
+    Graph g2;
+    auto x2 = g2.make_node(random_matrix(4, 3, 8), "x");
+    auto W2 = g2.make_node(random_matrix(3, 2, 9), "W");
+    auto b2 = g2.make_node(random_matrix(1, 2, 10), "b");
+    auto pre = add_with_broadcast(g2, mul(g2, x2, W2), b2);
+    auto h2 = relu(g2, pre);
+    auto other = sum(g2, pre);
+    run_test("consumer outside the subgraph respected",
+             fuse_dense_chains(sum(g2, h2)) == 1 && h2->name == "Relu" &&
+                 pre->name == "dense" && pre->value.numel() == 8 &&
+                 other->parent.size() == 1);
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file    test/test_hogwild.cpp
+ * @brief   验证 Hogwild 异步 SGD 的正确性与收敛。
+ *
+ * @details
+ * 单个 worker 时 Hogwild 就是普通的逐批 SGD，结果应与同步训练一致；
+ * 多个 worker 时更新顺序不确定，只检查每个批次恰好处理一次且损失下降；
+ * worker 中的异常应在 run_epoch() 中重新抛出。
+ */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/DataParallelTrainer.h"
+#include "../src/core/Graph.h"
+#include "../src/core/HogwildTrainer.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Optimizer.h"
+#include "../src/core/ParameterStore.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool close(const Matrix& a, const Matrix& b, float epsilon) {
+  for (int i = 0; i < a.get_rows(); ++i) {
+    for (int j = 0; j < a.get_cols(); ++j) {
+      if (std::abs(a(i, j) - b(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << a(i, j) << " != " << b(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// 类别由第 y 个特征加上偏移决定，线性可分，便于观察收敛
+struct Data {
+  Matrix X = random_matrix(200, 12, 1);
+  std::vector<int> y;
+  Data() {
+    for (int i = 0; i < X.get_rows(); ++i) {
+      y.push_back(i % 4);
+      X(i, i % 4) += 3.0f;
+    }
+  }
+};
+
+struct Model {
+  Graph g;
+  std::shared_ptr<Node> W, b;
+  std::unique_ptr<ParameterStore> store;
+  Model() {
+    W = g.make_node(random_matrix(12, 4, 2), "W");
+    b = g.make_node(random_matrix(1, 4, 3), "b");
+    store = std::make_unique<ParameterStore>(
+        std::vector<std::shared_ptr<Node>>{W, b});
+  }
+};
+
+DataParallelTrainer::LossFn make_loss(const Data& data, int* calls,
+                                      int fail_at = -1) {
+  return [&data, calls, fail_at](Graph& graph,
+                                 const std::vector<std::shared_ptr<Node>>& p,
+                                 std::span<const int> shard) {
+    Matrix xb(static_cast<int>(shard.size()), data.X.get_cols());
+    std::vector<int> yb;
+    for (size_t i = 0; i < shard.size(); ++i) {
+      if (shard[i] == fail_at) throw std::runtime_error("injected failure");
+      for (int j = 0; j < data.X.get_cols(); ++j) {
+        xb(static_cast<int>(i), j) = data.X(shard[i], j);
+      }
+      yb.push_back(data.y[shard[i]]);
+    }
+    if (calls != nullptr) {
+      std::atomic_ref<int>(*calls).fetch_add(1, std::memory_order_relaxed);
+    }
+    auto x = graph.make_node(std::move(xb), "x");
+    return sparse_softmax_cross_entropy_loss(graph, dense(graph, x, p[0], p[1]),
+                                             yb);
+  };
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running hogwild Test Suite ---\n";
+
+  const Data data;
+  std::vector<int> order(data.X.get_rows());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+
+  std::cout << "\n--- Section 1: one worker equals plain SGD ---\n";
+  {
+    Model a, b;
+    HogwildTrainer hogwild(*a.store, 1, 0.1f, make_loss(data, nullptr));
+    SGD optimizer(*b.store, 0.1f);
+    DataParallelTrainer sync(*b.store, optimizer, 1, make_loss(data, nullptr));
+    float hog_loss = 0.0f;
+    double sync_loss = 0.0;
+    for (int epoch = 0; epoch < 2; ++epoch) {
+      hog_loss = hogwild.run_epoch(order, 16);
+      sync_loss = 0.0;
+      int batches = 0;
+      for (size_t s = 0; s < order.size(); s += 16) {
+        const size_t len = std::min<size_t>(16, order.size() - s);
+        sync_loss += sync.step(std::span<const int>(order).subspan(s, len));
+        batches++;
+      }
+      sync_loss /= batches;
+    }
+    run_test("same parameters",
+             close(a.W->value, b.W->value, 1e-6f) &&
+                 close(a.b->value, b.b->value, 1e-6f));
+    run_test("same average loss", std::abs(hog_loss - sync_loss) < 1e-5);
+  }
+
+  std::cout << "\n--- Section 2: several workers ---\n";
+  {
+    Model m;
+    int calls = 0;
+    HogwildTrainer hogwild(*m.store, 4, 0.1f, make_loss(data, &calls));
+    const float first = hogwild.run_epoch(order, 8);
+    float last = first;
+    for (int epoch = 0; epoch < 5; ++epoch) last = hogwild.run_epoch(order, 8);
+    run_test("every batch processed exactly once", calls == 6 * 25);
+    run_test("loss decreases", last < 0.5f * first);
+  }
+
+  std::cout << "\n--- Section 3: error handling ---\n";
+  {
+    Model m;
+    HogwildTrainer hogwild(*m.store, 3, 0.1f, make_loss(data, nullptr, 57));
+    try {
+      hogwild.run_epoch(order, 8);
+      run_test("worker exception surfaces from run_epoch()", false);
+    } catch (const std::runtime_error&) {
+      run_test("worker exception surfaces from run_epoch()", true);
+    }
+    try {
+      HogwildTrainer bad(*m.store, 0, 0.1f, make_loss(data, nullptr));
+      run_test("zero workers rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("zero workers rejected", true);
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file    test/test_idx_dataset.cpp
+ * @brief   验证 IDX 读取：大端文件头、像素与标签、归一化、批量解码以及格式错误。
+ */
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/IdxDataSet.h"
+#include "../src/core/Matrix.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+void put_be32(std::vector<uint8_t>& out, uint32_t v) {
+  for (int shift = 24; shift >= 0; shift -= 8) out.push_back((v >> shift) & 0xFF);
+}
+
+uint8_t pixel(int n, int i) { return static_cast<uint8_t>((n * 37 + i * 11) % 256); }
+
+// n 张 rows x cols 的图像与对应标签
+std::vector<uint8_t> make_images(int n, int rows, int cols) {
+  std::vector<uint8_t> out{0, 0, 0x08, 3};
+  put_be32(out, n);
+  put_be32(out, rows);
+  put_be32(out, cols);
+  for (int k = 0; k < n; ++k) {
+    for (int i = 0; i < rows * cols; ++i) out.push_back(pixel(k, i));
+  }
+  return out;
+}
+
+std::vector<uint8_t> make_labels(int n) {
+  std::vector<uint8_t> out{0, 0, 0x08, 1};
+  put_be32(out, n);
+  for (int k = 0; k < n; ++k) out.push_back(static_cast<uint8_t>(k % 10));
+  return out;
+}
+
+void write_file(const std::string& path, const std::vector<uint8_t>& bytes) {
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+}
+
+template <typename F>
+bool throws_runtime(F&& f) {
+  try {
+    f();
+  } catch (const std::runtime_error&) {
+    return true;
+  }
+  return false;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running idx dataset Test Suite ---\n";
+  const std::string images = "test-images-idx3-ubyte";
+  const std::string labels = "test-labels-idx1-ubyte";
+
+  std::cout << "\n--- Section 1: reading ---\n";
+  {
+    // 行列数不同，能发现维度顺序读反
+    write_file(images, make_images(300, 4, 3));
+    write_file(labels, make_labels(300));
+    IdxDataSet d(images, labels);
+    run_test("header parsed",
+             d.size() == 300 && d.image_rows() == 4 && d.image_cols() == 3 &&
+                 d.num_features() == 12);
+    run_test("raw pixels and labels",
+             d.pixels(257)[5] == pixel(257, 5) && d.label(257) == 7);
+
+    const auto [x, y] = d.get_item(42);
+    bool ok = x.get_rows() == 1 && x.get_cols() == 12 && y(0, 0) == 2.0f;
+    for (int i = 0; i < 12; ++i) {
+      ok = ok && x(0, i) == static_cast<float>(pixel(42, i)) / 255.0f;
+    }
+    run_test("get_item normalizes on the fly", ok);
+
+    IdxDataSet raw(images, labels, false);
+    run_test("normalization can be disabled",
+             raw.get_item(42).first(0, 3) == static_cast<float>(pixel(42, 3)));
+
+    const Matrix all = d.get_features();
+    const std::vector<int> all_labels = d.get_labels();
+    bool same = all.get_rows() == 300 && all_labels.size() == 300;
+    for (int k = 0; same && k < 300; k += 37) {
+      const auto item = d.get_item(k);
+      for (int i = 0; i < 12; ++i) same = same && all(k, i) == item.first(0, i);
+      same = same && all_labels[k] == static_cast<int>(item.second(0, 0));
+    }
+    run_test("full decode matches get_item", same);
+
+    Matrix batch(8, 12);
+    d.decode(290, 295, batch);
+    run_test("partial decode", batch(4, 7) == all(294, 7));
+
+    bool out_of_range = false;
+    try {
+      d.get_item(300);
+    } catch (const std::out_of_range&) {
+      out_of_range = true;
+    }
+    run_test("index out of range rejected", out_of_range);
+    run_test("labels path derived from the images path",
+             IdxDataSet::labels_path_for("data/train-images-idx3-ubyte") ==
+                     "data/train-labels-idx1-ubyte" &&
+                 IdxDataSet::labels_path_for("data/mnist_train.csv").empty());
+  }
+
+  std::cout << "\n--- Section 2: errors ---\n";
+  {
+    write_file(labels, make_labels(299));
+    run_test("count mismatch rejected",
+             throws_runtime([&] { IdxDataSet d(images, labels); }));
+
+    write_file(labels, make_labels(300));
+    std::vector<uint8_t> truncated = make_images(300, 4, 3);
+    truncated.pop_back();
+    write_file(images, truncated);
+    run_test("truncated file rejected",
+             throws_runtime([&] { IdxDataSet d(images, labels); }));
+
+    // 标签文件当作图像文件
+    run_test("wrong dimensionality rejected",
+             throws_runtime([&] { IdxDataSet d(labels, labels); }));
+
+    std::vector<uint8_t> floats = make_images(300, 4, 3);
+    floats[2] = 0x0D;
+    write_file(images, floats);
+    run_test("non-uint8 data rejected",
+             throws_runtime([&] { IdxDataSet d(images, labels); }));
+    run_test("missing file rejected",
+             throws_runtime([&] { IdxDataSet d("no-images-idx3-ubyte", labels); }));
+  }
+  std::remove(images.c_str());
+  std::remove(labels.c_str());
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file    test/test_inplace.cpp
+ * @brief   验证原地激活 relu_ / sigmoid_ 的正确性与安全条件。
+ *
+ * @details
+ * 原地版本与普通版本的输出和梯度必须一致（包括线程池并行反向）；
+ * 条件不满足时（叶子节点、已有消费者、自身反向读取输出）应退化为
+ * 普通版本；被覆盖的节点再作为输入时应抛出异常。
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/ThreadPool.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-6f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// 两层 MLP，激活分别用原地或普通版本；返回 {输出, dx, dW1, db1, dW2}
+std::vector<Matrix> run_mlp(bool inplace, ThreadPool* pool) {
+  Graph g;
+  auto x = g.make_node(random_matrix(8, 6, 1), "x");
+  auto W1 = g.make_node(random_matrix(6, 5, 2), "W1");
+  auto b1 = g.make_node(random_matrix(1, 5, 3), "b1");
+  auto W2 = g.make_node(random_matrix(5, 4, 4), "W2");
+  auto h = dense(g, x, W1, b1);
+  auto a = inplace ? relu_(g, h) : relu(g, h);
+  auto z = mul(g, a, W2);
+  auto y = inplace ? sigmoid_(g, z) : sigmoid(g, z);
+  auto loss = sum(g, y);
+  if (pool != nullptr) {
+    loss->backward(*pool);
+  } else {
+    loss->backward();
+  }
+  return {y->value, x->grad, W1->grad, b1->grad, W2->grad};
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running in-place activation Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: results match out-of-place ops ---\n";
+  {
+    ThreadPool pool(4);
+    std::vector<Matrix> ref = run_mlp(false, nullptr);
+    for (ThreadPool* p : {static_cast<ThreadPool*>(nullptr), &pool}) {
+      const std::string mode = p ? "parallel" : "serial";
+      std::vector<Matrix> got = run_mlp(true, p);
+      const char* names[] = {"output", "dx", "dW1", "db1", "dW2"};
+      for (size_t i = 0; i < ref.size(); ++i) {
+        run_test(mode + ": " + names[i], compare_matrices(got[i], ref[i]));
+      }
+    }
+  }
+
+  std::cout << "\n--- Section 2: storage sharing ---\n";
+  {
+    Graph g;
+    auto x = g.make_node(random_matrix(4, 3, 5), "x");
+    auto W = g.make_node(random_matrix(3, 3, 6), "W");
+    auto h = mul(g, x, W);
+    auto a = relu_(g, h);
+    run_test("relu_: shares value with input",
+             a->value.shares_storage_with(h->value));
+    run_test("relu_: shares grad with input",
+             a->grad.shares_storage_with(h->grad));
+    run_test("relu_: input marked overwritten", h->value_overwritten());
+    try {
+      add(g, h, h);
+      run_test("relu_: overwritten input rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("relu_: overwritten input rejected", true);
+    }
+  }
+
+  std::cout << "\n--- Section 3: unsafe cases fall back ---\n";
+  {
+    Graph g;
+    auto x = g.make_node(random_matrix(4, 3, 7), "x");
+    auto W = g.make_node(random_matrix(3, 3, 8), "W");
+
+    auto leaf = relu_(g, x);
+    run_test("leaf input is not overwritten",
+             !leaf->value.shares_storage_with(x->value) &&
+                 !x->value_overwritten());
+
+    auto h = mul(g, x, W);
+    auto other = sum(g, h);  // h 已有消费者
+    auto a = relu_(g, h);
+    run_test("input with consumers is not overwritten",
+             !a->value.shares_storage_with(h->value));
+
+    auto s = sigmoid(g, mul(g, x, W));  // sigmoid 的反向读取自身输出
+    auto r = relu_(g, s);
+    run_test("input whose backward reads its value is not overwritten",
+             !r->value.shares_storage_with(s->value));
+    (void)other;
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
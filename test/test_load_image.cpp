@@ -22,7 +22,7 @@ int get_predicted_class(const Matrix &prediction_row) {
 }
 
 void data_set(Matrix &source) {
-  std::vector<float> &data = source.get_data();
+  std::span<float> data = source.get_data();
 
   for (auto &i : data) {
     if (i > 0.1f)
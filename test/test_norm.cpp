@@ -0,0 +1,203 @@
+/**
+ * @file    test/test_norm.cpp
+ * @brief   验证 batch_norm / layer_norm 的前向、反向与 fold_batch_norm。
+ *
+ * @details
+ * 参考实现用 double 按定义两遍计算均值方差；梯度与 double 精度的
+ * 中心差分比较，损失取 Σ R ⊙ y（R 为固定随机矩阵）。
+ */
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed, float lo = -1.0f,
+                     float hi = 1.0f) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(lo, hi);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-4f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+using Grid = std::vector<std::vector<double>>;
+
+Grid to_grid(const Matrix& m) {
+  Grid g(m.get_rows(), std::vector<double>(m.get_cols()));
+  for (int i = 0; i < m.get_rows(); ++i) {
+    for (int j = 0; j < m.get_cols(); ++j) g[i][j] = m(i, j);
+  }
+  return g;
+}
+
+// 按定义的归一化；by_row 为 true 时是 layer_norm，否则是 batch_norm
+Grid reference_norm(const Grid& x, const Grid& gamma, const Grid& beta,
+                    bool by_row, double eps) {
+  const size_t N = x.size(), F = x[0].size();
+  Grid y(N, std::vector<double>(F));
+  const size_t groups = by_row ? N : F;
+  const size_t count = by_row ? F : N;
+  for (size_t g = 0; g < groups; ++g) {
+    auto at = [&](size_t k) { return by_row ? x[g][k] : x[k][g]; };
+    double mean = 0.0, var = 0.0;
+    for (size_t k = 0; k < count; ++k) mean += at(k);
+    mean /= count;
+    for (size_t k = 0; k < count; ++k) var += (at(k) - mean) * (at(k) - mean);
+    var /= count;
+    for (size_t k = 0; k < count; ++k) {
+      const size_t i = by_row ? g : k, j = by_row ? k : g;
+      y[i][j] = gamma[0][j] * (at(k) - mean) / std::sqrt(var + eps) +
+                beta[0][j];
+    }
+  }
+  return y;
+}
+
+// 对 grid 中每个元素做中心差分，得到 Σ R ⊙ f() 的梯度
+Matrix numeric_grad(Grid& param, const Grid& R,
+                    const std::function<Grid()>& f) {
+  const double h = 1e-4;
+  Matrix g(param.size(), param[0].size());
+  auto loss = [&]() {
+    Grid y = f();
+    double s = 0.0;
+    for (size_t i = 0; i < y.size(); ++i) {
+      for (size_t j = 0; j < y[i].size(); ++j) s += R[i][j] * y[i][j];
+    }
+    return s;
+  };
+  for (size_t i = 0; i < param.size(); ++i) {
+    for (size_t j = 0; j < param[i].size(); ++j) {
+      const double old = param[i][j];
+      param[i][j] = old + h;
+      const double up = loss();
+      param[i][j] = old - h;
+      const double down = loss();
+      param[i][j] = old;
+      g(i, j) = static_cast<float>((up - down) / (2 * h));
+    }
+  }
+  return g;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running normalization Test Suite ---\n";
+
+  const int N = 6, F = 13;  // F 不是 8 的倍数，覆盖行内 Welford 的尾部
+  const float eps = 1e-5f;
+  for (bool by_row : {false, true}) {
+    const std::string name = by_row ? "layer_norm" : "batch_norm";
+    Matrix x_val = random_matrix(N, F, 1, 2.0f, 5.0f);  // 均值远离 0
+    Matrix R = random_matrix(N, F, 2);
+    Graph g;
+    auto x = g.make_node(x_val, "x");
+    auto gamma = g.make_node(random_matrix(1, F, 3, 0.5f, 1.5f), "gamma");
+    auto beta = g.make_node(random_matrix(1, F, 4), "beta");
+    BatchNormState state(F);
+    auto y = by_row ? layer_norm(g, x, gamma, beta, eps)
+                    : batch_norm(g, x, gamma, beta, state, true);
+    auto r = g.make_node(R, "R");
+    sum(g, element_mul(g, y, r))->backward();
+
+    Grid xg = to_grid(x->value), gg = to_grid(gamma->value),
+         bg = to_grid(beta->value), Rg = to_grid(R);
+    auto f = [&]() { return reference_norm(xg, gg, bg, by_row, eps); };
+    Grid y_ref = f();
+    Matrix y_ref_m(N, F);
+    for (int i = 0; i < N; ++i) {
+      for (int j = 0; j < F; ++j) y_ref_m(i, j) = static_cast<float>(y_ref[i][j]);
+    }
+    run_test(name + ": forward", compare_matrices(y->value, y_ref_m));
+    run_test(name + ": dx",
+             compare_matrices(x->grad, numeric_grad(xg, Rg, f), 1e-3f));
+    run_test(name + ": dgamma",
+             compare_matrices(gamma->grad, numeric_grad(gg, Rg, f), 1e-3f));
+    run_test(name + ": dbeta",
+             compare_matrices(beta->grad, numeric_grad(bg, Rg, f), 1e-3f));
+  }
+
+  std::cout << "\n--- running statistics and folding ---\n";
+  {
+    const int K = 5;
+    Matrix W = random_matrix(K, F, 10);
+    Matrix b = random_matrix(1, F, 11);
+    Matrix gamma = random_matrix(1, F, 12, 0.5f, 1.5f);
+    Matrix beta = random_matrix(1, F, 13);
+    BatchNormState state(F);
+    state.momentum = 1.0f;  // 滑动统计量直接等于本批统计量
+
+    Graph g;
+    auto x = g.make_node(random_matrix(64, K, 14), "x");
+    auto W_n = g.make_node(W, "W");
+    auto b_n = g.make_node(b, "b");
+    auto gamma_n = g.make_node(gamma, "gamma");
+    auto beta_n = g.make_node(beta, "beta");
+    auto h = dense(g, x, W_n, b_n);
+    batch_norm(g, h, gamma_n, beta_n, state, true);
+
+    double mean0 = 0.0, var0 = 0.0;
+    for (int i = 0; i < 64; ++i) mean0 += h->value(i, 0);
+    mean0 /= 64;
+    for (int i = 0; i < 64; ++i) {
+      var0 += (h->value(i, 0) - mean0) * (h->value(i, 0) - mean0);
+    }
+    var0 /= 63;  // 滑动方差使用无偏估计
+    run_test("running stats: mean",
+             std::abs(state.running_mean(0, 0) - mean0) < 1e-4);
+    run_test("running stats: unbiased var",
+             std::abs(state.running_var(0, 0) - var0) < 1e-4);
+
+    auto inference = batch_norm(g, h, gamma_n, beta_n, state, false);
+    Matrix W_fold = W, b_fold = b;
+    fold_batch_norm(W_fold, b_fold, gamma, beta, state);
+    auto folded = dense(g, x, g.make_node(W_fold, "W_fold"),
+                        g.make_node(b_fold, "b_fold"));
+    run_test("fold_batch_norm: matches inference batch_norm",
+             compare_matrices(folded->value, inference->value));
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
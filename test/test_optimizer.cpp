@@ -0,0 +1,232 @@
+/**
+ * @file    test/test_optimizer.cpp
+ * @brief   验证 SGD / Nesterov / Adam / AdamW 的原地更新与 zero_grad。
+ *
+ * @details
+ * 以逐元素的朴素公式（double 精度）为参考连续执行若干步，比较参数值；
+ * 线程池分块并行的结果必须与串行逐位一致；非法超参数应抛出异常。
+ */
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Optimizer.h"
+#include "../src/core/ThreadPool.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_values(const Matrix& m, const std::vector<double>& ref,
+                    double epsilon) {
+  for (int i = 0; i < m.get_rows(); ++i) {
+    for (int j = 0; j < m.get_cols(); ++j) {
+      const double r = ref[static_cast<size_t>(i) * m.get_cols() + j];
+      if (std::abs(m(i, j) - r) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m(i, j) << " != " << r << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool identical(const Matrix& a, const Matrix& b) {
+  for (int i = 0; i < a.get_rows(); ++i) {
+    for (int j = 0; j < a.get_cols(); ++j) {
+      if (a(i, j) != b(i, j)) return false;
+    }
+  }
+  return true;
+}
+
+// 每一步的梯度：固定随机矩阵 + 与参数相关的项，模拟真实训练
+void fill_grad(Node& p, int step) {
+  Matrix g = random_matrix(p.value.get_rows(), p.value.get_cols(), 100 + step);
+  for (int i = 0; i < g.get_rows(); ++i) {
+    for (int j = 0; j < g.get_cols(); ++j) {
+      p.grad(i, j) = g(i, j) + 0.5f * p.value(i, j);
+    }
+  }
+}
+
+// 参考实现的单元素更新：输入 w、g 与状态 (s1, s2)，t 为步数（从 1 开始）
+using RefUpdate =
+    std::function<void(double& w, double g, double& s1, double& s2, int t)>;
+
+struct OptCase {
+  std::string name;
+  std::function<std::unique_ptr<Optimizer>(std::vector<std::shared_ptr<Node>>)>
+      make;
+  RefUpdate ref;
+};
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running optimizer Test Suite ---\n";
+
+  const double lr = 0.01, mu = 0.9, wd = 0.1, b1 = 0.9, b2 = 0.999,
+               eps = 1e-8;
+  const std::vector<OptCase> cases = {
+      {"SGD",
+       [&](auto ps) { return std::make_unique<SGD>(ps, lr); },
+       [&](double& w, double g, double&, double&, int) { w -= lr * g; }},
+      {"SGD momentum + weight decay",
+       [&](auto ps) { return std::make_unique<SGD>(ps, lr, mu, false, wd); },
+       [&](double& w, double g, double& v, double&, int) {
+         v = mu * v + g + wd * w;
+         w -= lr * v;
+       }},
+      {"SGD Nesterov",
+       [&](auto ps) { return std::make_unique<SGD>(ps, lr, mu, true); },
+       [&](double& w, double g, double& v, double&, int) {
+         v = mu * v + g;
+         w -= lr * (g + mu * v);
+       }},
+      {"Adam",
+       [&](auto ps) { return std::make_unique<Adam>(ps, lr); },
+       [&](double& w, double g, double& m, double& v, int t) {
+         m = b1 * m + (1 - b1) * g;
+         v = b2 * v + (1 - b2) * g * g;
+         const double mh = m / (1 - std::pow(b1, t));
+         const double vh = v / (1 - std::pow(b2, t));
+         w -= lr * mh / (std::sqrt(vh) + eps);
+       }},
+      {"AdamW",
+       [&](auto ps) {
+         return std::make_unique<AdamW>(ps, lr, b1, b2, eps, wd);
+       },
+       [&](double& w, double g, double& m, double& v, int t) {
+         w *= 1 - lr * wd;
+         m = b1 * m + (1 - b1) * g;
+         v = b2 * v + (1 - b2) * g * g;
+         const double mh = m / (1 - std::pow(b1, t));
+         const double vh = v / (1 - std::pow(b2, t));
+         w -= lr * mh / (std::sqrt(vh) + eps);
+       }},
+  };
+
+  std::cout << "\n--- Section 1: updates match reference formulas ---\n";
+  const int kSteps = 5;
+  for (const auto& c : cases) {
+    Graph g;
+    // 第二个参数跨越多个并行块
+    auto W = g.make_node(random_matrix(7, 5, 1), "W");
+    auto V = g.make_node(random_matrix(300, 70, 2), "V");
+    auto opt = c.make({W, V});
+
+    std::vector<std::vector<double>> w, s1, s2;
+    for (const auto& p : {W, V}) {
+      const size_t n = static_cast<size_t>(p->value.get_rows()) *
+                       p->value.get_cols();
+      w.emplace_back(p->value.get_data_ptr(), p->value.get_data_ptr() + n);
+      s1.emplace_back(n, 0.0);
+      s2.emplace_back(n, 0.0);
+    }
+    for (int t = 1; t <= kSteps; ++t) {
+      size_t idx = 0;
+      for (const auto& p : {W, V}) {
+        fill_grad(*p, t);
+        const float* gp = p->grad.get_data_ptr();
+        for (size_t k = 0; k < w[idx].size(); ++k) {
+          c.ref(w[idx][k], gp[k], s1[idx][k], s2[idx][k], t);
+        }
+        ++idx;
+      }
+      opt->step();
+    }
+    run_test(c.name + ": W", compare_values(W->value, w[0], 1e-5));
+    run_test(c.name + ": V", compare_values(V->value, w[1], 1e-5));
+    run_test(c.name + ": step count", opt->step_count() == kSteps);
+  }
+
+  std::cout << "\n--- Section 2: parallel step is bitwise identical ---\n";
+  {
+    ThreadPool pool(4);
+    for (const auto& c : cases) {
+      Graph g1, g2;
+      auto A = g1.make_node(random_matrix(300, 70, 3), "A");
+      auto B = g2.make_node(random_matrix(300, 70, 3), "B");
+      auto serial = c.make({A});
+      auto parallel = c.make({B});
+      for (int t = 1; t <= kSteps; ++t) {
+        fill_grad(*A, t);
+        fill_grad(*B, t);
+        serial->step();
+        parallel->step(&pool);
+      }
+      run_test(c.name + ": parallel == serial", identical(A->value, B->value));
+    }
+  }
+
+  std::cout << "\n--- Section 3: zero_grad and in-place update ---\n";
+  {
+    Graph g;
+    auto W = g.make_node(random_matrix(4, 3, 4), "W");
+    const float* before = W->value.get_data_ptr();
+    SGD opt({W}, 0.1f, 0.9f);
+    fill_grad(*W, 1);
+    opt.step();
+    run_test("step updates value in place",
+             W->value.get_data_ptr() == before);
+    opt.zero_grad();
+    run_test("zero_grad clears gradients",
+             compare_values(W->grad, std::vector<double>(12, 0.0), 0.0));
+  }
+
+  std::cout << "\n--- Section 4: invalid configuration ---\n";
+  {
+    Graph g;
+    auto W = g.make_node(random_matrix(2, 2, 5), "W");
+    auto expect_throw = [&](const std::string& name,
+                            const std::function<void()>& f) {
+      try {
+        f();
+        run_test(name, false);
+      } catch (const std::invalid_argument&) {
+        run_test(name, true);
+      }
+    };
+    expect_throw("non-positive learning rate rejected",
+                 [&]() { SGD opt({W}, 0.0f); });
+    expect_throw("momentum >= 1 rejected", [&]() { SGD opt({W}, 0.1f, 1.0f); });
+    expect_throw("Nesterov without momentum rejected",
+                 [&]() { SGD opt({W}, 0.1f, 0.0f, true); });
+    expect_throw("invalid beta rejected",
+                 [&]() { Adam opt({W}, 1e-3f, 1.0f); });
+    expect_throw("duplicate parameter rejected",
+                 [&]() { Adam opt({W, W}); });
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file    test/test_parallel_backward.cpp
+ * @brief   验证线程池并行反向与单线程反向得到相同的梯度。
+ *
+ * @details
+ * 构建一个含多条独立分支、共享输入与共享参数的计算图，分别用
+ * Node::backward() 与 Node::backward(ThreadPool&) 计算梯度并比较。
+ * 同一个节点的使用者按固定顺序累加梯度，结果应与单线程逐位相同。
+ * 重复多次以尽量暴露梯度累加时的数据竞争与顺序差异。
+ */
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/ThreadPool.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-4f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// 返回 {x, W1, W2, b} 的梯度
+std::vector<Matrix> run_graph(ThreadPool* pool) {
+  Graph g;
+  auto x = g.make_node(random_matrix(16, 12, 1), "x");
+  auto W1 = g.make_node(random_matrix(12, 8, 2), "W1");
+  auto W2 = g.make_node(random_matrix(12, 8, 3), "W2");
+  auto b = g.make_node(random_matrix(1, 8, 4), "b");
+
+  // 四条独立分支，全部汇入同一个 sum
+  auto h1 = sigmoid(g, add_with_broadcast(g, mul(g, x, W1), b));
+  auto h2 = relu(g, add_with_broadcast(g, mul(g, x, W2), b));
+  auto h3 = element_mul(g, h1, h1);
+  auto h4 = sub(g, mul(g, x, W1), h2);
+  auto loss = sum(g, add(g, add(g, h1, h2), add(g, h3, h4)));
+
+  if (pool != nullptr) {
+    loss->backward(*pool);
+  } else {
+    loss->backward();
+  }
+  return {x->grad, W1->grad, W2->grad, b->grad};
+}
+
+bool bitwise_equal(const Matrix& m1, const Matrix& m2) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  return std::memcmp(m1.get_data_ptr(), m2.get_data_ptr(),
+                     sizeof(float) * m1.numel()) == 0;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running Parallel Backward Test Suite ---\n";
+  const std::vector<Matrix> expected = run_graph(nullptr);
+  const char* names[] = {"x", "W1", "W2", "b"};
+
+  ThreadPool pool(4);
+  bool stable = true;
+  bool bitwise = true;
+  for (int round = 0; round < 50 && stable; ++round) {
+    std::vector<Matrix> got = run_graph(&pool);
+    for (size_t i = 0; i < got.size(); ++i) {
+      if (!compare_matrices(expected[i], got[i])) {
+        std::cerr << "  round " << round << ", grad of " << names[i] << "\n";
+        stable = false;
+      }
+      bitwise = bitwise && bitwise_equal(expected[i], got[i]);
+    }
+  }
+  run_test("Parallel backward matches serial backward (50 rounds)", stable);
+  run_test("Parallel backward is bitwise identical to serial backward", bitwise);
+
+  {
+    std::atomic<int> counter{0};
+    pool.submit([&]() {
+      parallel_invoke([&]() { counter += 1; }, [&]() { counter += 2; });
+      counter += 4;
+    });
+    pool.help_until([&]() { return counter.load() == 7; });
+    run_test("parallel_invoke inside a pool task", counter.load() == 7);
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file    test/test_parameter_store.cpp
+ * @brief   验证 ParameterStore 的打包、视图绑定与基于平坦缓冲区的优化器。
+ *
+ * @details
+ * 打包后节点的 value / grad 必须是缓冲区上对齐的视图且数值不变；
+ * 算子的反向直接写进平坦梯度；基于平坦缓冲区的优化器结果与逐参数
+ * 更新逐位一致；参数被整体赋值而脱离缓冲区时 step() 应报错。
+ */
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Optimizer.h"
+#include "../src/core/ParameterStore.h"
+#include "../src/core/ThreadPool.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool identical(const Matrix& a, const Matrix& b) {
+  if (a.get_rows() != b.get_rows() || a.get_cols() != b.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < a.get_rows(); ++i) {
+    for (int j = 0; j < a.get_cols(); ++j) {
+      if (a(i, j) != b(i, j)) return false;
+    }
+  }
+  return true;
+}
+
+struct Model {
+  std::shared_ptr<Node> W1, b1, W2, b2;
+};
+
+Model make_model(Graph& g) {
+  return {g.make_node(random_matrix(13, 9, 1), "W1"),
+          g.make_node(random_matrix(1, 9, 2), "b1"),
+          g.make_node(random_matrix(9, 5, 3), "W2"),
+          g.make_node(random_matrix(1, 5, 4), "b2")};
+}
+
+void forward_backward(Graph& g, const Model& m, unsigned seed) {
+  auto x = g.make_node(random_matrix(6, 13, seed), "x");
+  auto h = dense(g, x, m.W1, m.b1, Activation::Sigmoid);
+  auto y = dense(g, h, m.W2, m.b2);
+  sum(g, element_mul(g, y, y))->backward();
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running ParameterStore Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: packing ---\n";
+  {
+    Graph g;
+    Model m = make_model(g);
+    const std::vector<Matrix> before = {m.W1->value, m.b1->value, m.W2->value,
+                                        m.b2->value};
+    m.W1->grad = random_matrix(13, 9, 5);
+    const Matrix grad_before = m.W1->grad;
+    ParameterStore store({m.W1, m.b1, m.W2, m.b2});
+
+    const std::vector<std::shared_ptr<Node>> ps = {m.W1, m.b1, m.W2, m.b2};
+    bool values_kept = true, aligned = true;
+    for (size_t i = 0; i < ps.size(); ++i) {
+      values_kept = values_kept && identical(ps[i]->value, before[i]);
+      aligned = aligned && store.offset(i) % 16 == 0 &&
+                reinterpret_cast<uintptr_t>(ps[i]->value.get_data_ptr()) %
+                        64 == 0;
+    }
+    run_test("values preserved", values_kept);
+    run_test("gradients preserved", identical(m.W1->grad, grad_before));
+    run_test("every parameter starts 64-byte aligned", aligned);
+    run_test("nodes view the flat buffers",
+             store.is_bound() &&
+                 m.W2->value.get_data_ptr() ==
+                     store.values().data() + store.offset(2) &&
+                 m.b2->grad.get_data_ptr() ==
+                     store.grads().data() + store.offset(3));
+    run_test("size covers padded parameters",
+             store.size() == 128 + 16 + 48 + 16);
+
+    store.zero_grad();
+    bool all_zero = true;
+    for (float v : store.grads()) all_zero = all_zero && v == 0.0f;
+    run_test("zero_grad clears the flat buffer", all_zero);
+  }
+
+  std::cout << "\n--- Section 2: backward writes into the flat gradient ---\n";
+  {
+    Graph g1, g2;
+    Model packed = make_model(g1);
+    Model plain = make_model(g2);
+    ParameterStore store({packed.W1, packed.b1, packed.W2, packed.b2});
+    forward_backward(g1, packed, 7);
+    forward_backward(g2, plain, 7);
+    run_test("gradients match unpacked model",
+             identical(packed.W1->grad, plain.W1->grad) &&
+                 identical(packed.b1->grad, plain.b1->grad) &&
+                 identical(packed.W2->grad, plain.W2->grad) &&
+                 identical(packed.b2->grad, plain.b2->grad));
+    run_test("backward keeps nodes bound", store.is_bound());
+  }
+
+  std::cout << "\n--- Section 3: optimizer over the flat buffer ---\n";
+  {
+    ThreadPool pool(4);
+    Graph g1, g2;
+    Model packed = make_model(g1);
+    Model plain = make_model(g2);
+    ParameterStore store({packed.W1, packed.b1, packed.W2, packed.b2});
+    Adam flat(store, 0.01f);
+    Adam separate({plain.W1, plain.b1, plain.W2, plain.b2}, 0.01f);
+    for (int step = 0; step < 4; ++step) {
+      flat.zero_grad();
+      separate.zero_grad();
+      forward_backward(g1, packed, 20 + step);
+      forward_backward(g2, plain, 20 + step);
+      flat.step(step % 2 == 0 ? &pool : nullptr);
+      separate.step();
+    }
+    run_test("flat Adam matches per-parameter Adam",
+             identical(packed.W1->value, plain.W1->value) &&
+                 identical(packed.b1->value, plain.b1->value) &&
+                 identical(packed.W2->value, plain.W2->value) &&
+                 identical(packed.b2->value, plain.b2->value));
+    bool padding_zero = true;
+    for (size_t i = 13 * 9; i < store.offset(1); ++i) {
+      padding_zero = padding_zero && store.values()[i] == 0.0f;
+    }
+    run_test("padding stays zero", padding_zero);
+
+    packed.W1->value = random_matrix(13, 9, 9);
+    run_test("reassigned parameter is detected", !store.is_bound());
+    try {
+      flat.step();
+      run_test("step rejects detached parameter", false);
+    } catch (const std::runtime_error&) {
+      run_test("step rejects detached parameter", true);
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file    test/test_pool2d.cpp
+ * @brief   验证 max_pool2d / avg_pool2d 的前向与反向。
+ *
+ * @details
+ * 以逐窗口比较的朴素实现为参考，覆盖 2x2 步长 2 快速路径（含奇数边长）
+ * 与通用窗口路径，并检查最大池化按 argmax 散射的梯度。
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-5f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// 朴素参考：返回 {max 输出, avg 输出, max 的 dx, avg 的 dx}
+std::vector<Matrix> reference_pool(const Matrix& x, const Matrix& dy,
+                                   const Pool2dShape& s) {
+  const int N = x.get_rows(), C = s.channels, H = s.height, W = s.width;
+  const int K = s.kernel_size, OH = s.out_height(), OW = s.out_width();
+  Matrix max_out(N, C * OH * OW), avg_out(N, C * OH * OW);
+  Matrix max_dx(N, C * H * W), avg_dx(N, C * H * W);
+  for (int n = 0; n < N; ++n) {
+    for (int c = 0; c < C; ++c) {
+      for (int oy = 0; oy < OH; ++oy) {
+        for (int ox = 0; ox < OW; ++ox) {
+          const int o = (c * OH + oy) * OW + ox;
+          int best = -1;
+          float sum = 0.0f;
+          for (int ky = 0; ky < K; ++ky) {
+            for (int kx = 0; kx < K; ++kx) {
+              const int i = (c * H + oy * s.stride + ky) * W +
+                            ox * s.stride + kx;
+              sum += x(n, i);
+              if (best < 0 || x(n, i) > x(n, best)) best = i;
+              avg_dx(n, i) += dy(n, o) / (K * K);
+            }
+          }
+          max_out(n, o) = x(n, best);
+          avg_out(n, o) = sum / (K * K);
+          max_dx(n, best) += dy(n, o);
+        }
+      }
+    }
+  }
+  return {max_out, avg_out, max_dx, avg_dx};
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running pool2d Test Suite ---\n";
+
+  struct Case {
+    std::string name;
+    Pool2dShape shape;
+  };
+  const std::vector<Case> cases = {
+      {"2x2 s2 even", {3, 8, 6, 2, 2}},
+      {"2x2 s2 odd", {2, 7, 9, 2, 2}},
+      {"3x3 s2", {2, 9, 7, 3, 2}},
+      {"3x3 s1", {1, 6, 6, 3, 1}},
+  };
+
+  unsigned seed = 1;
+  for (const auto& tc : cases) {
+    const Pool2dShape& s = tc.shape;
+    const int N = 4;
+    const int out_cols = s.channels * s.out_height() * s.out_width();
+    Matrix x = random_matrix(N, s.channels * s.height * s.width, seed++);
+    Matrix dy = random_matrix(N, out_cols, seed++);
+    std::vector<Matrix> ref = reference_pool(x, dy, s);
+
+    Matrix out(N, out_cols);
+    std::vector<int32_t> argmax;
+    max_pool2d_forward_kernel(x, s, out, argmax);
+    run_test(tc.name + ": max forward", compare_matrices(out, ref[0]));
+    Matrix dx(N, x.get_cols());
+    max_pool2d_backward_kernel(dy, argmax, dx);
+    run_test(tc.name + ": max backward", compare_matrices(dx, ref[2]));
+
+    avg_pool2d_forward_kernel(x, s, out);
+    run_test(tc.name + ": avg forward", compare_matrices(out, ref[1]));
+    dx.clear();
+    avg_pool2d_backward_kernel(dy, s, dx);
+    run_test(tc.name + ": avg backward", compare_matrices(dx, ref[3]));
+  }
+
+  std::cout << "\n--- pooling ops in a graph ---\n";
+  {
+    // 窗口内全部相等时梯度只流向第一个元素
+    Pool2dShape s{1, 2, 2, 2, 2};
+    Graph g;
+    auto x = g.make_node(Matrix(1, 4, 0.5f), "x");
+    auto loss = sum(g, max_pool2d(g, x, s));
+    loss->backward();
+    run_test("max_pool2d: ties pick first",
+             x->grad(0, 0) == 1.0f && x->grad(0, 1) == 0.0f &&
+                 x->grad(0, 2) == 0.0f && x->grad(0, 3) == 0.0f);
+
+    Graph g2;
+    auto x2 = g2.make_node(random_matrix(2, 2 * 16, 7), "x");
+    auto y2 = avg_pool2d(g2, x2, Pool2dShape{2, 4, 4, 2, 2});
+    run_test("avg_pool2d: output shape",
+             y2->value.get_rows() == 2 && y2->value.get_cols() == 2 * 4);
+    sum(g2, y2)->backward();
+    run_test("avg_pool2d: uniform grad",
+             compare_matrices(x2->grad, Matrix(2, 32, 0.25f)));
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
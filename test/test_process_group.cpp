@@ -0,0 +1,243 @@
+/**
+ * @file    test/test_process_group.cpp
+ * @brief   验证多进程 all-reduce 在共享内存与套接字两种传输下的正确性。
+ *
+ * @details
+ * 每个用例 fork 出 4 个子进程组成一个进程组，子进程检查 all_reduce 的结果
+ * 并以退出码报告；父进程汇总。覆盖长度小于进程数、超过共享内存容量（分块）
+ * 的数据，以及所有进程结果逐位相同。启动器用例通过 launch_local_ranks
+ * 重新启动本测试程序，子进程检查收到的参数（包括 --config 的路径）。
+ */
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/ProcessGroup.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+// 第 rank 个进程的第 i 个元素；和可以在每个进程里独立算出
+float value_of(int rank, size_t i) {
+  return static_cast<float>((rank + 1) * 0.5 + std::sin(static_cast<double>(i)));
+}
+
+// 在 world_size 个子进程中运行 body，全部以 0 退出时返回 true
+bool run_ranks(int world_size, const std::function<bool(ProcessGroup&)>& body,
+               ProcessGroupOptions options) {
+  static int counter = 0;
+  options.world_size = world_size;
+  options.job_id = "test-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+  options.timeout = std::chrono::milliseconds(10000);
+  std::cout.flush();
+  std::vector<pid_t> children;
+  for (int rank = 0; rank < world_size; ++rank) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      int code = 1;
+      try {
+        options.rank = rank;
+        auto group = ProcessGroup::create(options);
+        code = body(*group) ? 0 : 1;
+      } catch (const std::exception& e) {
+        std::cerr << "  [Error] rank " << rank << ": " << e.what() << "\n";
+      }
+      _exit(code);
+    }
+    children.push_back(pid);
+  }
+  bool ok = true;
+  for (pid_t pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+  return ok;
+}
+
+// 每个进程填入自己的数据，检查 all_reduce 后等于各进程之和
+bool check_sum(ProcessGroup& group, size_t n) {
+  std::vector<float> data(n);
+  for (size_t i = 0; i < n; ++i) data[i] = value_of(group.rank(), i);
+  group.all_reduce(data);
+  for (size_t i = 0; i < n; ++i) {
+    float expected = 0.0f;
+    for (int r = 0; r < group.world_size(); ++r) expected += value_of(r, i);
+    if (std::abs(data[i] - expected) > 1e-5f) {
+      std::cerr << "  [Error] rank " << group.rank() << " element " << i << ": "
+                << data[i] << " != " << expected << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+// 用第二次 all_reduce 把 0 号进程的结果广播出去（其他进程贡献 0，加法精确），
+// 每个进程与自己的结果逐位比较
+bool check_identical(ProcessGroup& group, size_t n) {
+  std::vector<float> data(n);
+  for (size_t i = 0; i < n; ++i) data[i] = value_of(group.rank(), i) / 3.0f;
+  group.all_reduce(data);
+  std::vector<float> bits(n);
+  for (size_t i = 0; i < n; ++i) {
+    bits[i] = group.rank() == 0 ? data[i] : 0.0f;
+  }
+  group.all_reduce(bits);
+  return std::memcmp(bits.data(), data.data(), n * sizeof(float)) == 0;
+}
+
+// 启动器用例中子进程应收到的参数（不含末尾的 --rank 等）
+const std::vector<std::string> kLaunchedArgs = {"--launcher-child", "--config",
+                                                "launcher_test.conf", "--epochs",
+                                                "1"};
+
+// launch_local_ranks 启动的子进程：检查参数原样转发、配置文件可读，
+// 再用转发来的 rank 等组成进程组做一次 all_reduce
+int run_launched_child(int argc, char** argv) {
+  const std::vector<std::string> args(argv + 1, argv + argc);
+  if (args.size() != kLaunchedArgs.size() + 6 ||
+      !std::equal(kLaunchedArgs.begin(), kLaunchedArgs.end(), args.begin())) {
+    std::cerr << "  [Error] unexpected forwarded arguments\n";
+    return 1;
+  }
+  std::ifstream config(args[2]);
+  std::string line;
+  if (!std::getline(config, line) || line != "epochs = 3") {
+    std::cerr << "  [Error] cannot read config '" << args[2] << "'\n";
+    return 1;
+  }
+  try {
+    const LaunchArgs parsed = parse_launch_args(argc, argv);
+    ProcessGroupOptions options;
+    for (size_t i = kLaunchedArgs.size(); i + 1 < args.size(); i += 2) {
+      if (args[i] == "--rank") options.rank = std::stoi(args[i + 1]);
+      if (args[i] == "--world-size") options.world_size = std::stoi(args[i + 1]);
+      if (args[i] == "--job-id") options.job_id = args[i + 1];
+    }
+    options.timeout = std::chrono::milliseconds(10000);
+    auto group = ProcessGroup::create(options);
+    return parsed.nproc == 1 && check_sum(*group, 100) ? 0 : 1;
+  } catch (const std::exception& e) {
+    std::cerr << "  [Error] " << e.what() << "\n";
+    return 1;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1 && std::string(argv[1]) == kLaunchedArgs[0]) {
+    return run_launched_child(argc, argv);
+  }
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running process group Test Suite ---\n";
+
+  for (Transport transport : {Transport::SharedMemory, Transport::Socket}) {
+    const std::string label =
+        transport == Transport::SharedMemory ? "shared memory" : "socket";
+    std::cout << "\n--- Section: " << label << " transport, 4 ranks ---\n";
+    ProcessGroupOptions options;
+    options.transport = transport;
+    options.capacity = 100;  // 让较长的数据在共享内存中分块
+
+    run_test(label + ": transport is the requested one",
+             run_ranks(4, [transport](ProcessGroup& g) {
+               return g.transport() == transport;
+             }, options));
+    run_test(label + ": all_reduce of 1000 elements",
+             run_ranks(4, [](ProcessGroup& g) { return check_sum(g, 1000); },
+                       options));
+    run_test(label + ": fewer elements than ranks",
+             run_ranks(4, [](ProcessGroup& g) { return check_sum(g, 3); },
+                       options));
+    run_test(label + ": empty and repeated calls",
+             run_ranks(4, [](ProcessGroup& g) {
+               bool ok = check_sum(g, 0);
+               for (int k = 0; k < 5; ++k) ok = check_sum(g, 37 + k) && ok;
+               g.barrier();
+               return ok;
+             }, options));
+    run_test(label + ": results bitwise identical across ranks",
+             run_ranks(4, [](ProcessGroup& g) { return check_identical(g, 777); },
+                       options));
+    run_test(label + ": two ranks",
+             run_ranks(2, [](ProcessGroup& g) { return check_sum(g, 250); },
+                       options));
+  }
+
+  std::cout << "\n--- Section: single process and errors ---\n";
+  {
+    ProcessGroupOptions options;
+    auto group = ProcessGroup::create(options);
+    std::vector<float> data{1.0f, 2.0f};
+    group->all_reduce(data);
+    group->barrier();
+    run_test("world size 1 is a no-op",
+             group->world_size() == 1 && data[0] == 1.0f && data[1] == 2.0f);
+
+    options.world_size = 2;
+    options.rank = 2;
+    try {
+      ProcessGroup::create(options);
+      run_test("rank outside world rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("rank outside world rejected", true);
+    }
+
+    // 另一个进程永远不会出现：连接应在超时后失败而不是永远等待
+    options.rank = 0;
+    options.transport = Transport::Socket;
+    options.job_id = "test-" + std::to_string(getpid()) + "-lonely";
+    options.timeout = std::chrono::milliseconds(200);
+    try {
+      ProcessGroup::create(options);
+      run_test("missing peer times out", false);
+    } catch (const std::runtime_error&) {
+      run_test("missing peer times out", true);
+    }
+  }
+
+  std::cout << "\n--- Section: launcher ---\n";
+  {
+    std::ofstream(kLaunchedArgs[2]) << "epochs = 3\n";
+    // 与 train --nproc 2 --config FILE --epochs 1 相同的形式
+    std::vector<const char*> argv{"test_process_group", "--launcher-child",
+                                  "--nproc", "2"};
+    for (size_t i = 1; i < kLaunchedArgs.size(); ++i) {
+      argv.push_back(kLaunchedArgs[i].c_str());
+    }
+    const LaunchArgs launch =
+        parse_launch_args(static_cast<int>(argv.size()), argv.data());
+    run_test("--nproc removed, option values kept",
+             launch.nproc == 2 && launch.forwarded == kLaunchedArgs);
+    std::cout.flush();
+    run_test("launched ranks receive --config and its path",
+             launch_local_ranks(launch.forwarded, launch.nproc) == 0);
+    std::remove(kLaunchedArgs[2].c_str());
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
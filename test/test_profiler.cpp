@@ -0,0 +1,169 @@
+/**
+ * @file    test/test_profiler.cpp
+ * @brief   验证性能分析器的工作量归属与并发下的 reset()。
+ *
+ * @details
+ * parallel_invoke 交给线程池的任务在另一个线程上执行，该线程可能没有活动范围，
+ * 也可能正处在别的算子的范围里（在 help_until 中帮忙）。任务报告的 FLOP
+ * 与分配都应计入提交它的范围。reset() 与其他线程的记录并发时不能出错。
+ * 导出的 Chrome trace 中，名字里的引号、反斜杠与控制字符都被转义。
+ */
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/core/Matrix.h"
+#include "../src/core/Profiler.h"
+#include "../src/core/ThreadPool.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+void spin_until(const std::atomic<bool>& flag) {
+  while (!flag.load()) std::this_thread::yield();
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running profiler Test Suite ---\n";
+  Profiler& profiler = Profiler::instance();
+  profiler.set_enabled(true);
+
+  std::cout << "\n--- Section 1: work on pool threads ---\n";
+  {
+    profiler.reset();
+    ThreadPool pool(2);
+    std::atomic<bool> bystander_ready{false};
+    std::atomic<bool> outer_done{false};
+    std::atomic<bool> a_started{false};
+    std::thread::id a_thread;
+    std::thread::id b_thread;
+
+    // 一个工作线程停在别的范围里帮忙执行任务，parallel_invoke 的 a 只能落到它上面
+    pool.submit([&] {
+      ProfileScope scope("bystander");
+      bystander_ready = true;
+      ThreadPool::current()->help_until([&] { return outer_done.load(); });
+    });
+    spin_until(bystander_ready);
+    pool.submit([&] {
+      {
+        ProfileScope scope("outer");
+        parallel_invoke(
+            [&] {
+              a_thread = std::this_thread::get_id();
+              a_started = true;
+              Matrix scratch(16, 16);
+              ProfileScope::add_counts(100.0, 10.0, 1.0);
+            },
+            [&] {
+              b_thread = std::this_thread::get_id();
+              spin_until(a_started);
+              ProfileScope::add_counts(100.0, 10.0, 1.0);
+            });
+      }
+      outer_done = true;
+    });
+    spin_until(outer_done);
+    // 等 bystander 结束并记录
+    std::atomic<bool> drained{false};
+    pool.submit([&] { drained = true; });
+    spin_until(drained);
+    while (profiler.stats().count("bystander") == 0) std::this_thread::yield();
+
+    const auto stats = profiler.stats();
+    const Profiler::OpStats& outer = stats.at("outer");
+    const Profiler::OpStats& bystander = stats.at("bystander");
+    run_test("task ran on another thread", a_thread != b_thread);
+    run_test("FLOPs and bytes charged to the submitting scope",
+             outer.flops == 200.0 && outer.bytes_read == 20.0 &&
+                 outer.bytes_written == 2.0);
+    run_test("allocation on the worker charged to the submitting scope",
+             outer.allocs >= 1 && outer.alloc_bytes >= 16 * 16 * sizeof(float));
+    run_test("scope the worker was helping from is not charged",
+             bystander.flops == 0.0 && bystander.allocs == 0);
+  }
+  {
+    // 不在线程池中时顺序执行，行为不变
+    profiler.reset();
+    {
+      ProfileScope scope("sequential");
+      parallel_invoke([] { ProfileScope::add_counts(1.0, 0.0, 0.0); },
+                      [] { ProfileScope::add_counts(1.0, 0.0, 0.0); });
+    }
+    run_test("sequential fallback", profiler.stats().at("sequential").flops == 2.0);
+  }
+
+  std::cout << "\n--- Section 2: reset while recording ---\n";
+  {
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+      threads.emplace_back([&] {
+        while (!stop.load()) {
+          ProfileScope scope("busy");
+          ProfileScope::add_counts(1.0, 0.0, 0.0);
+        }
+      });
+    }
+    for (int i = 0; i < 200; ++i) {
+      profiler.reset();
+      std::this_thread::yield();
+    }
+    stop = true;
+    for (auto& t : threads) t.join();
+    profiler.reset();
+    {
+      ProfileScope scope("after");
+    }
+    const auto stats = profiler.stats();
+    run_test("reset during recording leaves consistent stats",
+             stats.count("busy") == 0 && stats.at("after").calls == 1);
+  }
+
+  std::cout << "\n--- Section 3: chrome trace export ---\n";
+  {
+    profiler.reset();
+    {
+      ProfileScope scope(std::string("layer \"1\"\\\n\t\x01"), ".forward");
+      ProfileScope::add_counts(8.0, 4.0, 4.0);
+    }
+    const std::string path = "test_profiler_trace.json";
+    profiler.export_chrome_trace(path);
+    std::ifstream in(path);
+    const std::string json((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+    // 文件中唯一允许的控制字符是事件之间的换行
+    bool raw_control = false;
+    for (char c : json) {
+      raw_control = raw_control || (static_cast<unsigned char>(c) < 0x20 && c != '\n');
+    }
+    run_test("no raw control characters in the trace", !raw_control);
+    run_test("name escaped as a JSON string",
+             json.find("\"name\":\"layer \\\"1\\\"\\\\\\u000a\\u0009\\u0001.forward\"") !=
+                 std::string::npos);
+  }
+  profiler.set_enabled(false);
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
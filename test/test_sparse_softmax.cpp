@@ -0,0 +1,183 @@
+/**
+ * @file    test/test_sparse_softmax.cpp
+ * @brief   验证 sparse_softmax_cross_entropy_loss 的损失与梯度，以及对错误标签的检查。
+ *
+ * @details
+ * 与 softmax_cross_entropy_loss(one_hot_encode(...)) 逐元素比较；
+ * 大幅值的 logits 与 double 精度的 log-sum-exp 参考比较数值稳定性；
+ * 上游梯度不为 1 时（损失再乘以常数）梯度相应缩放；错误的标签被拒绝。
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/Graph.h"
+#include "../src/core/Matrix.h"
+#include "../src/ops/ops.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+Matrix random_matrix(int rows, int cols, unsigned seed, float scale = 1.0f) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> distr(-scale, scale);
+  Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) = distr(gen);
+  }
+  return m;
+}
+
+bool compare_matrices(const Matrix& m1, const Matrix& m2,
+                      float epsilon = 1e-6f) {
+  if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols()) {
+    return false;
+  }
+  for (int i = 0; i < m1.get_rows(); ++i) {
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      if (std::abs(m1(i, j) - m2(i, j)) > epsilon) {
+        std::cerr << "  [Error] Element mismatch at (" << i << "," << j
+                  << "): " << m1(i, j) << " != " << m2(i, j) << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<int> make_labels(int rows, int classes) {
+  std::vector<int> labels(rows);
+  for (int i = 0; i < rows; ++i) labels[i] = (i * 7 + 3) % classes;
+  return labels;
+}
+
+struct LossRun {
+  float loss = 0.0f;
+  Matrix grad{0, 0};
+};
+
+// scale 不为 1 时对 scale * loss 求导，检查上游梯度的传递
+LossRun run(const Matrix& logits_val, const std::vector<int>& labels, bool sparse,
+            float scale = 1.0f) {
+  Graph g;
+  auto logits = g.make_node(logits_val, "logits");
+  std::shared_ptr<Node> loss;
+  if (sparse) {
+    loss = sparse_softmax_cross_entropy_loss(g, logits, labels);
+  } else {
+    Matrix y(static_cast<int>(labels.size()), 1);
+    for (size_t i = 0; i < labels.size(); ++i) y(i, 0) = static_cast<float>(labels[i]);
+    auto target = g.make_node(one_hot_encode(y, logits_val.get_cols()), "target");
+    loss = softmax_cross_entropy_loss(g, logits, target);
+  }
+  auto out = element_mul(g, loss, g.make_node(Matrix(1, 1, scale), "scale"));
+  sum(g, out)->backward();
+  return {loss->value(0, 0), logits->grad};
+}
+
+template <typename E, typename F>
+bool throws(F&& f) {
+  try {
+    f();
+  } catch (const E&) {
+    return true;
+  }
+  return false;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running sparse softmax cross-entropy Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: against the one-hot loss ---\n";
+  for (int classes : {10, 3, 17}) {
+    const int rows = 23;
+    const Matrix logits = random_matrix(rows, classes, classes, 3.0f);
+    const std::vector<int> labels = make_labels(rows, classes);
+    const std::string name = std::to_string(classes) + " classes";
+    const LossRun sparse = run(logits, labels, true);
+    const LossRun dense = run(logits, labels, false);
+    run_test(name + ": loss", std::abs(sparse.loss - dense.loss) < 1e-5f);
+    run_test(name + ": gradient", compare_matrices(sparse.grad, dense.grad));
+  }
+  {
+    const Matrix logits = random_matrix(8, 10, 1);
+    const std::vector<int> labels = make_labels(8, 10);
+    // softmax_cross_entropy_loss 的反向不乘上游梯度，这里以 1 为上游求参考再缩放
+    const LossRun sparse = run(logits, labels, true, 2.5f);
+    const LossRun dense = run(logits, labels, false);
+    run_test("upstream gradient scales the result",
+             compare_matrices(sparse.grad, dense.grad * 2.5f));
+  }
+
+  std::cout << "\n--- Section 2: numerical stability ---\n";
+  {
+    // exp 直接计算会溢出的 logits
+    const int rows = 6, classes = 5;
+    Matrix logits = random_matrix(rows, classes, 9, 1.0f);
+    for (int i = 0; i < rows; ++i) {
+      for (int j = 0; j < classes; ++j) logits(i, j) = logits(i, j) * 50.0f + 200.0f;
+    }
+    const std::vector<int> labels = make_labels(rows, classes);
+    const LossRun sparse = run(logits, labels, true);
+    double expected = 0.0;
+    Matrix expected_grad(rows, classes);
+    for (int i = 0; i < rows; ++i) {
+      double max_logit = logits(i, 0);
+      for (int j = 1; j < classes; ++j) max_logit = std::max<double>(max_logit, logits(i, j));
+      double sum_exp = 0.0;
+      for (int j = 0; j < classes; ++j) sum_exp += std::exp(logits(i, j) - max_logit);
+      expected += std::log(sum_exp) - (logits(i, labels[i]) - max_logit);
+      for (int j = 0; j < classes; ++j) {
+        const double p = std::exp(logits(i, j) - max_logit) / sum_exp;
+        expected_grad(i, j) =
+            static_cast<float>((p - (j == labels[i] ? 1.0 : 0.0)) / rows);
+      }
+    }
+    expected /= rows;
+    run_test("large logits give a finite, exact loss",
+             std::isfinite(sparse.loss) &&
+                 std::abs(sparse.loss - expected) < 1e-4 * std::max(1.0, expected));
+    run_test("large logits give the exact gradient",
+             compare_matrices(sparse.grad, expected_grad, 1e-5f));
+  }
+
+  std::cout << "\n--- Section 3: invalid labels ---\n";
+  {
+    const Matrix logits = random_matrix(4, 3, 2);
+    Graph g;
+    auto node = g.make_node(logits, "logits");
+    run_test("label >= classes rejected", throws<std::out_of_range>([&] {
+               sparse_softmax_cross_entropy_loss(g, node, {0, 1, 3, 2});
+             }));
+    run_test("negative label rejected", throws<std::out_of_range>([&] {
+               sparse_softmax_cross_entropy_loss(g, node, {0, -1, 1, 2});
+             }));
+    run_test("fewer labels than rows rejected", throws<std::invalid_argument>([&] {
+               sparse_softmax_cross_entropy_loss(g, node, {0, 1, 2});
+             }));
+    run_test("more labels than rows rejected", throws<std::invalid_argument>([&] {
+               sparse_softmax_cross_entropy_loss(g, node, {0, 1, 2, 0, 1});
+             }));
+    run_test("rejected calls add no consumer", node->consumers() == 0);
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file    test/test_sweep.cpp
+ * @brief   验证超参数搜索：各档轮数、successive halving 的淘汰、线程预算与失败的试验。
+ */
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/Matrix.h"
+#include "../src/core/Sweep.h"
+#include "../src/core/Trainer.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+struct Data {
+  Matrix X{240, 12};
+  std::vector<int> y;
+  Data() {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+    for (int i = 0; i < X.get_rows(); ++i) {
+      for (int j = 0; j < X.get_cols(); ++j) X(i, j) = distr(gen);
+      y.push_back(i % 4);
+      X(i, i % 4) += 3.0f;
+    }
+  }
+};
+
+TrainerConfig small_config(float lr) {
+  TrainerConfig c;
+  c.layers = {12, 16, 4};
+  c.batch_size = 16;
+  c.learning_rate = lr;
+  return c;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running sweep Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: rungs ---\n";
+  {
+    SweepOptions o;
+    o.min_epochs = 1;
+    o.max_epochs = 10;
+    o.eta = 3;
+    run_test("1, 3, 9, then max", SweepRunner::rungs(o) == std::vector<int>{1, 3, 9, 10});
+    o.max_epochs = 9;
+    run_test("max reached exactly", SweepRunner::rungs(o) == std::vector<int>{1, 3, 9});
+    o.eta = 1;
+    run_test("eta 1 trains everything to max", SweepRunner::rungs(o) == std::vector<int>{9});
+  }
+
+  const Data data;
+
+  std::cout << "\n--- Section 2: successive halving ---\n";
+  {
+    SweepOptions o;
+    o.thread_budget = 2;
+    o.min_epochs = 1;
+    o.max_epochs = 4;
+    o.eta = 2;
+    SweepRunner runner(data.X, data.y, data.X, data.y, o);
+    // 学习率过小的试验应当先被淘汰
+    const std::vector<float> lrs{1e-4f, 0.1f, 1e-5f, 0.2f, 1e-4f, 0.05f};
+    for (float lr : lrs) runner.add(small_config(lr));
+    TrainerConfig threaded = small_config(0.1f);
+    threaded.threads = 2;
+    runner.add(threaded);
+    int reports = 0;
+    const auto results = runner.run([&](const TrialResult&) { reports++; });
+
+    // 7 -> 4 -> 2，各档分别在第 1、2、4 轮
+    int finished = 0;
+    int stopped = 0;
+    for (const TrialResult& r : results) {
+      if (r.stopped) stopped++;
+      else if (r.epochs == 4) finished++;
+    }
+    run_test("a report per trial per rung", reports == 7 + 4 + 2);
+    run_test("half survive each rung", finished == 2 && stopped == 5);
+    run_test("survivors ranked first",
+             !results[0].stopped && !results[1].stopped &&
+                 results[0].accuracy >= results[1].accuracy);
+    bool small_lr_stopped = true;
+    for (const TrialResult& r : results) {
+      if (r.config.learning_rate < 1e-3f) small_lr_stopped = small_lr_stopped && r.stopped;
+    }
+    run_test("losing trials terminated early", small_lr_stopped);
+
+    // 分档训练与单独训练到同样轮数的结果一致
+    TrainerConfig alone = results[0].config;
+    Trainer trainer(alone);
+    trainer.fit(data.X, data.y);
+    run_test("survivor matches a standalone run",
+             trainer.evaluate(data.X, data.y).accuracy() == results[0].accuracy);
+  }
+
+  std::cout << "\n--- Section 3: errors ---\n";
+  {
+    SweepOptions o;
+    o.thread_budget = 2;
+    o.max_epochs = 2;
+    SweepRunner runner(data.X, data.y, data.X, data.y, o);
+    TrainerConfig greedy = small_config(0.1f);
+    greedy.threads = 3;
+    try {
+      runner.add(greedy);
+      run_test("trial larger than the budget rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("trial larger than the budget rejected", true);
+    }
+    runner.add(small_config(0.1f));
+    TrainerConfig broken = small_config(0.1f);
+    broken.layers = {5, 4};  // 与数据的特征数不符
+    runner.add(broken);
+    const auto results = runner.run();
+    run_test("failed trial recorded and ranked last",
+             results.size() == 2 && results[0].error.empty() &&
+                 results[0].epochs == 2 && !results[1].error.empty());
+
+    o.thread_budget = 0;
+    try {
+      SweepRunner bad(data.X, data.y, data.X, data.y, o);
+      run_test("empty budget rejected", false);
+    } catch (const std::invalid_argument&) {
+      run_test("empty budget rejected", true);
+    }
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
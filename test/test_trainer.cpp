@@ -0,0 +1,226 @@
+/**
+ * @file    test/test_trainer.cpp
+ * @brief   验证可配置训练引擎：配置解析、不同优化器与并行方式的训练及统计。
+ */
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/core/Features.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Trainer.h"
+
+void print_test_result(const std::string& test_name, bool passed) {
+  std::cout << "[" << (passed ? "PASS" : "\x1B[31mFAIL\x1B[0m") << "] "
+            << test_name << std::endl;
+}
+
+// 类别由第 y 个特征加上偏移决定，线性可分
+struct Data {
+  Matrix X{240, 12};
+  std::vector<int> y;
+  Data() {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+    for (int i = 0; i < X.get_rows(); ++i) {
+      for (int j = 0; j < X.get_cols(); ++j) X(i, j) = distr(gen);
+      y.push_back(i % 4);
+      X(i, i % 4) += 3.0f;
+    }
+  }
+};
+
+TrainerConfig small_config() {
+  TrainerConfig c;
+  c.layers = {12, 16, 4};
+  c.epochs = 5;
+  c.batch_size = 16;
+  c.learning_rate = 0.1f;
+  return c;
+}
+
+template <typename F>
+bool throws_invalid(F&& f) {
+  try {
+    f();
+  } catch (const std::invalid_argument&) {
+    return true;
+  }
+  return false;
+}
+
+int main() {
+  bool all_tests_passed = true;
+  auto run_test = [&](const std::string& name, bool result) {
+    print_test_result(name, result);
+    if (!result) all_tests_passed = false;
+  };
+
+  std::cout << "--- Running trainer Test Suite ---\n";
+
+  std::cout << "\n--- Section 1: configuration ---\n";
+  {
+    TrainerConfig c;
+    c.set("layers", "784-256-64-10");
+    c.set("batch-size", "128");
+    c.set("optimizer", "adamw");
+    c.set("lr", "0.002");
+    c.set("activation", "relu");
+    c.set("mode", "hogwild");
+    run_test("layers parsed",
+             c.layers == std::vector<int>({784, 256, 64, 10}));
+    run_test("dashes map to underscores", c.batch_size == 128);
+    run_test("scalar options parsed",
+             c.optimizer == "adamw" && std::abs(c.learning_rate - 0.002f) < 1e-9f &&
+                 c.activation == Activation::Relu && c.hogwild);
+
+    const std::string path = "test_trainer.conf";
+    {
+      std::ofstream out(path);
+      out << "# 注释行\n"
+          << "epochs = 3\n"
+          << "  threads=2   # 行尾注释\n"
+          << "\n"
+          << "layers = 10,5,2\n";
+    }
+    TrainerConfig f;
+    f.load_file(path);
+    run_test("config file parsed",
+             f.epochs == 3 && f.threads == 2 &&
+                 f.layers == std::vector<int>({10, 5, 2}));
+    {
+      std::ofstream out(path);
+      out << "epochs 3\n";
+    }
+    run_test("malformed line rejected", throws_invalid([&] {
+               TrainerConfig g;
+               g.load_file(path);
+             }));
+    std::remove(path.c_str());
+
+    run_test("unknown key rejected",
+             throws_invalid([&] { c.set("epoch", "3"); }));
+    run_test("bad number rejected",
+             throws_invalid([&] { c.set("epochs", "3x"); }));
+    run_test("bad enum rejected",
+             throws_invalid([&] { c.set("precision", "fp16"); }));
+    run_test("hogwild with adam rejected", throws_invalid([&] { c.validate(); }));
+    TrainerConfig ok;
+    run_test("defaults valid", !throws_invalid([&] { ok.validate(); }));
+  }
+
+  const Data data;
+  // 评估直接使用训练数据
+  const Features X_test = data.X;
+
+  std::cout << "\n--- Section 2: training ---\n";
+  for (const char* optimizer : {"sgd", "adam", "adamw"}) {
+    TrainerConfig c = small_config();
+    c.optimizer = optimizer;
+    if (c.optimizer != "sgd") c.learning_rate = 0.01f;
+    c.eval_interval = 5;
+    Trainer trainer(c);
+    int callbacks = 0;
+    auto history = trainer.fit(data.X, data.y, &X_test, data.y,
+                               [&](const EpochStats&) { callbacks++; });
+    run_test(std::string(optimizer) + ": loss decreases",
+             history.size() == 5 && history.back().loss < 0.5 * history.front().loss);
+    run_test(std::string(optimizer) + ": callback per epoch", callbacks == 5);
+    run_test(std::string(optimizer) + ": evaluated at the interval",
+             history[3].accuracy < 0.0 && history[4].accuracy > 90.0);
+  }
+  {
+    // 后台评估：结果与同步评估相同，各轮按顺序交付
+    TrainerConfig c = small_config();
+    c.eval_interval = 2;
+    Trainer sync_trainer(c);
+    const auto expected = sync_trainer.fit(data.X, data.y, &X_test, data.y);
+    c.eval_async = true;
+    Trainer async_trainer(c);
+    std::vector<int> epochs;
+    const auto history = async_trainer.fit(
+        data.X, data.y, &X_test, data.y,
+        [&](const EpochStats& s) { epochs.push_back(s.epoch); });
+    bool same = history.size() == expected.size();
+    for (size_t i = 0; same && i < history.size(); ++i) {
+      same = history[i].accuracy == expected[i].accuracy &&
+             history[i].loss == expected[i].loss;
+    }
+    run_test("async evaluation matches sync", same);
+    run_test("async evaluation delivers epochs in order",
+             epochs == std::vector<int>{0, 1, 2, 3, 4});
+  }
+  {
+    TrainerConfig c = small_config();
+    Trainer trainer(c);
+    auto history = trainer.fit(data.X, data.y);
+    const EpochStats& s = history.front();
+    run_test("steps per epoch", s.steps == 15);
+    run_test("timing breakdown adds up",
+             s.ms_per_step > 0.0 && s.data_ms_per_step > 0.0 &&
+                 std::abs(s.data_ms_per_step + s.compute_ms_per_step -
+                          s.ms_per_step) < 1e-6);
+    run_test("throughput consistent with time",
+             std::abs(s.samples_per_second * s.seconds - 240.0) < 1e-6);
+    run_test("parameters named W1, b1, W2, b2",
+             trainer.params().size() == 4 && trainer.params()[0]->name == "W1" &&
+                 trainer.params()[3]->name == "b2");
+
+    // 线程数不改变同步训练的结果
+    TrainerConfig c2 = small_config();
+    c2.threads = 3;
+    Trainer threaded(c2);
+    auto history2 = threaded.fit(data.X, data.y);
+    run_test("threads give the same loss",
+             std::abs(history2.back().loss - history.back().loss) < 1e-5);
+
+    TrainerConfig c3 = small_config();
+    c3.hogwild = true;
+    c3.threads = 2;
+    Trainer hogwild(c3);
+    auto history3 = hogwild.fit(data.X, data.y);
+    run_test("hogwild trains",
+             history3.back().loss < 0.5 * history3.front().loss &&
+                 hogwild.evaluate(data.X, data.y).accuracy() > 90.0);
+  }
+  {
+    // 分段训练与一次训练完逐位一致
+    Trainer whole(small_config());
+    const auto expected = whole.fit(data.X, data.y);
+    Trainer staged(small_config());
+    auto first = staged.fit_until(2, data.X, data.y);
+    auto rest = staged.fit(data.X, data.y);
+    run_test("fit_until stops at the requested epoch",
+             first.size() == 2 && rest.size() == 3 && rest.front().epoch == 2);
+    run_test("staged training matches one fit",
+             rest.back().loss == expected.back().loss &&
+                 staged.evaluate(data.X, data.y).confusion ==
+                     whole.evaluate(data.X, data.y).confusion);
+  }
+
+  std::cout << "\n--- Section 3: errors ---\n";
+  {
+    Trainer trainer(small_config());
+    Matrix wrong(10, 7);
+    std::vector<int> labels(10, 0);
+    run_test("feature count mismatch rejected",
+             throws_invalid([&] { trainer.fit(wrong, labels); }));
+    run_test("label count mismatch rejected", throws_invalid([&] {
+               trainer.fit(data.X, std::vector<int>(3, 0));
+             }));
+  }
+
+  std::cout << "\n--- Test Suite Finished ---\n";
+  if (all_tests_passed) {
+    std::cout << "\x1B[32mAll tests passed successfully!\x1B[0m\n";
+    return 0;
+  }
+  std::cerr << "\x1B[31mSome tests failed. Please review the output "
+               "above.\x1B[0m\n";
+  return 1;
+}
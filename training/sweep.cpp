@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/core/DataFiles.h"
+#include "../src/core/Matrix.h"
+#include "../src/core/Sweep.h"
+#include "../src/core/Trainer.h"
+
+struct GridAxis {
+  std::string key;
+  std::vector<std::string> values;
+};
+
+// "lr=0.01,0.05,0.1"
+GridAxis parse_axis(const std::string& spec) {
+  const auto eq = spec.find('=');
+  if (eq == std::string::npos || eq == 0 || eq + 1 == spec.size()) {
+    throw std::invalid_argument("--grid expects key=v1,v2,..., got '" + spec + "'.");
+  }
+  GridAxis axis{spec.substr(0, eq), {}};
+  std::istringstream in(spec.substr(eq + 1));
+  std::string value;
+  while (std::getline(in, value, ',')) axis.values.push_back(value);
+  return axis;
+}
+
+int main(int argc, char** argv) {
+  // 在同一份数据上搜索超参数：
+  //   sweep --grid lr=0.01,0.05,0.1 --grid layers=784-64-10,784-128-10
+  //         --budget 4 --min-epochs 1 --eta 3 [--config FILE] [--key value ...]
+  // 每个 --grid 是一个维度，试验是各维度取值的笛卡尔积；其余 --key value
+  // 与 train 相同，作为所有试验的基础配置，epochs 为幸存试验的最终轮数。
+  // --budget：同时运行的各试验 threads 之和的上限
+  // --min-epochs / --eta：successive halving 的第一档轮数与淘汰比例（--eta 1 不淘汰）
+  // --val-fraction：从训练数据末尾留出的验证集比例（默认 0.1），排名与淘汰
+  //                 只看验证集，test_path 不参与超参数选择
+  TrainerConfig base;
+  SweepOptions options;
+  std::vector<GridAxis> grid;
+  double val_fraction = 0.1;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      if (std::string(argv[i]) == "--config" && i + 1 < argc) base.load_file(argv[++i]);
+    }
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if (arg.rfind("--", 0) != 0 || i + 1 >= argc) {
+        throw std::invalid_argument("unexpected argument '" + arg + "'.");
+      } else if (arg == "--config") {
+        ++i;
+      } else if (arg == "--grid") {
+        grid.push_back(parse_axis(argv[++i]));
+      } else if (arg == "--budget") {
+        options.thread_budget = std::stoi(argv[++i]);
+      } else if (arg == "--min-epochs") {
+        options.min_epochs = std::stoi(argv[++i]);
+      } else if (arg == "--eta") {
+        options.eta = std::stoi(argv[++i]);
+      } else if (arg == "--val-fraction") {
+        val_fraction = std::stod(argv[++i]);
+      } else {
+        base.set(arg.substr(2), argv[++i]);
+      }
+    }
+    options.max_epochs = base.epochs;
+    options.min_epochs = std::min(options.min_epochs, options.max_epochs);
+
+    // 数据只加载一次，所有试验共享；验证集是训练数据末尾的行视图
+    std::cout << "Loading data..." << std::endl;
+    const LoadedData data = load_data(base.train_path, "Training data", true);
+    const auto [fit, val] = split_holdout(data, val_fraction);
+    std::cout << "Training on " << fit.y.size() << " samples, validating on "
+              << val.y.size() << " held-out samples." << std::endl;
+
+    SweepRunner runner(fit.X, fit.y, val.X, val.y, options);
+    // 笛卡尔积，最后一个维度变化最快
+    std::vector<std::string> labels;
+    std::vector<size_t> index(grid.size(), 0);
+    while (true) {
+      TrainerConfig config = base;
+      std::string label;
+      for (size_t a = 0; a < grid.size(); ++a) {
+        config.set(grid[a].key, grid[a].values[index[a]]);
+        label += (a ? " " : "") + grid[a].key + "=" + grid[a].values[index[a]];
+      }
+      runner.add(std::move(config));
+      labels.push_back(label.empty() ? "base" : label);
+      size_t a = grid.size();
+      while (a > 0 && ++index[a - 1] == grid[a - 1].values.size()) index[--a] = 0;
+      if (a == 0) break;
+    }
+
+    std::cout << "Sweeping " << labels.size() << " configurations, rungs at epoch";
+    for (int e : SweepRunner::rungs(options)) std::cout << " " << e;
+    std::cout << ", thread budget " << options.thread_budget << "..." << std::endl;
+
+    const auto results = runner.run([&](const TrialResult& r) {
+      std::cout << "trial " << r.id << " [" << labels[r.id] << "] ";
+      if (!r.error.empty()) {
+        std::cout << "failed: " << r.error << std::endl;
+        return;
+      }
+      std::cout << "epoch " << r.epochs << ": loss " << r.loss
+                << ", validation accuracy " << r.accuracy << "% (" << r.seconds
+                << " s)" << std::endl;
+    });
+
+    std::cout << "\n--- Sweep Results ---" << std::endl;
+    for (const TrialResult& r : results) {
+      std::cout << "trial " << r.id << " [" << labels[r.id] << "]: ";
+      if (!r.error.empty()) {
+        std::cout << "failed" << std::endl;
+        continue;
+      }
+      std::cout << r.accuracy << "% validation accuracy after " << r.epochs << " epoch(s)"
+                << (r.stopped ? ", stopped early" : "") << std::endl;
+    }
+    if (results.front().error.empty()) {
+      std::cout << "\nBest: trial " << results.front().id << " ("
+                << results.front().config.summary() << ")" << std::endl;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "An error occurred: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
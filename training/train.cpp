@@ -1,167 +1,207 @@
-#include <algorithm>  
-#include <cmath>
 #include <iostream>
 #include <memory>
-#include <numeric>  
-#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
-#include "../src/core/CsvDataSet.h"
-#include "../src/core/Graph.h"
-#include "../src/core/Matrix.h"
-#include "../src/ops/noise.h"  
-#include "../src/ops/ops.h"
-
-
-Matrix random_matrix(int rows, int cols) {
-  Matrix m(rows, cols);
-  std::mt19937 gen(49);  
-  std::uniform_real_distribution<> distr(-0.5, 0.5);
-  for (int i = 0; i < rows; ++i) {
-    for (int j = 0; j < cols; ++j) {
-      m(i, j) = static_cast<float>(distr(gen));
+#include "../src/core/DataFiles.h"
+#include "../src/core/Features.h"
+#include "../src/core/ProcessGroup.h"
+#include "../src/core/Profiler.h"
+#include "../src/core/Trainer.h"
+
+struct RunResult {
+  std::unique_ptr<Trainer> trainer;
+  double accuracy = 0.0;
+  double seconds = 0.0;
+  double samples_per_second = 0.0;
+};
+
+// 按 config 从头训练一次并在测试集上评估（仅 0 号进程）；
+// 初始化与打乱顺序由种子决定，不同精度 / 并行方式的运行因此可以直接比较。
+// resume 为 true 时从 config.checkpoint_path 继续。
+RunResult train_and_evaluate(const TrainerConfig& config, ProcessGroup* group,
+                             const Features& X_train, std::span<const int> y_train,
+                             const Features& X_test, std::span<const int> y_test,
+                             bool resume = false) {
+  RunResult result;
+  result.trainer = std::make_unique<Trainer>(config, group);
+  Trainer& trainer = *result.trainer;
+  const bool verbose = trainer.rank() == 0;
+  if (resume) {
+    trainer.resume(config.checkpoint_path);
+    if (verbose) {
+      std::cout << "Resuming from " << config.checkpoint_path << std::endl;
     }
   }
-  return m;
-}
-
-
-int get_predicted_class(const Matrix& prediction_row) {
-  int max_idx = 0;
-  for (int i = 1; i < prediction_row.get_cols(); ++i) {
-    if (prediction_row(0, i) > prediction_row(0, max_idx)) {
-      max_idx = i;
+  if (verbose) {
+    std::cout << "Training started (" << config.summary();
+    if (trainer.world_size() > 1) {
+      std::cout << ", " << trainer.world_size() << " processes";
     }
+    std::cout << ")..." << std::endl;
   }
-  return max_idx;
-}
-
 
-Matrix create_batch(const Matrix& source, const std::vector<int>& indices) {
-  Matrix batch(indices.size(), source.get_cols());
-  for (size_t i = 0; i < indices.size(); ++i) {
-    for (int j = 0; j < source.get_cols(); ++j) {
-      batch(i, j) = source(indices[i], j);
-    }
+  auto history = trainer.fit(
+      X_train, y_train, &X_test, y_test, [&](const EpochStats& s) {
+        if (!verbose) return;
+        std::cout << "Epoch " << s.epoch << ", Average Loss: " << s.loss << ", "
+                  << static_cast<int>(s.samples_per_second) << " samples/s, "
+                  << s.ms_per_step << " ms/step (data " << s.data_ms_per_step
+                  << " ms, compute " << s.compute_ms_per_step << " ms)";
+        if (s.accuracy >= 0.0) std::cout << ", test accuracy " << s.accuracy << "%";
+        std::cout << std::endl;
+      });
+  // 恢复时第一轮可能只剩部分批次，也可能已没有剩余的轮次，按实际训练的样本数计
+  double samples = 0.0;
+  for (const EpochStats& s : history) {
+    result.seconds += s.seconds;
+    samples += s.samples;
   }
-  return batch;
+  result.samples_per_second = result.seconds > 0.0 ? samples / result.seconds : 0.0;
+  // 各进程的参数逐位相同，评估只需在 0 号进程上做一次
+  if (!verbose) return result;
+  std::cout << "Training finished in " << result.seconds << " s." << std::endl;
+
+  std::cout << "\n--- Evaluating on Test Set ---" << std::endl;
+  const EvalResult eval = trainer.evaluate(X_test, y_test);
+  result.accuracy = eval.accuracy();
+  eval.print_report(std::cout);
+  std::cout << "\nFinal Test Accuracy: " << result.accuracy << "%" << std::endl;
+  return result;
 }
 
-int main() {
-  try {
-    
-    std::cout << "Loading data..." << std::endl;
-    CsvDataSet train_dataset("../data/mnist_train.csv");
-    CsvDataSet test_dataset("../data/mnist_test.csv");
-
-    Matrix X_train_full = train_dataset.get_features();
-    Matrix Y_train_full = one_hot_encode(train_dataset.get_labels());
-    Matrix X_test_full = test_dataset.get_features();
-
-    std::cout << "Training data loaded: " << train_dataset.size() << " samples."
-              << std::endl;
-    std::cout << "Test data loaded: " << test_dataset.size() << " samples."
-              << std::endl;
-
-    
-    Graph g;
-    float learning_rate = 0.05f;
-    int epochs = 10;
-    int batch_size = 64;
-    int input_size = 784;
-    int hidden_size = 128;
-    int output_size = 10;
-
-    
-    auto W1 = g.make_node(random_matrix(input_size, hidden_size), "W1");
-    auto b1 = g.make_node(Matrix(1, hidden_size, 0.01f), "b1");
-    auto W2 = g.make_node(random_matrix(hidden_size, output_size), "W2");
-    auto b2 = g.make_node(Matrix(1, output_size, 0.0f), "b2");
-
-    
-    std::cout << "Training started..." << std::endl;
-    int num_samples = train_dataset.size();
-    std::vector<int> indices(num_samples);
-    std::iota(indices.begin(), indices.end(), 0);
-    std::mt19937 rng(59);
-
-    for (int i = 0; i < epochs; ++i) {
-      std::shuffle(indices.begin(), indices.end(), rng);
-
-      double epoch_loss = 0.0;
-      int num_batches = 0;
-
-      for (int start_idx = 0; start_idx < num_samples;
-           start_idx += batch_size) {
-        int end_idx = std::min(start_idx + batch_size, num_samples);
-        std::vector<int> batch_indices(indices.begin() + start_idx,
-                                       indices.begin() + end_idx);
+int main(int argc, char** argv) {
+  // 训练配置：--config FILE 读取 "key = value" 配置文件，其余 --key value
+  // 覆盖其中的选项，如 --layers 784-256-10 --batch-size 128 --threads 4
+  // --optimizer adam --lr 1e-3 --eval-interval 2（完整列表见 Trainer.h）。
+  // --checkpoint-path FILE [--checkpoint-every N] 在后台周期性地写检查点。
+  // 此外：
+  // --resume：从 checkpoint_path 中的检查点继续训练
+  // --profile：记录每个算子的耗时/FLOP/访存，结束时打印汇总并导出 Chrome trace
+  // --bf16：先按配置训练作为基线，再以 bf16 混合精度训练，报告精度差异
+  // --hogwild：先以同步数据并行训练作为基线，再以 Hogwild 训练并对比
+  // --nproc N：在本机启动 N 个训练进程（其余参数原样传给每个进程），
+  //            每个全局批次按进程切分，梯度通过共享内存 / Unix 套接字 all-reduce
+  // --rank / --world-size / --job-id：由 --nproc 传给子进程；也可手动启动各进程
+  // --transport auto|shm|socket：进程间通信方式，默认优先共享内存
+  bool profile = false;
+  bool bf16_mode = false;
+  bool hogwild_mode = false;
+  bool resume = false;
+  ProcessGroupOptions group_options;
+  TrainerConfig config;
 
-        Matrix original_batch = create_batch(X_train_full, batch_indices);
-
-        
-        auto X_batch = g.make_node(original_batch, "X_batch");
-        auto Y_batch =
-            g.make_node(create_batch(Y_train_full, batch_indices), "Y_batch");
-
-        
-        W1->grad.clear_grad();
-        b1->grad.clear_grad();
-        W2->grad.clear_grad();
-        b2->grad.clear_grad();
-
-        
-        auto z1 = add_with_broadcast(g, mul(g, X_batch, W1), b1);
-        auto a1 = sigmoid(g, z1);
-        auto logits = add_with_broadcast(g, mul(g, a1, W2), b2);
-
-        
-        auto loss = softmax_cross_entropy_loss(g, logits, Y_batch);
-        epoch_loss += loss->value(0, 0);
-
-        
-        loss->backward();
-
-        
-        W1->value = W1->value - (W1->grad * learning_rate);
-        b1->value = b1->value - (b1->grad * learning_rate);
-        W2->value = W2->value - (W2->grad * learning_rate);
-        b2->value = b2->value - (b2->grad * learning_rate);
-
-        num_batches++;
+  try {
+    // 启动器原样转发除 --nproc 之外的参数
+    const LaunchArgs launch = parse_launch_args(argc, argv);
+    for (int i = 1; i < argc; ++i) {
+      if (std::string(argv[i]) == "--config" && i + 1 < argc) {
+        config.load_file(argv[++i]);
       }
-      std::cout << "Epoch " << i
-                << ", Average Loss: " << epoch_loss / num_batches << std::endl;
     }
-    std::cout << "Training finished!" << std::endl;
-
-    
-    std::cout << "\n--- Evaluating on Test Set ---" << std::endl;
-    auto X_test = g.make_node(test_dataset.get_features(), "X_test");
-    auto Y_test_labels = test_dataset.get_labels();
-
-    auto z1 = add_with_broadcast(g, mul(g, X_test, W1), b1);
-    auto a1 = sigmoid(g, z1);
-    auto final_logits = add_with_broadcast(g, mul(g, a1, W2), b2);
+    // 命令行在配置文件之后应用，因此优先
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if (arg == "--profile") {
+        profile = true;
+      } else if (arg == "--bf16") {
+        bf16_mode = true;
+      } else if (arg == "--hogwild") {
+        hogwild_mode = true;
+      } else if (arg == "--resume") {
+        resume = true;
+      } else if (arg.rfind("--", 0) != 0 || i + 1 >= argc) {
+        throw std::invalid_argument("unexpected argument '" + arg + "'.");
+      } else if (arg == "--nproc" || arg == "--config") {
+        ++i;
+      } else if (arg == "--rank") {
+        group_options.rank = std::stoi(argv[++i]);
+      } else if (arg == "--world-size") {
+        group_options.world_size = std::stoi(argv[++i]);
+      } else if (arg == "--job-id") {
+        group_options.job_id = argv[++i];
+      } else if (arg == "--transport") {
+        const std::string t = argv[++i];
+        group_options.transport = t == "shm"      ? Transport::SharedMemory
+                                  : t == "socket" ? Transport::Socket
+                                                  : Transport::Auto;
+      } else {
+        config.set(arg.substr(2), argv[++i]);
+      }
+    }
+    config.validate();
+    if (resume && config.checkpoint_path.empty()) {
+      throw std::invalid_argument("--resume requires --checkpoint-path.");
+    }
+    if (hogwild_mode && (group_options.world_size > 1 || launch.nproc > 1)) {
+      throw std::invalid_argument(
+          "--hogwild cannot be combined with multi-process training.");
+    }
+    if (launch.nproc > 1) {
+      return launch_local_ranks(launch.forwarded, launch.nproc);
+    }
 
-    int correct_predictions = 0;
-    for (int i = 0; i < test_dataset.size(); i++) {
-      Matrix single_prediction_logits = final_logits->value.get_row(i);
-      int predicted_class = get_predicted_class(single_prediction_logits);
-      int actual_class = static_cast<int>(Y_test_labels(i, 0));
-      if (predicted_class == actual_class) {
-        correct_predictions++;
+    // 所有进程都连上之后才开始加载数据与训练
+    auto group = ProcessGroup::create(group_options);
+    const bool is_rank0 = group->rank() == 0;
+    Profiler::instance().set_enabled(profile && is_rank0);
+
+    if (is_rank0) std::cout << "Loading data..." << std::endl;
+    const LoadedData train = load_data(config.train_path, "Training data", is_rank0);
+    const LoadedData test = load_data(config.test_path, "Test data", is_rank0);
+
+    auto run = [&](const TrainerConfig& c, bool resume_run) {
+      return train_and_evaluate(c, group.get(), train.X, train.y, test.X, test.y,
+                                resume_run);
+    };
+    RunResult result = run(config, resume);
+    // 对比运行不写检查点，以免覆盖基线的检查点
+    TrainerConfig compare_config = config;
+    compare_config.checkpoint_path.clear();
+    if (bf16_mode) {
+      // 多进程时 bf16 运行同样是集合操作，所有进程都要参与
+      TrainerConfig bf16_config = compare_config;
+      bf16_config.precision = Precision::BF16;
+      RunResult mixed = run(bf16_config, false);
+      if (is_rank0) {
+        std::cout << "\n--- " << (config.precision == Precision::BF16 ? "bf16" : "fp32")
+                  << " vs bf16 ---" << std::endl;
+        std::cout << "baseline accuracy: " << result.accuracy << "%, "
+                  << result.seconds << " s" << std::endl;
+        std::cout << "bf16 accuracy: " << mixed.accuracy << "%, "
+                  << mixed.seconds << " s" << std::endl;
+        std::cout << "Accuracy delta (bf16 - baseline): "
+                  << mixed.accuracy - result.accuracy << " pp" << std::endl;
       }
     }
+    if (hogwild_mode) {
+      TrainerConfig hogwild_config = compare_config;
+      hogwild_config.hogwild = true;
+      RunResult async = run(hogwild_config, false);
+      std::cout << "\n--- synchronous vs hogwild (" << config.threads
+                << " thread(s)) ---" << std::endl;
+      std::cout << "sync:    " << result.accuracy << "%, "
+                << static_cast<int>(result.samples_per_second) << " samples/s"
+                << std::endl;
+      std::cout << "hogwild: " << async.accuracy << "%, "
+                << static_cast<int>(async.samples_per_second) << " samples/s"
+                << std::endl;
+    }
 
-    double accuracy =
-        static_cast<double>(correct_predictions) / test_dataset.size() * 100.0;
-    std::cout << "\nFinal Test Accuracy: " << accuracy << "%" << std::endl;
+    if (!is_rank0) return 0;
+    if (profile) {
+      Profiler::instance().set_enabled(false);
+      std::cout << "\n--- Profile ---" << std::endl;
+      Profiler::instance().print_summary(std::cout);
+      Profiler::instance().export_chrome_trace("train_trace.json");
+      std::cout << "Chrome trace written to train_trace.json" << std::endl;
+    }
 
-    
-    std::string save_path = "../models/MNIST_1_sigmoid.model";
-    save_parameters(save_path, {W1, b1, W2, b2});
-    std::cout << "Model saved to " << save_path << std::endl;
+    // 保存的始终是按配置训练的基线模型
+    result.trainer->save(config.save_path);
+    std::cout << "Model saved to " << config.save_path << std::endl;
 
   } catch (const std::exception& e) {
     std::cerr << "An error occurred: " << e.what() << std::endl;